@@ -0,0 +1,50 @@
+#include <odr/internal/cfb/cfb_util.hpp>
+#include <odr/internal/common/file.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace odr::internal;
+
+// Times reading every stream of a compound file through
+// `cfb::util::Archive`, the way the legacy and encrypted OOXML readers
+// consume them. Meant to be run on files with large streams like
+// `WordDocument` or `EncryptedPackage`.
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " input [iterations]" << std::endl;
+    return 1;
+  }
+
+  std::string input{argv[1]};
+  int iterations = argc >= 3 ? std::stoi(argv[2]) : 5;
+
+  auto file =
+      std::make_shared<common::MemoryFile>(common::DiskFile(input));
+  auto archive = std::make_shared<cfb::util::Archive>(file);
+
+  double total = 0;
+  std::uint64_t bytes = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto &entry : *archive) {
+      if (!entry.is_file()) {
+        continue;
+      }
+      auto in = entry.file()->stream();
+      char buffer[4096];
+      while (in->read(buffer, sizeof(buffer)) || in->gcount() > 0) {
+        bytes += in->gcount();
+      }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    total += std::chrono::duration<double>(end - begin).count();
+  }
+  std::cout << bytes / total / 1e6 << " MB/s" << std::endl;
+
+  return 0;
+}
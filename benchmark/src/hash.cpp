@@ -0,0 +1,77 @@
+#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/util/stream_util.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace odr::internal;
+
+// Times the hashes and PBKDF2 of `crypto::util` with every backend built in
+// on whole files, e.g. the parts of encrypted documents.
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " input... [iterations]"
+              << std::endl;
+    return 1;
+  }
+
+  int iterations = 5;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    std::string argument{argv[i]};
+    if (i == argc - 1 && argc > 2 &&
+        argument.find_first_not_of("0123456789") == std::string::npos) {
+      iterations = std::stoi(argument);
+      continue;
+    }
+    std::ifstream in(argument, std::ios::binary);
+    if (!in.is_open()) {
+      std::cerr << "cannot read " << argument << std::endl;
+      return 1;
+    }
+    inputs.push_back(util::stream::read(in));
+  }
+
+  const std::pair<crypto::util::HashBackend, const char *> backends[] = {
+      {crypto::util::HashBackend::cryptopp, "cryptopp"},
+      {crypto::util::HashBackend::openssl, "openssl"},
+  };
+
+  for (auto [backend, name] : backends) {
+    if (!crypto::util::available(backend)) {
+      continue;
+    }
+
+    std::uint64_t bytes = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      for (const std::string &input : inputs) {
+        crypto::util::sha1(input, backend);
+        crypto::util::sha256(input, backend);
+        bytes += input.size();
+      }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double hash_time = std::chrono::duration<double>(end - begin).count();
+
+    // the key derivation of encrypted ODF documents
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      crypto::util::pbkdf2(32, "password", "0123456789abcdef", 100000,
+                           backend);
+    }
+    end = std::chrono::steady_clock::now();
+    double pbkdf2_time = std::chrono::duration<double>(end - begin).count();
+
+    std::cout << name << ": sha1+sha256 " << bytes / hash_time / 1e6
+              << " MB/s, pbkdf2 " << pbkdf2_time / iterations * 1e3 << " ms"
+              << std::endl;
+  }
+
+  return 0;
+}
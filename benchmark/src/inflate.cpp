@@ -0,0 +1,110 @@
+#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/util/stream_util.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <miniz/miniz.h>
+
+using namespace odr::internal;
+
+namespace {
+
+struct Stream {
+  std::string compressed;
+  std::uint64_t size{0};
+};
+
+/// Collects the raw deflate data of every entry in the ZIP archive `path`.
+bool read_streams(const std::string &path, std::vector<Stream> &streams) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return false;
+  }
+  std::string data = util::stream::read(in);
+
+  mz_zip_archive zip{};
+  if (!mz_zip_reader_init_mem(&zip, data.data(), data.size(), 0)) {
+    return false;
+  }
+  for (mz_uint i = 0; i < mz_zip_reader_get_num_files(&zip); ++i) {
+    mz_zip_archive_file_stat stat{};
+    if (!mz_zip_reader_file_stat(&zip, i, &stat) ||
+        stat.m_method != MZ_DEFLATED) {
+      continue;
+    }
+    Stream stream;
+    stream.compressed.resize(stat.m_comp_size);
+    stream.size = stat.m_uncomp_size;
+    if (mz_zip_reader_extract_to_mem(&zip, i, stream.compressed.data(),
+                                     stream.compressed.size(),
+                                     MZ_ZIP_FLAG_COMPRESSED_DATA)) {
+      streams.push_back(std::move(stream));
+    }
+  }
+  mz_zip_reader_end(&zip);
+  return true;
+}
+
+} // namespace
+
+// Times `crypto::util::inflate` with every backend built in on the deflated
+// entries of ZIP based documents like ODF and OOXML files.
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " input... [iterations]"
+              << std::endl;
+    return 1;
+  }
+
+  int iterations = 5;
+  std::vector<Stream> streams;
+  for (int i = 1; i < argc; ++i) {
+    std::string argument{argv[i]};
+    if (i == argc - 1 && argc > 2 &&
+        argument.find_first_not_of("0123456789") == std::string::npos) {
+      iterations = std::stoi(argument);
+    } else if (!read_streams(argument, streams)) {
+      std::cerr << "cannot read " << argument << std::endl;
+      return 1;
+    }
+  }
+
+  const std::pair<crypto::util::InflateBackend, const char *> backends[] = {
+      {crypto::util::InflateBackend::cryptopp, "cryptopp"},
+      {crypto::util::InflateBackend::miniz, "miniz"},
+      {crypto::util::InflateBackend::zlib_ng, "zlib-ng"},
+  };
+
+  std::string output;
+  for (auto [backend, name] : backends) {
+    if (!crypto::util::available(backend)) {
+      continue;
+    }
+
+    double total = 0;
+    std::uint64_t bytes = 0;
+    for (int i = 0; i < iterations; ++i) {
+      for (const Stream &stream : streams) {
+        auto begin = std::chrono::steady_clock::now();
+        output.clear();
+        crypto::util::inflate(stream.compressed, output, backend);
+        auto end = std::chrono::steady_clock::now();
+
+        if (output.size() != stream.size) {
+          std::cerr << name << ": size mismatch" << std::endl;
+          return 1;
+        }
+        total += std::chrono::duration<double>(end - begin).count();
+        bytes += output.size();
+      }
+    }
+    std::cout << name << ": " << bytes / total / 1e6 << " MB/s" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include <odr/internal/pdf/pdf_graphics_operator.hpp>
+#include <odr/internal/pdf/pdf_graphics_operator_parser.hpp>
+#include <odr/internal/pdf/pdf_graphics_state.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+using namespace odr::internal;
+
+// Times parsing and executing a vector heavy content stream operator by
+// operator, the way the PDF translator consumes it.
+int main(int argc, char **argv) {
+  int repetitions = argc >= 2 ? std::stoi(argv[1]) : 100000;
+  int iterations = argc >= 3 ? std::stoi(argv[2]) : 5;
+
+  const std::string chunk = "q\n"
+                            "1 0 0 1 72.5 720 cm\n"
+                            "0.2 0.4 0.6 rg\n"
+                            "0.5 w\n"
+                            "10 10 m\n"
+                            "20 20 l\n"
+                            "30 30 40 40 50 50 c\n"
+                            "0 0 100 100 re\n"
+                            "B\n"
+                            "BT\n"
+                            "/F1 12 Tf\n"
+                            "100 200 Td\n"
+                            "(Hello) Tj\n"
+                            "ET\n"
+                            "Q\n";
+  std::string stream;
+  stream.reserve(chunk.size() * repetitions);
+  for (int i = 0; i < repetitions; ++i) {
+    stream += chunk;
+  }
+
+  double total = 0;
+  std::uint64_t operators = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto begin = std::chrono::steady_clock::now();
+    pdf::GraphicsOperatorParser parser(stream);
+    pdf::GraphicsState state;
+    pdf::GraphicsOperator op;
+    while (!parser.at_end()) {
+      parser.read_operator(op);
+      state.execute(op);
+      ++operators;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    total += std::chrono::duration<double>(end - begin).count();
+  }
+  std::cout << operators / total << " operators/s" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,43 @@
+#include <odr/internal/pdf/pdf_document.hpp>
+#include <odr/internal/pdf/pdf_document_element.hpp>
+#include <odr/internal/pdf/pdf_document_parser.hpp>
+#include <odr/internal/util/stream_util.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace odr::internal;
+
+// Times `pdf::DocumentParser::parse_document` which is dominated by object
+// parsing and dictionary lookups. Meant to be run on large PDFs.
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " input [iterations]" << std::endl;
+    return 1;
+  }
+
+  std::string input{argv[1]};
+  int iterations = argc >= 3 ? std::stoi(argv[2]) : 5;
+
+  double total = 0;
+  for (int i = 0; i < iterations; ++i) {
+    std::ifstream in(input, std::ios::binary);
+    if (!in.is_open()) {
+      std::cerr << "cannot open " << input << std::endl;
+      return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    std::string data = util::stream::read(in);
+    pdf::DocumentParser parser(data);
+    auto document = parser.parse_document();
+    auto end = std::chrono::steady_clock::now();
+
+    total += std::chrono::duration<double, std::milli>(end - begin).count();
+  }
+  std::cout << total / iterations << " ms/parse" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include <odr/internal/common/file.hpp>
+#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/svm/svm_file.hpp>
+#include <odr/internal/svm/svm_to_svg.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+using namespace odr::internal;
+
+namespace {
+
+/// Counts and drops everything written to it.
+class CountingBuffer final : public std::streambuf {
+public:
+  std::uint64_t count{0};
+
+protected:
+  int_type overflow(int_type c) final {
+    ++count;
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char *, std::streamsize n) final {
+    count += n;
+    return n;
+  }
+};
+
+} // namespace
+
+// Times `svm::Translator::svg` streaming through a base64 encoder, the way
+// metafiles embedded in presentations end up in the HTML output. Meant to be
+// run on large metafiles.
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " input [iterations]" << std::endl;
+    return 1;
+  }
+
+  std::string input{argv[1]};
+  int iterations = argc >= 3 ? std::stoi(argv[2]) : 5;
+
+  svm::SvmFile svm_file(std::make_shared<common::DiskFile>(input));
+
+  double total = 0;
+  std::uint64_t bytes = 0;
+  for (int i = 0; i < iterations; ++i) {
+    CountingBuffer counter;
+    std::ostream out(&counter);
+
+    auto begin = std::chrono::steady_clock::now();
+    crypto::util::Base64Encoder encoder(out);
+    std::ostream svg_out(&encoder);
+    svm::Translator::svg(svm_file, svg_out);
+    encoder.finish();
+    auto end = std::chrono::steady_clock::now();
+
+    total += std::chrono::duration<double, std::milli>(end - begin).count();
+    bytes += counter.count;
+  }
+  std::cout << total / iterations << " ms/translation, "
+            << bytes / iterations << " bytes of base64" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include <odr/file.hpp>
+#include <odr/html.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace odr;
+
+namespace {
+
+double translate_ms(const DecodedFile &file, const std::string &output,
+                    bool editable) {
+  HtmlConfig config;
+  config.editable = editable;
+
+  auto begin = std::chrono::steady_clock::now();
+  html::translate(file, output, config);
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+} // namespace
+
+// Compares the translation time of a document with and without
+// `HtmlConfig::editable`. Meant to be run on large text documents (e.g. 500
+// pages) where every text node carries a `data-odr-path`.
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " input output [iterations]"
+              << std::endl;
+    return 1;
+  }
+
+  std::string input{argv[1]};
+  std::string output{argv[2]};
+  int iterations = argc >= 4 ? std::stoi(argv[3]) : 5;
+
+  DecodedFile decoded_file{input};
+
+  double average[2]{};
+  for (bool editable : {false, true}) {
+    double total = 0;
+    for (int i = 0; i < iterations; ++i) {
+      total += translate_ms(decoded_file, output, editable);
+    }
+    average[editable] = total / iterations;
+    std::cout << "editable=" << editable << " " << average[editable]
+              << " ms/translation" << std::endl;
+  }
+  std::cout << "editable overhead "
+            << (average[true] / average[false] - 1) * 100 << " %"
+            << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,25 @@
+#include <odr/file.hpp>
+
+#include <iostream>
+#include <string>
+
+using namespace odr;
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: pdf_text input" << std::endl;
+    return 2;
+  }
+
+  std::string input{argv[1]};
+
+  DecodedFile decoded_file{input};
+  if (!decoded_file.is_pdf_file()) {
+    std::cerr << "not a pdf file" << std::endl;
+    return 1;
+  }
+
+  decoded_file.pdf_file().extract_text(std::cout);
+
+  return 0;
+}
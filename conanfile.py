@@ -19,10 +19,14 @@ class OpenDocumentCoreConan(ConanFile):
     options = {
         "shared": [True, False],
         "fPIC": [True, False],
+        "with_zlib_ng": [True, False],
+        "with_openssl": [True, False],
     }
     default_options = {
         "shared": False,
         "fPIC": True,
+        "with_zlib_ng": False,
+        "with_openssl": False,
     }
 
     def requirements(self):
@@ -33,6 +37,10 @@ class OpenDocumentCoreConan(ConanFile):
         self.requires("vincentlaucsb-csv-parser/2.3.0")
         self.requires("uchardet/0.0.8")
         self.requires("utfcpp/4.0.4")
+        if self.options.with_zlib_ng:
+            self.requires("zlib-ng/2.1.6")
+        if self.options.with_openssl:
+            self.requires("openssl/3.2.2")
 
     def build_requirements(self):
         self.test_requires("gtest/1.14.0")
@@ -55,6 +63,8 @@ class OpenDocumentCoreConan(ConanFile):
         tc = CMakeToolchain(self)
         tc.variables["CMAKE_PROJECT_VERSION"] = self.version
         tc.variables["ODR_TEST"] = False
+        tc.variables["ODR_ZLIB_NG"] = bool(self.options.with_zlib_ng)
+        tc.variables["ODR_OPENSSL"] = bool(self.options.with_openssl)
         tc.generate()
 
         deps = CMakeDeps(self)
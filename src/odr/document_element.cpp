@@ -200,6 +200,16 @@ SheetCell Sheet::cell(std::uint32_t column, std::uint32_t row) const {
                    : SheetCell();
 }
 
+SheetCell Sheet::anchor_cell(std::uint32_t column, std::uint32_t row) const {
+  if (!exists_()) {
+    return {};
+  }
+  auto [anchor_column, anchor_row] =
+      m_element->anchor(m_document, column, row);
+  return {m_document, m_element, anchor_column, anchor_row,
+          m_element->cell(m_document, anchor_column, anchor_row)};
+}
+
 ElementRange Sheet::shapes() const {
   return exists_() ? ElementRange(ElementIterator(
                          m_document, m_element->first_shape(m_document)))
@@ -229,6 +239,10 @@ SheetCell::SheetCell(const internal::abstract::Document *document,
     : TypedElement(document, element), m_sheet{sheet}, m_column{column},
       m_row{row} {}
 
+std::uint32_t SheetCell::column() const { return m_column; }
+
+std::uint32_t SheetCell::row() const { return m_row; }
+
 bool SheetCell::is_covered() const {
   return exists_() ? m_element->is_covered(m_document) : false;
 }
@@ -284,6 +284,8 @@ public:
   [[nodiscard]] SheetColumn column(std::uint32_t column) const;
   [[nodiscard]] SheetRow row(std::uint32_t row) const;
   [[nodiscard]] SheetCell cell(std::uint32_t column, std::uint32_t row) const;
+  [[nodiscard]] SheetCell anchor_cell(std::uint32_t column,
+                                      std::uint32_t row) const;
 
   [[nodiscard]] ElementRange shapes() const;
 };
@@ -322,6 +324,9 @@ public:
             internal::abstract::Sheet *sheet, std::uint32_t column,
             std::uint32_t row, internal::abstract::SheetCell *element);
 
+  [[nodiscard]] std::uint32_t column() const;
+  [[nodiscard]] std::uint32_t row() const;
+
   [[nodiscard]] bool is_covered() const;
   [[nodiscard]] TableDimensions span() const;
   [[nodiscard]] ValueType value_type() const;
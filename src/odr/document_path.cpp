@@ -3,6 +3,8 @@
 #include <odr/document_element.hpp>
 
 #include <algorithm>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
 
 namespace odr {
@@ -30,6 +32,12 @@ bool DocumentPath::ComponentTemplate<Derived>::operator!=(
   return number != other.number;
 }
 
+template <typename Derived>
+bool DocumentPath::ComponentTemplate<Derived>::operator<(
+    const ComponentTemplate &other) const noexcept {
+  return number < other.number;
+}
+
 template <typename Derived>
 Derived &DocumentPath::ComponentTemplate<Derived>::operator++() {
   ++number;
@@ -69,6 +77,20 @@ DocumentPath::component_from_string(const std::string &string) {
   throw std::invalid_argument("string");
 }
 
+DocumentPath::Component
+DocumentPath::component_from_element(Element element,
+                                     const std::uint32_t number) {
+  switch (element.type()) {
+  case ElementType::table_column:
+  case ElementType::table_cell:
+    return Column(number);
+  case ElementType::table_row:
+    return Row(number);
+  default:
+    return Child(number);
+  }
+}
+
 DocumentPath DocumentPath::extract(Element element) {
   return extract(element, {});
 }
@@ -87,13 +109,7 @@ DocumentPath DocumentPath::extract(Element element, Element root) {
       ++distance;
     }
 
-    if (current.table_column() || current.table_cell()) {
-      reverse.emplace_back(Column(distance));
-    } else if (current.table_row()) {
-      reverse.emplace_back(Row(distance));
-    } else {
-      reverse.emplace_back(Child(distance));
-    }
+    reverse.push_back(component_from_element(current, distance));
 
     current = parent;
   }
@@ -102,8 +118,110 @@ DocumentPath DocumentPath::extract(Element element, Element root) {
   return DocumentPath(reverse);
 }
 
-Element DocumentPath::find(Element root, const DocumentPath & /*path*/) {
-  return root; // TODO
+Element DocumentPath::find(Element root, const DocumentPath &path) {
+  return find(root, std::vector<DocumentPath>{path}).front();
+}
+
+std::vector<Element> DocumentPath::find(Element root,
+                                        const std::vector<DocumentPath> &paths) {
+  // one resolved component of the current path with the lazily indexed
+  // children of its element
+  struct Level {
+    Element element;
+    std::optional<std::uint32_t> sheet_row;
+    std::optional<std::size_t> children_kind;
+    std::vector<Element> children;
+
+    explicit Level(Element element) : element{element} {}
+
+    const std::vector<Element> &index(const Component &component) {
+      if (children_kind == component.index()) {
+        return children;
+      }
+      children_kind = component.index();
+      children.clear();
+
+      ElementRange range = element.children();
+      if (element.type() == ElementType::table) {
+        if (std::holds_alternative<Row>(component)) {
+          range = element.table().rows();
+        } else if (std::holds_alternative<Column>(component)) {
+          range = element.table().columns();
+        }
+      } else if (element.type() == ElementType::sheet) {
+        range = element.sheet().shapes();
+      }
+      for (Element child : range) {
+        children.push_back(child);
+      }
+      return children;
+    }
+
+    Level resolve(const Component &component) {
+      const std::uint32_t number =
+          std::visit([](auto &&c) { return c.number; }, component);
+
+      // sheet cells are addressed by a row followed by a column
+      if (element.type() == ElementType::sheet) {
+        if (!sheet_row && std::holds_alternative<Row>(component)) {
+          Level result(element);
+          result.sheet_row = number;
+          return result;
+        }
+        if (sheet_row && std::holds_alternative<Column>(component)) {
+          return Level(element.sheet().cell(number, *sheet_row));
+        }
+        if (sheet_row || !std::holds_alternative<Child>(component)) {
+          return Level(Element());
+        }
+      }
+
+      const auto &children = index(component);
+      if (number >= children.size()) {
+        return Level(Element());
+      }
+      return Level(children[number]);
+    }
+  };
+
+  std::vector<std::size_t> order(paths.size());
+  std::iota(std::begin(order), std::end(order), 0);
+  std::sort(std::begin(order), std::end(order),
+            [&](std::size_t a, std::size_t b) { return paths[a] < paths[b]; });
+
+  std::vector<Element> result(paths.size());
+
+  // the sorted paths are resolved in one traversal, consecutive paths reuse
+  // the levels of their common prefix
+  std::vector<Level> stack{Level(root)};
+  const DocumentPath *previous = nullptr;
+  for (std::size_t i : order) {
+    const DocumentPath &path = paths[i];
+
+    std::size_t common = 0;
+    if (previous != nullptr) {
+      auto [path_it, previous_it] =
+          std::mismatch(std::begin(path.m_components),
+                        std::end(path.m_components),
+                        std::begin(previous->m_components),
+                        std::end(previous->m_components));
+      common = std::distance(std::begin(path.m_components), path_it);
+    }
+    stack.resize(std::min(stack.size(), common + 1), Level(Element()));
+
+    for (std::size_t depth = stack.size() - 1;
+         depth < path.m_components.size() && stack.back().element; ++depth) {
+      stack.push_back(stack.back().resolve(path.m_components[depth]));
+    }
+
+    if (stack.size() == path.m_components.size() + 1 &&
+        !stack.back().sheet_row) {
+      result[i] = stack.back().element;
+    }
+    previous = &path;
+  }
+
+  return result;
 }
 
 DocumentPath::DocumentPath() noexcept = default;
@@ -145,6 +263,10 @@ bool DocumentPath::operator!=(const DocumentPath &other) const noexcept {
   return m_components != other.m_components;
 }
 
+bool DocumentPath::operator<(const DocumentPath &other) const noexcept {
+  return m_components < other.m_components;
+}
+
 std::string DocumentPath::to_string() const noexcept {
   std::string result;
 
@@ -180,6 +302,17 @@ DocumentPath DocumentPath::join(const DocumentPath &other) const {
   return result;
 }
 
+void DocumentPath::push_back(const Component &component) {
+  m_components.push_back(component);
+}
+
+void DocumentPath::pop_back() {
+  if (empty()) {
+    throw std::invalid_argument("there is no component");
+  }
+  m_components.pop_back();
+}
+
 DocumentPath::const_iterator DocumentPath::begin() const {
   return std::begin(m_components);
 }
@@ -22,6 +22,7 @@ public:
 
     bool operator==(const ComponentTemplate &other) const noexcept;
     bool operator!=(const ComponentTemplate &other) const noexcept;
+    bool operator<(const ComponentTemplate &other) const noexcept;
 
     Derived &operator++();
     Derived &operator--();
@@ -49,9 +50,13 @@ public:
   using const_iterator = Container::const_iterator;
 
   static Component component_from_string(const std::string &string);
+  static Component component_from_element(Element element,
+                                          std::uint32_t number);
   static DocumentPath extract(Element element);
   static DocumentPath extract(Element element, Element root);
   static Element find(Element root, const DocumentPath &path);
+  static std::vector<Element> find(Element root,
+                                   const std::vector<DocumentPath> &paths);
 
   DocumentPath() noexcept;
   explicit DocumentPath(const Container &components);
@@ -61,6 +66,7 @@ public:
 
   bool operator==(const DocumentPath &other) const noexcept;
   bool operator!=(const DocumentPath &other) const noexcept;
+  bool operator<(const DocumentPath &other) const noexcept;
 
   [[nodiscard]] std::string to_string() const noexcept;
 
@@ -70,6 +76,9 @@ public:
   [[nodiscard]] DocumentPath parent() const;
   [[nodiscard]] DocumentPath join(const DocumentPath &other) const;
 
+  void push_back(const Component &component);
+  void pop_back();
+
   [[nodiscard]] const_iterator begin() const;
   [[nodiscard]] const_iterator end() const;
 
@@ -219,6 +219,11 @@ bool DocumentFile::decrypt(const std::string &password) {
   return m_impl->decrypt(password);
 }
 
+std::optional<std::size_t>
+DocumentFile::find_password(const std::vector<std::string> &passwords) const {
+  return m_impl->find_password(passwords);
+}
+
 DocumentType DocumentFile::document_type() const {
   return m_impl->document_type();
 }
@@ -232,4 +237,8 @@ Document DocumentFile::document() const { return Document(m_impl->document()); }
 PdfFile::PdfFile(std::shared_ptr<internal::pdf::PdfFile> impl)
     : DecodedFile(impl), m_impl{std::move(impl)} {}
 
+void PdfFile::extract_text(std::ostream &out) const {
+  m_impl->extract_text(out);
+}
+
 } // namespace odr
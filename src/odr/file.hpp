@@ -244,6 +244,10 @@ public:
   [[nodiscard]] bool password_encrypted() const;
   [[nodiscard]] EncryptionState encryption_state() const;
   bool decrypt(const std::string &password);
+  /// Tries all `passwords` at once and returns the index of the first one
+  /// which `decrypt` would accept, without decrypting the document.
+  [[nodiscard]] std::optional<std::size_t>
+  find_password(const std::vector<std::string> &passwords) const;
 
   [[nodiscard]] DocumentType document_type() const;
   [[nodiscard]] DocumentMeta document_meta() const;
@@ -259,6 +263,10 @@ class PdfFile final : public DecodedFile {
 public:
   explicit PdfFile(std::shared_ptr<internal::pdf::PdfFile>);
 
+  /// @brief Writes the text of every page as UTF-8 lines, each page ended by
+  /// a form feed. Much cheaper than translating the file to HTML.
+  void extract_text(std::ostream &out) const;
+
 private:
   std::shared_ptr<internal::pdf::PdfFile> m_impl;
 };
@@ -5,7 +5,9 @@
 #include <odr/document_path.hpp>
 #include <odr/exceptions.hpp>
 #include <odr/filesystem.hpp>
+#include <odr/html_service.hpp>
 
+#include <odr/internal/common/table_range.hpp>
 #include <odr/internal/html/document.hpp>
 #include <odr/internal/html/filesystem.hpp>
 #include <odr/internal/html/image_file.hpp>
@@ -116,12 +118,31 @@ Html html::translate(const PdfFile &pdf_file, const std::string &output_path,
   return internal::html::translate_pdf_file(pdf_file, output_path, config);
 }
 
+HtmlFragment html::translate_sheet(const Document &document, const Sheet &sheet,
+                                  const std::uint32_t begin_column,
+                                  const std::uint32_t begin_row,
+                                  const std::uint32_t end_column,
+                                  const std::uint32_t end_row) {
+  return internal::html::translate_sheet(
+      document, sheet,
+      internal::common::TableRange({begin_column, begin_row},
+                                   {end_column, end_row}));
+}
+
 void html::edit(const Document &document, const char *diff) {
   auto json = nlohmann::json::parse(diff);
+
+  std::vector<DocumentPath> paths;
+  std::vector<std::string> contents;
   for (const auto &[key, value] : json["modifiedText"].items()) {
-    auto element =
-        DocumentPath::find(document.root_element(), DocumentPath(key));
-    element.text().set_content(value);
+    paths.emplace_back(key);
+    contents.push_back(value);
+  }
+
+  std::vector<Element> elements =
+      DocumentPath::find(document.root_element(), paths);
+  for (std::size_t i = 0; i < elements.size(); ++i) {
+    elements[i].text().set_content(contents[i]);
   }
 }
 
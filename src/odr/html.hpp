@@ -5,6 +5,7 @@
 #include <odr/file.hpp>
 #include <odr/style.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
@@ -12,6 +13,8 @@
 
 namespace odr {
 class Archive;
+class HtmlFragment;
+class Sheet;
 struct HtmlPage;
 
 /// @brief HTML table gridlines.
@@ -58,6 +61,9 @@ struct HtmlConfig {
   // spreadsheet gridlines
   HtmlTableGridlines spreadsheet_gridlines{HtmlTableGridlines::soft};
 
+  // pdf pages translated in parallel; 0 uses all hardware threads
+  std::uint32_t pdf_thread_count{1};
+
   // formatting
   bool format_html{false};
   std::uint8_t html_indent{2};
@@ -167,6 +173,24 @@ Html translate(const Document &document, const std::string &output_path,
 Html translate(const PdfFile &pdf_file, const std::string &output_path,
                const HtmlConfig &config);
 
+/// @brief Translates a tile of a sheet to an HTML fragment.
+///
+/// Only the rows and columns inside the tile are visited and merged cells are
+/// clipped to the tile. Shapes are positioned relative to the top left of the
+/// sheet and are therefore only written by the tile which contains cell A1.
+///
+/// @param document Document the sheet belongs to.
+/// @param sheet Sheet to translate.
+/// @param begin_column First column of the tile.
+/// @param begin_row First row of the tile.
+/// @param end_column Column after the last column of the tile.
+/// @param end_row Row after the last row of the tile.
+/// @return HTML fragment of the tile.
+HtmlFragment translate_sheet(const Document &document, const Sheet &sheet,
+                             std::uint32_t begin_column,
+                             std::uint32_t begin_row, std::uint32_t end_column,
+                             std::uint32_t end_row);
+
 /// @brief Edits a document with a diff.
 ///
 /// @note The diff is generated by our JavaScript code in the browser.
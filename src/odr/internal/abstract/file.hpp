@@ -5,7 +5,9 @@
 
 #include <iosfwd>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace odr::internal::common {
 class Path;
@@ -74,6 +76,8 @@ public:
   [[nodiscard]] virtual bool password_encrypted() const noexcept = 0;
   [[nodiscard]] virtual EncryptionState encryption_state() const noexcept = 0;
   [[nodiscard]] virtual bool decrypt(const std::string &password) = 0;
+  [[nodiscard]] virtual std::optional<std::size_t>
+  find_password(const std::vector<std::string> &passwords) const = 0;
 
   [[nodiscard]] virtual DocumentType document_type() const = 0;
   [[nodiscard]] virtual DocumentMeta document_meta() const = 0;
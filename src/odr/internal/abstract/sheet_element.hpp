@@ -3,6 +3,8 @@
 
 #include <odr/internal/abstract/document_element.hpp>
 
+#include <utility>
+
 namespace odr::internal::abstract {
 class SheetCell;
 
@@ -20,6 +22,8 @@ public:
 
   [[nodiscard]] virtual SheetCell *cell(const Document *, std::uint32_t column,
                                         std::uint32_t row) const = 0;
+  [[nodiscard]] virtual std::pair<std::uint32_t, std::uint32_t>
+  anchor(const Document *, std::uint32_t column, std::uint32_t row) const = 0;
 
   [[nodiscard]] virtual Element *first_shape(const Document *) const = 0;
 
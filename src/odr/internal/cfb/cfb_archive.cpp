@@ -15,21 +15,86 @@ class MemoryFile;
 
 namespace odr::internal::cfb {
 
-CfbArchive::CfbArchive(std::shared_ptr<util::Archive> archive)
-    : m_cfb{std::move(archive)} {}
+namespace {
 
-std::shared_ptr<abstract::Filesystem> CfbArchive::filesystem() const {
-  auto filesystem = std::make_shared<common::VirtualFilesystem>();
+/// Read only view of the compound file; lookups go through the path index of
+/// `util::Archive`.
+class CfbFilesystem final : public abstract::Filesystem {
+public:
+  explicit CfbFilesystem(std::shared_ptr<util::Archive> archive)
+      : m_archive{std::move(archive)} {}
+
+  [[nodiscard]] bool exists(const common::Path &path) const final {
+    return m_archive->find(path) != std::end(*m_archive);
+  }
+
+  [[nodiscard]] bool is_file(const common::Path &path) const final {
+    auto it = m_archive->find(path);
+    return it != std::end(*m_archive) && it->is_file();
+  }
 
-  for (const auto &e : *m_cfb) {
-    if (e.is_directory()) {
-      filesystem->create_directory(e.path());
-    } else if (e.is_file()) {
-      filesystem->copy(e.file(), e.path());
+  [[nodiscard]] bool is_directory(const common::Path &path) const final {
+    auto it = m_archive->find(path);
+    return it != std::end(*m_archive) && it->is_directory();
+  }
+
+  [[nodiscard]] std::unique_ptr<abstract::FileWalker>
+  file_walker(const common::Path &path) const final {
+    // walking is rare for compound files; the virtual walker copies what it
+    // needs
+    common::VirtualFilesystem filesystem;
+    for (const auto &e : *m_archive) {
+      if (e.is_directory()) {
+        filesystem.create_directory(e.path());
+      } else if (e.is_file()) {
+        filesystem.copy(e.file(), e.path());
+      }
+    }
+    return filesystem.file_walker(path);
+  }
+
+  [[nodiscard]] std::shared_ptr<abstract::File>
+  open(const common::Path &path) const final {
+    auto it = m_archive->find(path);
+    if (it == std::end(*m_archive)) {
+      return {};
     }
+    return it->file();
   }
 
-  return filesystem;
+  std::unique_ptr<std::ostream> create_file(const common::Path &) final {
+    throw UnsupportedOperation();
+  }
+  bool create_directory(const common::Path &) final {
+    throw UnsupportedOperation();
+  }
+  bool remove(const common::Path &) final { throw UnsupportedOperation(); }
+  bool copy(const common::Path &, const common::Path &) final {
+    throw UnsupportedOperation();
+  }
+  std::shared_ptr<abstract::File> copy(const abstract::File &,
+                                       const common::Path &) final {
+    throw UnsupportedOperation();
+  }
+  std::shared_ptr<abstract::File> copy(std::shared_ptr<abstract::File>,
+                                       const common::Path &) final {
+    throw UnsupportedOperation();
+  }
+  bool move(const common::Path &, const common::Path &) final {
+    throw UnsupportedOperation();
+  }
+
+private:
+  std::shared_ptr<util::Archive> m_archive;
+};
+
+} // namespace
+
+CfbArchive::CfbArchive(std::shared_ptr<util::Archive> archive)
+    : m_cfb{std::move(archive)} {}
+
+std::shared_ptr<abstract::Filesystem> CfbArchive::filesystem() const {
+  return std::make_shared<CfbFilesystem>(m_cfb);
 }
 
 void CfbArchive::save(std::ostream &out) const {
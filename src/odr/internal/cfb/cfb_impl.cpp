@@ -11,6 +11,7 @@ namespace odr::internal::cfb::impl {
 namespace {
 constexpr auto MAGIC = "\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1";
 constexpr std::size_t MAX_REG_SECT = 0xFFFFFFFA;
+constexpr std::uint32_t FREESECT = 0xFFFFFFFF;
 
 std::uint32_t parse_uint32(const void *buffer) {
   return *static_cast<const std::uint32_t *>(buffer);
@@ -28,8 +29,7 @@ CompoundFileReader::CompoundFileReader(const void *buffer,
                                        const std::size_t len)
     : m_buffer{static_cast<const std::uint8_t *>(buffer)}, m_buffer_len{len},
       m_hdr{static_cast<const CompoundFileHeader *>(buffer)},
-      m_sector_size{512}, m_mini_sector_size{64},
-      m_mini_stream_start_sector{0} {
+      m_sector_size{512}, m_mini_sector_size{64} {
   if (buffer == nullptr || len == 0) {
     throw std::invalid_argument("");
   }
@@ -46,12 +46,44 @@ CompoundFileReader::CompoundFileReader(const void *buffer,
     throw CfbFileCorrupted();
   }
 
+  // The first 109 FAT sectors are listed in the header, the rest in the
+  // chain of DIFAT sectors. Each DIFAT sector ends with the next one.
+  const std::size_t num_fat_sector = m_hdr->num_fat_sector;
+  if (num_fat_sector > m_buffer_len / m_sector_size) {
+    throw CfbFileCorrupted();
+  }
+  SectorChain fat_sectors(m_hdr->header_difat,
+                          m_hdr->header_difat +
+                              std::min<std::size_t>(num_fat_sector, 109));
+  const std::size_t entries_per_difat_sector = m_sector_size / 4 - 1;
+  std::size_t difat_sector = m_hdr->first_difat_sector_location;
+  while (fat_sectors.size() < num_fat_sector) {
+    const std::uint8_t *difat = sector_offset_to_address(difat_sector, 0);
+    const std::uint8_t *next = sector_offset_to_address(
+        difat_sector, entries_per_difat_sector * 4);
+    for (std::size_t i = 0; i < entries_per_difat_sector &&
+                            fat_sectors.size() < num_fat_sector;
+         ++i) {
+      fat_sectors.push_back(parse_uint32(difat + i * 4));
+    }
+    difat_sector = parse_uint32(next);
+  }
+  read_table(fat_sectors, m_fat);
+
+  m_directory_chain = follow_chain(m_hdr->first_directory_sector_location,
+                                   m_fat, m_fat.size());
+  read_table(follow_chain(m_hdr->first_mini_fat_sector_location, m_fat,
+                          m_hdr->num_mini_fat_sector),
+             m_mini_fat);
+
   const CompoundFileEntry *root = get_entry(0);
   if (root == nullptr) {
     throw CfbFileCorrupted();
   }
 
-  m_mini_stream_start_sector = root->start_sector_location;
+  m_mini_stream_chain =
+      follow_chain(root->start_sector_location, m_fat,
+                   (root->size + m_sector_size - 1) / m_sector_size);
 }
 
 const CompoundFileEntry *CompoundFileReader::get_entry(size_t entry_id) const {
@@ -63,12 +95,13 @@ const CompoundFileEntry *CompoundFileReader::get_entry(size_t entry_id) const {
     throw std::invalid_argument("");
   }
 
-  std::size_t sector = 0;
-  std::size_t offset = 0;
-  locate_final_sector(m_hdr->first_directory_sector_location,
-                      entry_id * sizeof(CompoundFileEntry), &sector, &offset);
-  return reinterpret_cast<const CompoundFileEntry *>(
-      sector_offset_to_address(sector, offset));
+  const std::size_t position = entry_id * sizeof(CompoundFileEntry);
+  const std::size_t index = position / m_sector_size;
+  if (index >= m_directory_chain.size()) {
+    throw CfbFileCorrupted();
+  }
+  return reinterpret_cast<const CompoundFileEntry *>(sector_offset_to_address(
+      m_directory_chain[index], position % m_sector_size));
 }
 
 const CompoundFileEntry *CompoundFileReader::get_root_entry() const {
@@ -79,18 +112,88 @@ const CompoundFileHeader *CompoundFileReader::get_file_info() const {
   return m_hdr;
 }
 
+SectorChain
+CompoundFileReader::sector_chain(const CompoundFileEntry *entry) const {
+  if (is_mini_stream(entry)) {
+    return follow_chain(entry->start_sector_location, m_mini_fat,
+                        (entry->size + m_mini_sector_size - 1) /
+                            m_mini_sector_size);
+  }
+  return follow_chain(entry->start_sector_location, m_fat,
+                      (entry->size + m_sector_size - 1) / m_sector_size);
+}
+
 void CompoundFileReader::read_file(const CompoundFileEntry *entry,
                                    const std::size_t offset, char *buffer,
                                    const std::size_t len) const {
+  read_file(entry, sector_chain(entry), offset, buffer, len);
+}
+
+void CompoundFileReader::read_file(const CompoundFileEntry *entry,
+                                   const SectorChain &chain,
+                                   std::size_t offset, char *buffer,
+                                   std::size_t len) const {
   if (entry->size < offset || entry->size - offset < len) {
     throw std::invalid_argument("");
   }
 
-  if (entry->size < m_hdr->mini_stream_cutoff_size) {
-    read_mini_stream(entry->start_sector_location, offset, buffer, len);
-  } else {
-    read_stream(entry->start_sector_location, offset, buffer, len);
+  const bool mini = is_mini_stream(entry);
+  const std::size_t sector_size = mini ? m_mini_sector_size : m_sector_size;
+  std::size_t index = offset / sector_size;
+  offset %= sector_size;
+
+  // copy as many as possible in each step
+  // copylen typically iterate as: sector_size - offset   -->   sector_size
+  // -->   sector_size  --> ... -->    remaining
+  while (len > 0) {
+    if (index >= chain.size()) {
+      throw CfbFileCorrupted();
+    }
+    const std::uint8_t *src =
+        mini ? mini_sector_offset_to_address(chain[index], offset)
+             : sector_offset_to_address(chain[index], offset);
+    std::size_t copylen = std::min(len, sector_size - offset);
+    if (m_buffer + m_buffer_len < src + copylen) {
+      throw CfbFileCorrupted();
+    }
+
+    std::memcpy(buffer, src, copylen);
+    buffer += copylen;
+    len -= copylen;
+    ++index;
+    offset = 0;
+  }
+}
+
+std::vector<std::string_view>
+CompoundFileReader::spans(const CompoundFileEntry *entry) const {
+  const bool mini = is_mini_stream(entry);
+  const std::size_t sector_size = mini ? m_mini_sector_size : m_sector_size;
+
+  std::vector<std::string_view> result;
+  std::uint64_t remaining = entry->size;
+  for (std::uint32_t sector : sector_chain(entry)) {
+    const std::uint8_t *src = mini ? mini_sector_offset_to_address(sector, 0)
+                                   : sector_offset_to_address(sector, 0);
+    const std::size_t length = std::min<std::uint64_t>(remaining, sector_size);
+    if (m_buffer + m_buffer_len < src + length) {
+      throw CfbFileCorrupted();
+    }
+    remaining -= length;
+
+    const char *data = reinterpret_cast<const char *>(src);
+    if (!result.empty() &&
+        result.back().data() + result.back().size() == data) {
+      result.back() = {result.back().data(), result.back().size() + length};
+    } else {
+      result.emplace_back(data, length);
+    }
   }
+  if (remaining > 0) {
+    throw CfbFileCorrupted();
+  }
+
+  return result;
 }
 
 void CompoundFileReader::enum_files(const CompoundFileEntry *entry,
@@ -132,67 +235,44 @@ void CompoundFileReader::enum_nodes(const CompoundFileEntry *entry,
              callback);
 }
 
-void CompoundFileReader::read_stream(std::size_t sector, std::size_t offset,
-                                     char *buffer, std::size_t len) const {
-  locate_final_sector(sector, offset, &sector, &offset);
-
-  // copy as many as possible in each step
-  // copylen typically iterate as: m_sectorSize - offset   -->   m_sectorSize
-  // -->   m_sectorSize  --> ... -->    remaining
-  while (len > 0) {
-    const std::uint8_t *src = sector_offset_to_address(sector, offset);
-    std::size_t copylen = std::min(len, m_sector_size - offset);
-    if (m_buffer + m_buffer_len < src + copylen) {
-      throw CfbFileCorrupted();
-    }
+bool CompoundFileReader::is_mini_stream(
+    const CompoundFileEntry *entry) const {
+  return entry->size < m_hdr->mini_stream_cutoff_size;
+}
 
-    std::memcpy(buffer, src, copylen);
-    buffer += copylen;
-    len -= copylen;
-    sector = get_next_sector(sector);
-    offset = 0;
+SectorChain CompoundFileReader::follow_chain(std::size_t sector,
+                                             const SectorChain &table,
+                                             std::size_t max_length) const {
+  // Anything past the end of the table or a cycle cuts the chain short;
+  // reading the missing part fails instead.
+  max_length = std::min(max_length, table.size());
+  SectorChain chain;
+  chain.reserve(max_length);
+  while (sector < table.size() && chain.size() < max_length) {
+    chain.push_back(static_cast<std::uint32_t>(sector));
+    sector = table[sector];
   }
+  return chain;
 }
 
-void CompoundFileReader::read_mini_stream(std::size_t sector,
-                                          std::size_t offset, char *buffer,
-                                          std::size_t len) const {
-  locate_final_mini_sector(sector, offset, &sector, &offset);
-
-  // copy as many as possible in each step
-  // copylen typically iterate as: m_sectorSize - offset   -->   m_sectorSize
-  // -->   m_sectorSize  --> ... -->    remaining
-  while (len > 0) {
-    const std::uint8_t *src = mini_sector_offset_to_address(sector, offset);
-    std::size_t copylen = std::min(len, m_mini_sector_size - offset);
-    if (m_buffer + m_buffer_len < src + copylen) {
-      throw CfbFileCorrupted();
+void CompoundFileReader::read_table(const SectorChain &sectors,
+                                    SectorChain &table) const {
+  const std::size_t entries_per_sector = m_sector_size / 4;
+  table.reserve(table.size() + sectors.size() * entries_per_sector);
+  for (std::uint32_t sector : sectors) {
+    // sectors outside of the file are treated as free
+    if (sector >= MAX_REG_SECT ||
+        m_buffer_len / m_sector_size < std::size_t{sector} + 2) {
+      table.insert(std::end(table), entries_per_sector, FREESECT);
+      continue;
+    }
+    const std::uint8_t *entries = sector_offset_to_address(sector, 0);
+    for (std::size_t i = 0; i < entries_per_sector; ++i) {
+      table.push_back(parse_uint32(entries + i * 4));
     }
-
-    std::memcpy(buffer, src, copylen);
-    buffer += copylen;
-    len -= copylen;
-    sector = get_next_mini_sector(sector);
-    offset = 0;
   }
 }
 
-std::size_t CompoundFileReader::get_next_sector(size_t sector) const {
-  // lookup FAT
-  std::size_t entriesPerSector = m_sector_size / 4;
-  std::size_t fatSectorNumber = sector / entriesPerSector;
-  std::size_t fatSectorLocation = get_fat_sector_location(fatSectorNumber);
-  return parse_uint32(sector_offset_to_address(fatSectorLocation,
-                                               sector % entriesPerSector * 4));
-}
-
-std::size_t CompoundFileReader::get_next_mini_sector(size_t mini_sector) const {
-  std::size_t sector, offset;
-  locate_final_sector(m_hdr->first_mini_fat_sector_location, mini_sector * 4,
-                      &sector, &offset);
-  return parse_uint32(sector_offset_to_address(sector, offset));
-}
-
 const std::uint8_t *
 CompoundFileReader::sector_offset_to_address(size_t sector,
                                              size_t offset) const {
@@ -208,57 +288,18 @@ CompoundFileReader::sector_offset_to_address(size_t sector,
 const std::uint8_t *
 CompoundFileReader::mini_sector_offset_to_address(std::size_t sector,
                                                   std::size_t offset) const {
-  if (sector >= MAX_REG_SECT || offset >= m_mini_sector_size ||
-      m_buffer_len <=
-          static_cast<std::uint64_t>(m_mini_sector_size) * sector + offset) {
+  if (sector >= MAX_REG_SECT || offset >= m_mini_sector_size) {
     throw CfbFileCorrupted();
   }
 
-  locate_final_sector(m_mini_stream_start_sector,
-                      sector * m_mini_sector_size + offset, &sector, &offset);
-  return sector_offset_to_address(sector, offset);
-}
-
-void CompoundFileReader::locate_final_sector(std::size_t sector,
-                                             std::size_t offset,
-                                             std::size_t *final_sector,
-                                             std::size_t *final_offset) const {
-  while (offset >= m_sector_size) {
-    offset -= m_sector_size;
-    sector = get_next_sector(sector);
-  }
-  *final_sector = sector;
-  *final_offset = offset;
-}
-
-void CompoundFileReader::locate_final_mini_sector(
-    std::size_t sector, std::size_t offset, std::size_t *final_sector,
-    std::size_t *final_offset) const {
-  while (offset >= m_mini_sector_size) {
-    offset -= m_mini_sector_size;
-    sector = get_next_mini_sector(sector);
-  }
-  *final_sector = sector;
-  *final_offset = offset;
-}
-
-std::size_t CompoundFileReader::get_fat_sector_location(
-    std::size_t fat_sector_number) const {
-  if (fat_sector_number < 109) {
-    return m_hdr->header_difat[fat_sector_number];
-  }
-
-  fat_sector_number -= 109;
-  std::size_t entriesPerSector = m_sector_size / 4 - 1;
-  std::size_t difatSectorLocation = m_hdr->first_difat_sector_location;
-  while (fat_sector_number >= entriesPerSector) {
-    fat_sector_number -= entriesPerSector;
-    const std::uint8_t *addr =
-        sector_offset_to_address(difatSectorLocation, m_sector_size - 4);
-    difatSectorLocation = parse_uint32(addr);
+  const std::uint64_t position =
+      static_cast<std::uint64_t>(m_mini_sector_size) * sector + offset;
+  const std::uint64_t index = position / m_sector_size;
+  if (index >= m_mini_stream_chain.size()) {
+    throw CfbFileCorrupted();
   }
-  return parse_uint32(
-      sector_offset_to_address(difatSectorLocation, fat_sector_number * 4));
+  return sector_offset_to_address(m_mini_stream_chain[index],
+                                  position % m_sector_size);
 }
 
 PropertySet::PropertySet(const void *buffer, const std::size_t len,
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace odr::internal::cfb::impl {
 
@@ -76,6 +78,9 @@ using EnumFilesCallback =
     std::function<void(const CompoundFileEntry *entry,
                        const std::u16string &dir, std::uint32_t level)>;
 
+/// Sectors of a stream in order; mini sectors for streams below the cutoff.
+using SectorChain = std::vector<std::uint32_t>;
+
 class CompoundFileReader final {
 public:
   CompoundFileReader(const void *buffer, std::size_t len);
@@ -90,11 +95,22 @@ public:
 
   [[nodiscard]] const CompoundFileHeader *get_file_info() const;
 
+  /// Walk the sector chain of a file once so it can be reused for many reads.
+  [[nodiscard]] SectorChain sector_chain(const CompoundFileEntry *entry) const;
+
   /// Get file(stream) data start with "offset".
   /// The buffer must have enough space to store "len" bytes. Typically "len" is
   /// derived by the steam length.
   void read_file(const CompoundFileEntry *entry, std::size_t offset,
                  char *buffer, std::size_t len) const;
+  /// Same as above with the chain from `sector_chain` of the same entry.
+  void read_file(const CompoundFileEntry *entry, const SectorChain &chain,
+                 std::size_t offset, char *buffer, std::size_t len) const;
+
+  /// The bytes of a file as views into the compound file buffer, in order.
+  /// Runs of consecutive sectors are merged into one span.
+  [[nodiscard]] std::vector<std::string_view>
+  spans(const CompoundFileEntry *entry) const;
 
   void enum_files(const CompoundFileEntry *entry, int max_level,
                   const EnumFilesCallback &callback) const;
@@ -105,16 +121,15 @@ private:
                   std::int32_t max_level, const std::u16string &dir,
                   const EnumFilesCallback &callback) const;
 
-  void read_stream(std::size_t sector, std::size_t offset, char *buffer,
-                   std::size_t len) const;
-
-  // Same logic as "ReadStream" except that use MiniStream functions instead
-  void read_mini_stream(std::size_t sector, std::size_t offset, char *buffer,
-                        std::size_t len) const;
+  [[nodiscard]] bool is_mini_stream(const CompoundFileEntry *entry) const;
 
-  [[nodiscard]] std::size_t get_next_sector(std::size_t sector) const;
+  /// Follow `table` from `sector` for at most `max_length` sectors.
+  [[nodiscard]] SectorChain follow_chain(std::size_t sector,
+                                         const SectorChain &table,
+                                         std::size_t max_length) const;
 
-  [[nodiscard]] std::size_t get_next_mini_sector(std::size_t mini_sector) const;
+  /// Append the entries of the table stored in `sectors` to `table`.
+  void read_table(const SectorChain &sectors, SectorChain &table) const;
 
   /// Get absolute address from sector and offset.
   [[nodiscard]] const std::uint8_t *
@@ -123,19 +138,6 @@ private:
   [[nodiscard]] const std::uint8_t *
   mini_sector_offset_to_address(std::size_t sector, std::size_t offset) const;
 
-  /// Locate the final sector/offset when original offset expands multiple
-  /// sectors
-  void locate_final_sector(std::size_t sector, std::size_t offset,
-                           std::size_t *final_sector,
-                           std::size_t *final_offset) const;
-
-  void locate_final_mini_sector(std::size_t sector, std::size_t offset,
-                                std::size_t *final_sector,
-                                std::size_t *final_offset) const;
-
-  [[nodiscard]] std::size_t
-  get_fat_sector_location(std::size_t fat_sector_number) const;
-
 private:
   const std::uint8_t *m_buffer;
   std::size_t m_buffer_len;
@@ -143,7 +145,13 @@ private:
   const CompoundFileHeader *m_hdr;
   std::size_t m_sector_size;
   std::size_t m_mini_sector_size;
-  std::size_t m_mini_stream_start_sector;
+
+  // The allocation tables and the chains every lookup goes through are
+  // resolved once on construction.
+  SectorChain m_fat;
+  SectorChain m_mini_fat;
+  SectorChain m_directory_chain;
+  SectorChain m_mini_stream_chain;
 };
 
 class PropertySet final {
@@ -1,48 +1,45 @@
 #include <odr/internal/cfb/cfb_util.hpp>
 
+#include <odr/exceptions.hpp>
+
 #include <odr/internal/common/file.hpp>
 #include <odr/internal/util/string_util.hpp>
 
 #include <algorithm>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace odr::internal::cfb::util {
 
 namespace {
 
+/// Hands out the spans of a file one after another. The get area points
+/// straight into the compound file so nothing is copied.
 class ReaderBuffer : public std::streambuf {
 public:
   ReaderBuffer(const impl::CompoundFileReader &reader,
                const impl::CompoundFileEntry &entry)
-      : m_reader{reader}, m_entry{entry}, m_buffer{new char[m_buffer_size]} {}
-  ReaderBuffer(const ReaderBuffer &) = delete;
-  ReaderBuffer(ReaderBuffer &&other) noexcept = delete;
-  ~ReaderBuffer() override { delete[] m_buffer; }
-
-  ReaderBuffer &operator=(const ReaderBuffer &) = delete;
-  ReaderBuffer &operator=(ReaderBuffer &&other) noexcept = delete;
+      : m_spans{reader.spans(&entry)} {}
 
   int underflow() final {
-    const std::uint64_t remaining = m_entry.size - m_offset;
-    if (remaining <= 0) {
+    if (m_next_span >= m_spans.size()) {
       return std::char_traits<char>::eof();
     }
 
-    const std::uint64_t amount = std::min(remaining, m_buffer_size);
-    m_reader.read_file(&m_entry, m_offset, m_buffer, amount);
-    m_offset += amount;
-    setg(m_buffer, m_buffer, m_buffer + amount);
+    std::string_view span = m_spans[m_next_span++];
+    // the stream never writes into the get area
+    char *begin = const_cast<char *>(span.data());
+    setg(begin, begin, begin + span.size());
 
     return std::char_traits<char>::to_int_type(*gptr());
   }
 
 private:
-  const impl::CompoundFileReader &m_reader;
-  const impl::CompoundFileEntry &m_entry;
-  std::uint64_t m_offset{0};
-  std::uint64_t m_buffer_size{4098};
-  char *m_buffer;
+  std::vector<std::string_view> m_spans;
+  std::size_t m_next_span{0};
 };
 
 class FileInCfbIstream final : public std::istream {
@@ -76,7 +73,21 @@ public:
   [[nodiscard]] std::optional<common::Path> disk_path() const final {
     return std::nullopt;
   }
-  [[nodiscard]] const char *memory_data() const final { return nullptr; }
+  [[nodiscard]] const char *memory_data() const final {
+    // resolving the spans walks the whole chain, so it is left to the callers
+    // that actually want the data in one piece
+    std::call_once(m_memory_data_once, [this] {
+      try {
+        auto spans = m_archive->cfb().spans(&m_entry);
+        if (spans.size() == 1) {
+          m_memory_data = spans.front().data();
+        }
+      } catch (const CfbFileCorrupted &) {
+        // reported once the stream is read
+      }
+    });
+    return m_memory_data;
+  }
 
   [[nodiscard]] std::unique_ptr<std::istream> stream() const final {
     return std::make_unique<FileInCfbIstream>(m_archive, m_archive->cfb(),
@@ -86,6 +97,9 @@ public:
 private:
   std::shared_ptr<const Archive> m_archive;
   const impl::CompoundFileEntry &m_entry;
+  mutable std::once_flag m_memory_data_once;
+  /// set if the file is stored in one piece
+  mutable const char *m_memory_data{nullptr};
 };
 
 } // namespace
@@ -94,7 +108,7 @@ bool Archive::Entry::is_file() const { return m_entry->is_stream(); }
 
 bool Archive::Entry::is_directory() const { return !m_entry->is_stream(); }
 
-common::Path Archive::Entry::path() const { return m_path; }
+const common::Path &Archive::Entry::path() const { return m_path; }
 
 std::unique_ptr<abstract::File> Archive::Entry::file() const {
   if (!is_file()) {
@@ -103,111 +117,102 @@ std::unique_ptr<abstract::File> Archive::Entry::file() const {
   return std::make_unique<FileInCfb>(m_parent->shared_from_this(), *m_entry);
 }
 
-std::string Archive::Entry::name() const {
-  return odr::internal::util::string::c16str_to_string(
-      reinterpret_cast<const char16_t *>(m_entry->name), m_entry->name_len - 2);
-}
-
-std::optional<Archive::Entry> Archive::Entry::left() const {
-  auto left = m_parent->cfb().get_entry(m_entry->left_sibling_id);
-  if (left == nullptr) {
-    return {};
-  }
-  return Entry(*m_parent, *left, m_path.parent());
-}
-
-std::optional<Archive::Entry> Archive::Entry::right() const {
-  auto right = m_parent->cfb().get_entry(m_entry->right_sibling_id);
-  if (right == nullptr) {
-    return {};
-  }
-  return Entry(*m_parent, *right, m_path.parent());
-}
+std::string Archive::Entry::name() const { return m_path.basename(); }
 
-std::optional<Archive::Entry> Archive::Entry::child() const {
-  auto child = m_parent->cfb().get_entry(m_entry->child_id);
-  if (child == nullptr) {
-    return {};
-  }
-  return Entry(*m_parent, *child, m_path);
+Archive::Archive(const std::shared_ptr<common::MemoryFile> &file)
+    : m_file{file}, m_cfb{file->content().data(), file->content().size()} {
+  read_directory();
 }
 
-void Archive::Iterator::dig_left_() {
-  if (!m_entry) {
+void Archive::read_directory() {
+  const impl::CompoundFileEntry *root = m_cfb.get_root_entry();
+  if (root == nullptr) {
     return;
   }
 
-  while (true) {
-    auto left = m_entry->left();
-    if (!left) {
-      break;
+  // every sibling tree is walked in order, the children of a storage right
+  // after it; ids seen before are skipped so broken trees cannot loop
+  std::vector<bool> visited;
+  auto visit = [&](std::uint32_t id) -> const impl::CompoundFileEntry * {
+    const impl::CompoundFileEntry *entry = m_cfb.get_entry(id);
+    if (entry == nullptr) {
+      return nullptr;
+    }
+    if (id >= visited.size()) {
+      visited.resize(id + 1);
+    }
+    if (visited[id]) {
+      return nullptr;
+    }
+    visited[id] = true;
+    return entry;
+  };
+
+  struct Pending {
+    const impl::CompoundFileEntry *entry;
+    std::size_t parent;
+    /// the left subtree was pushed already
+    bool expanded;
+  };
+  std::vector<Pending> stack;
+
+  visit(0);
+  m_entries.emplace_back(*this, *root, common::Path("/"));
+  if (auto child = visit(root->child_id)) {
+    stack.push_back({child, 0, false});
+  }
+
+  while (!stack.empty()) {
+    Pending pending = stack.back();
+    stack.pop_back();
+
+    if (!pending.expanded) {
+      stack.push_back({pending.entry, pending.parent, true});
+      if (auto left = visit(pending.entry->left_sibling_id)) {
+        stack.push_back({left, pending.parent, false});
+      }
+      continue;
     }
-    m_ancestors.push_back(*m_entry);
-    m_entry = left;
-  }
-}
-
-void Archive::Iterator::next_() {
-  if (!m_entry) {
-    return;
-  }
-
-  auto child = m_entry->child();
-  if (child) {
-    m_directories.push_back(*m_entry);
-    m_entry = child;
-    dig_left_();
-    return;
-  }
-
-  next_flat_();
-}
-
-void Archive::Iterator::next_flat_() {
-  if (!m_entry) {
-    return;
-  }
 
-  auto right = m_entry->right();
-  if (right) {
-    m_entry = right;
-    dig_left_();
-    return;
-  }
+    const impl::CompoundFileEntry &entry = *pending.entry;
+    std::string name;
+    if (entry.name_len >= 2) {
+      name = odr::internal::util::string::c16str_to_string(
+          reinterpret_cast<const char16_t *>(entry.name), entry.name_len - 2);
+    }
+    const std::size_t index = m_entries.size();
+    m_entries.emplace_back(*this, entry,
+                           m_entries[pending.parent].path().join(name));
 
-  if (!m_ancestors.empty()) {
-    m_entry = m_ancestors.back();
-    m_ancestors.pop_back();
-    return;
+    // the right siblings come after the children of this entry
+    if (auto right = visit(entry.right_sibling_id)) {
+      stack.push_back({right, pending.parent, false});
+    }
+    if (auto child = visit(entry.child_id)) {
+      stack.push_back({child, index, false});
+    }
   }
 
-  if (!m_directories.empty()) {
-    m_entry = m_directories.back();
-    m_directories.pop_back();
-    next_flat_();
-    return;
+  m_index.reserve(m_entries.size());
+  for (std::size_t i = 0; i < m_entries.size(); ++i) {
+    m_index.emplace(m_entries[i].path(), i);
   }
-
-  m_entry = {};
 }
 
-Archive::Archive(const std::shared_ptr<common::MemoryFile> &file)
-    : m_file{file}, m_cfb{file->content().data(), file->content().size()} {}
-
 const impl::CompoundFileReader &Archive::cfb() const { return m_cfb; }
 
 std::shared_ptr<abstract::File> Archive::file() const { return m_file; }
 
-Archive::Iterator Archive::begin() const {
-  return {*this, *m_cfb.get_root_entry()};
-}
+Archive::Iterator Archive::begin() const { return std::begin(m_entries); }
 
-Archive::Iterator Archive::end() const { return {}; }
+Archive::Iterator Archive::end() const { return std::end(m_entries); }
 
 Archive::Iterator Archive::find(const common::Path &path) const {
-  return std::find_if(begin(), end(), [&path](const Entry &entry) {
-    return entry.path() == path;
-  });
+  auto it = m_index.find(path);
+  if (it == std::end(m_index)) {
+    return end();
+  }
+  return begin() + it->second;
 }
 
 } // namespace odr::internal::cfb::util
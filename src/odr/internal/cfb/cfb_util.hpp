@@ -10,6 +10,9 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace odr::internal::common {
 class MemoryFile;
@@ -22,16 +25,22 @@ struct CompoundFileEntry;
 
 namespace odr::internal::cfb::util {
 
+/// The directory of a compound file, read once into a flat list of entries
+/// with their paths and indexed by path.
 class Archive final : public std::enable_shared_from_this<Archive> {
 public:
+  class Entry;
+  using Iterator = std::vector<Entry>::const_iterator;
+
   explicit Archive(const std::shared_ptr<common::MemoryFile> &file);
+  Archive(const Archive &) = delete;
+  Archive &operator=(const Archive &) = delete;
 
   [[nodiscard]] const impl::CompoundFileReader &cfb() const;
 
   [[nodiscard]] std::shared_ptr<abstract::File> file() const;
 
-  class Iterator;
-
+  /// Entries in depth first order, starting with the root storage.
   [[nodiscard]] Iterator begin() const;
   [[nodiscard]] Iterator end() const;
 
@@ -39,17 +48,9 @@ public:
 
   class Entry {
   public:
-    Entry(const Entry &) = default;
-    Entry(Entry &&) noexcept = default;
-    Entry(const Archive &parent, const impl::CompoundFileEntry &entry)
-        : m_parent{&parent}, m_entry{&entry}, m_path{"/"} {}
     Entry(const Archive &parent, const impl::CompoundFileEntry &entry,
-          const common::Path &parent_path)
-        : m_parent{&parent}, m_entry{&entry}, m_path{parent_path.join(name())} {
-    }
-    ~Entry() = default;
-    Entry &operator=(const Entry &) = default;
-    Entry &operator=(Entry &&) noexcept = default;
+          common::Path path)
+        : m_parent{&parent}, m_entry{&entry}, m_path{std::move(path)} {}
 
     bool operator==(const Entry &other) const {
       return m_entry == other.m_entry;
@@ -60,79 +61,25 @@ public:
 
     [[nodiscard]] bool is_file() const;
     [[nodiscard]] bool is_directory() const;
-    [[nodiscard]] common::Path path() const;
+    [[nodiscard]] const common::Path &path() const;
     [[nodiscard]] std::unique_ptr<abstract::File> file() const;
 
     [[nodiscard]] std::string name() const;
-    [[nodiscard]] std::optional<Entry> left() const;
-    [[nodiscard]] std::optional<Entry> right() const;
-    [[nodiscard]] std::optional<Entry> child() const;
 
   private:
     const Archive *m_parent;
     const impl::CompoundFileEntry *m_entry;
     common::Path m_path;
-
-    friend Iterator;
-  };
-
-  class Iterator {
-  public:
-    using iterator_category = std::forward_iterator_tag;
-    using difference_type = std::ptrdiff_t;
-    using value_type = Entry;
-    using pointer = const Entry *;
-    using reference = const Entry &;
-
-    Iterator() = default;
-    Iterator(const Iterator &) = default;
-    Iterator(Iterator &&) noexcept = default;
-    Iterator(const Archive &parent, const impl::CompoundFileEntry &entry)
-        : m_entry{Entry(parent, entry)} {
-      dig_left_();
-    }
-    Iterator(const Archive &parent, const impl::CompoundFileEntry &entry,
-             const common::Path &parent_path)
-        : m_entry{Entry(parent, entry, parent_path)} {
-      dig_left_();
-    }
-    ~Iterator() = default;
-    Iterator &operator=(const Iterator &) = default;
-    Iterator &operator=(Iterator &&) noexcept = default;
-
-    [[nodiscard]] reference operator*() const { return *m_entry; }
-    [[nodiscard]] pointer operator->() const { return &*m_entry; }
-
-    [[nodiscard]] bool operator==(const Iterator &other) const {
-      return m_entry == other.m_entry;
-    }
-    [[nodiscard]] bool operator!=(const Iterator &other) const {
-      return m_entry != other.m_entry;
-    }
-
-    Iterator &operator++() {
-      next_();
-      return *this;
-    }
-    Iterator operator++(int) {
-      Iterator tmp = *this;
-      ++(*this);
-      return tmp;
-    }
-
-  private:
-    std::optional<Entry> m_entry;
-    std::vector<Entry> m_ancestors;
-    std::vector<Entry> m_directories;
-
-    void dig_left_();
-    void next_();
-    void next_flat_();
   };
 
 private:
   std::shared_ptr<abstract::File> m_file;
   impl::CompoundFileReader m_cfb;
+
+  std::vector<Entry> m_entries;
+  std::unordered_map<common::Path, std::size_t> m_index;
+
+  void read_directory();
 };
 
 } // namespace odr::internal::cfb::util
@@ -0,0 +1,45 @@
+#include <odr/internal/common/table_merges.hpp>
+
+#include <algorithm>
+
+namespace odr::internal::common {
+
+void TableMerges::add(const std::uint32_t column, const std::uint32_t row,
+                      const TableDimensions span) {
+  m_merges[row][column] = span;
+  m_max_rows = std::max(m_max_rows, span.rows);
+}
+
+TableDimensions TableMerges::span(const std::uint32_t column,
+                                  const std::uint32_t row) const {
+  if (auto row_it = m_merges.find(row); row_it != std::end(m_merges)) {
+    if (auto cell_it = row_it->second.find(column);
+        cell_it != std::end(row_it->second)) {
+      return cell_it->second;
+    }
+  }
+  return {1, 1};
+}
+
+std::pair<std::uint32_t, std::uint32_t>
+TableMerges::anchor(const std::uint32_t column, const std::uint32_t row) const {
+  // merges cannot overlap so only rows within the tallest merge have to be
+  // considered and the first hit is the anchor
+  const std::uint32_t first_row = row >= m_max_rows ? row - m_max_rows + 1 : 0;
+  for (auto row_it = m_merges.lower_bound(first_row);
+       row_it != std::end(m_merges) && row_it->first <= row; ++row_it) {
+    const auto &row_merges = row_it->second;
+    auto cell_it = row_merges.upper_bound(column);
+    if (cell_it == std::begin(row_merges)) {
+      continue;
+    }
+    --cell_it;
+    if ((cell_it->first + cell_it->second.columns > column) &&
+        (row_it->first + cell_it->second.rows > row)) {
+      return {cell_it->first, row_it->first};
+    }
+  }
+  return {column, row};
+}
+
+} // namespace odr::internal::common
@@ -0,0 +1,32 @@
+#ifndef ODR_INTERNAL_COMMON_TABLE_MERGES_HPP
+#define ODR_INTERNAL_COMMON_TABLE_MERGES_HPP
+
+#include <odr/style.hpp>
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+namespace odr::internal::common {
+
+/// Merged cells of a sheet by their top left cell.
+class TableMerges final {
+public:
+  void add(std::uint32_t column, std::uint32_t row, TableDimensions span);
+
+  /// Span of the merge starting at the given cell; 1x1 if there is none.
+  [[nodiscard]] TableDimensions span(std::uint32_t column,
+                                     std::uint32_t row) const;
+  /// Top left cell of the merge covering the given cell, or the cell itself.
+  [[nodiscard]] std::pair<std::uint32_t, std::uint32_t>
+  anchor(std::uint32_t column, std::uint32_t row) const;
+
+private:
+  // by anchor row and anchor column
+  std::map<std::uint32_t, std::map<std::uint32_t, TableDimensions>> m_merges;
+  std::uint32_t m_max_rows{1};
+};
+
+} // namespace odr::internal::common
+
+#endif // ODR_INTERNAL_COMMON_TABLE_MERGES_HPP
@@ -1,6 +1,12 @@
 #include <odr/internal/crypto/crypto_util.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
 
 #include <cryptopp/aes.h>
 #include <cryptopp/base64.h>
@@ -13,18 +19,140 @@
 #include <cryptopp/zinflate.h>
 #include <cryptopp/zlib.h>
 
+#include <miniz/miniz.h>
+
+#ifdef ODR_ZLIB_NG
+#include <zlib-ng.h>
+#endif
+
+#ifdef ODR_OPENSSL
+#include <openssl/evp.h>
+#endif
+
 namespace odr::internal::crypto {
 
 using byte = std::uint8_t;
 
+namespace {
+
+// maps 12 bits of input to two output characters at once, which halves the
+// number of lookups compared to the textbook 6 bit table
+constexpr std::array<char, 2 * 4096> base64_pair_table() {
+  constexpr const char *alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::array<char, 2 * 4096> result{};
+  for (std::size_t i = 0; i < 4096; ++i) {
+    result[2 * i] = alphabet[i >> 6];
+    result[2 * i + 1] = alphabet[i & 0x3f];
+  }
+  return result;
+}
+
+constexpr std::array<char, 2 * 4096> base64_pairs = base64_pair_table();
+
+/// Encodes `size` bytes from `in` to `out` which has to hold
+/// `(size + 2) / 3 * 4` characters. Pads if `size` is not a multiple of 3.
+std::size_t base64_encode_block(const byte *in, std::size_t size, char *out) {
+  char *begin = out;
+  std::size_t i = 0;
+  for (; i + 3 <= size; i += 3) {
+    std::uint32_t triple = (std::uint32_t(in[i]) << 16) |
+                           (std::uint32_t(in[i + 1]) << 8) | in[i + 2];
+    const char *high = &base64_pairs[2 * (triple >> 12)];
+    const char *low = &base64_pairs[2 * (triple & 0xfff)];
+    out[0] = high[0];
+    out[1] = high[1];
+    out[2] = low[0];
+    out[3] = low[1];
+    out += 4;
+  }
+  if (std::size_t rest = size - i; rest > 0) {
+    std::uint32_t triple = std::uint32_t(in[i]) << 16;
+    if (rest == 2) {
+      triple |= std::uint32_t(in[i + 1]) << 8;
+    }
+    const char *high = &base64_pairs[2 * (triple >> 12)];
+    const char *low = &base64_pairs[2 * (triple & 0xfff)];
+    out[0] = high[0];
+    out[1] = high[1];
+    out[2] = rest == 2 ? low[0] : '=';
+    out[3] = '=';
+    out += 4;
+  }
+  return out - begin;
+}
+
+} // namespace
+
 std::string util::base64_encode(const std::string &in) {
-  std::string out;
-  CryptoPP::Base64Encoder b(new CryptoPP::StringSink(out), false);
-  b.Put(reinterpret_cast<const byte *>(in.data()), in.size());
-  b.MessageEnd();
+  std::string out((in.size() + 2) / 3 * 4, '\0');
+  base64_encode_block(reinterpret_cast<const byte *>(in.data()), in.size(),
+                      out.data());
   return out;
 }
 
+void util::base64_encode(std::string_view in, std::ostream &out) {
+  // a multiple of 3 so that only the last block needs padding
+  constexpr std::size_t block_size = 3 * 4096;
+  std::array<char, block_size / 3 * 4> buffer;
+  for (std::size_t offset = 0; offset < in.size(); offset += block_size) {
+    std::size_t size = std::min(block_size, in.size() - offset);
+    out.write(buffer.data(),
+              base64_encode_block(
+                  reinterpret_cast<const byte *>(in.data() + offset), size,
+                  buffer.data()));
+  }
+}
+
+void util::base64_encode(std::istream &in, std::ostream &out) {
+  constexpr std::size_t block_size = 3 * 4096;
+  std::array<char, block_size> input;
+  std::array<char, block_size / 3 * 4> buffer;
+  while (in) {
+    // `read` only comes back short at the end of the stream, so only the last
+    // block can be padded
+    in.read(input.data(), block_size);
+    auto size = static_cast<std::size_t>(in.gcount());
+    out.write(buffer.data(),
+              base64_encode_block(reinterpret_cast<const byte *>(input.data()),
+                                  size, buffer.data()));
+  }
+}
+
+util::Base64Encoder::Base64Encoder(std::ostream &out) : m_out{out} {
+  setp(m_input.data(), m_input.data() + m_input.size());
+}
+
+void util::Base64Encoder::finish() { encode(true); }
+
+util::Base64Encoder::int_type util::Base64Encoder::overflow(int_type c) {
+  encode(false);
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int util::Base64Encoder::sync() {
+  encode(false);
+  return 0;
+}
+
+void util::Base64Encoder::encode(const bool last) {
+  const auto size = static_cast<std::size_t>(pptr() - pbase());
+  // up to two bytes have to wait for the rest of their group
+  const std::size_t encoded = last ? size : size / 3 * 3;
+  base64_encode(std::string_view(pbase(), encoded), m_out);
+
+  const std::size_t rest = size - encoded;
+  if (encoded > 0) {
+    std::copy(pbase() + encoded, pptr(), m_input.data());
+  }
+  setp(m_input.data(), m_input.data() + m_input.size());
+  pbump(static_cast<int>(rest));
+}
+
 std::string util::base64_decode(const std::string &in) {
   std::string out;
   CryptoPP::Base64Decoder b(new CryptoPP::StringSink(out));
@@ -33,31 +161,170 @@ std::string util::base64_decode(const std::string &in) {
   return out;
 }
 
-std::string util::sha1(const std::string &in) {
-  byte out[CryptoPP::SHA1::DIGESTSIZE];
-  CryptoPP::SHA1().CalculateDigest(
-      out, reinterpret_cast<const byte *>(in.data()), in.size());
-  return std::string(reinterpret_cast<char *>(out), CryptoPP::SHA1::DIGESTSIZE);
+namespace {
+
+template <typename Hash> class CryptoppHasher final {
+public:
+  void update(std::string_view in) {
+    m_hash.Update(reinterpret_cast<const byte *>(in.data()), in.size());
+  }
+
+  std::string final() {
+    std::string result(Hash::DIGESTSIZE, '\0');
+    m_hash.Final(reinterpret_cast<byte *>(result.data()));
+    return result;
+  }
+
+private:
+  Hash m_hash;
+};
+
+#ifdef ODR_OPENSSL
+class OpensslHasher final {
+public:
+  explicit OpensslHasher(const EVP_MD *md) : m_context{EVP_MD_CTX_new()} {
+    if (m_context == nullptr ||
+        EVP_DigestInit_ex(m_context.get(), md, nullptr) != 1) {
+      throw std::runtime_error("openssl digest");
+    }
+  }
+
+  void update(std::string_view in) {
+    if (EVP_DigestUpdate(m_context.get(), in.data(), in.size()) != 1) {
+      throw std::runtime_error("openssl digest");
+    }
+  }
+
+  std::string final() {
+    std::string result(EVP_MAX_MD_SIZE, '\0');
+    unsigned int size = 0;
+    if (EVP_DigestFinal_ex(m_context.get(),
+                           reinterpret_cast<unsigned char *>(result.data()),
+                           &size) != 1) {
+      throw std::runtime_error("openssl digest");
+    }
+    result.resize(size);
+    return result;
+  }
+
+private:
+  struct Free {
+    void operator()(EVP_MD_CTX *context) const { EVP_MD_CTX_free(context); }
+  };
+
+  std::unique_ptr<EVP_MD_CTX, Free> m_context;
+};
+
+template <typename Hash> const EVP_MD *openssl_md();
+template <> const EVP_MD *openssl_md<CryptoPP::SHA1>() { return EVP_sha1(); }
+template <> const EVP_MD *openssl_md<CryptoPP::SHA256>() {
+  return EVP_sha256();
+}
+template <> const EVP_MD *openssl_md<CryptoPP::SHA512>() {
+  return EVP_sha512();
+}
+#endif
+
+template <typename Hasher>
+std::string hash_all(Hasher &&hasher, const std::string_view in) {
+  hasher.update(in);
+  return hasher.final();
+}
+
+template <typename Hasher>
+std::string hash_all(Hasher &&hasher, std::istream &in) {
+  std::array<char, 64 * 1024> buffer;
+  while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+    hasher.update(std::string_view(buffer.data(),
+                                   static_cast<std::size_t>(in.gcount())));
+  }
+  return hasher.final();
+}
+
+template <typename Hash, typename Input>
+std::string digest(const util::HashBackend backend, Input &in) {
+  switch (backend) {
+  case util::HashBackend::cryptopp:
+    return hash_all(CryptoppHasher<Hash>(), in);
+#ifdef ODR_OPENSSL
+  case util::HashBackend::openssl:
+    return hash_all(OpensslHasher(openssl_md<Hash>()), in);
+#endif
+  default:
+    throw std::invalid_argument("hash backend");
+  }
+}
+
+} // namespace
+
+bool util::available(const HashBackend backend) noexcept {
+  switch (backend) {
+  case HashBackend::cryptopp:
+    return true;
+  case HashBackend::openssl:
+#ifdef ODR_OPENSSL
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+util::HashBackend util::default_hash_backend() noexcept {
+#ifdef ODR_OPENSSL
+  return HashBackend::openssl;
+#else
+  return HashBackend::cryptopp;
+#endif
+}
+
+std::string util::sha1(std::string_view in, const HashBackend backend) {
+  return digest<CryptoPP::SHA1>(backend, in);
+}
+
+std::string util::sha256(std::string_view in, const HashBackend backend) {
+  return digest<CryptoPP::SHA256>(backend, in);
 }
 
-std::string util::sha256(const std::string &in) {
-  byte out[CryptoPP::SHA256::DIGESTSIZE];
-  CryptoPP::SHA256().CalculateDigest(
-      out, reinterpret_cast<const byte *>(in.data()), in.size());
-  return std::string(reinterpret_cast<char *>(out),
-                     CryptoPP::SHA256::DIGESTSIZE);
+std::string util::sha256(std::istream &in, const HashBackend backend) {
+  return digest<CryptoPP::SHA256>(backend, in);
+}
+
+std::string util::sha512(std::string_view in, const HashBackend backend) {
+  return digest<CryptoPP::SHA512>(backend, in);
 }
 
 std::string util::pbkdf2(std::size_t key_size, const std::string &start_key,
-                         const std::string &salt, std::size_t iteration_count) {
+                         const std::string &salt, std::size_t iteration_count,
+                         const HashBackend backend) {
   std::string result(key_size, '\0');
-  CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA1> pbkdf2;
-  pbkdf2.DeriveKey(reinterpret_cast<byte *>(result.data()), result.size(),
-                   false, reinterpret_cast<const byte *>(start_key.data()),
-                   start_key.size(),
-                   reinterpret_cast<const byte *>(salt.data()), salt.size(),
-                   iteration_count);
-  return result;
+  switch (backend) {
+  case HashBackend::cryptopp: {
+    CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA1> pbkdf2;
+    pbkdf2.DeriveKey(reinterpret_cast<byte *>(result.data()), result.size(),
+                     false, reinterpret_cast<const byte *>(start_key.data()),
+                     start_key.size(),
+                     reinterpret_cast<const byte *>(salt.data()), salt.size(),
+                     iteration_count);
+    return result;
+  }
+#ifdef ODR_OPENSSL
+  case HashBackend::openssl:
+    if (PKCS5_PBKDF2_HMAC(start_key.data(), static_cast<int>(start_key.size()),
+                          reinterpret_cast<const unsigned char *>(salt.data()),
+                          static_cast<int>(salt.size()),
+                          static_cast<int>(iteration_count), EVP_sha1(),
+                          static_cast<int>(result.size()),
+                          reinterpret_cast<unsigned char *>(result.data())) !=
+        1) {
+      throw std::runtime_error("openssl pbkdf2");
+    }
+    return result;
+#endif
+  default:
+    throw std::invalid_argument("hash backend");
+  }
 }
 
 std::string util::decrypt_AES(const std::string &key,
@@ -71,6 +338,15 @@ std::string util::decrypt_AES(const std::string &key,
   return result;
 }
 
+void util::decrypt_AES(const std::string &key, std::string_view input,
+                       char *output) {
+  CryptoPP::ECB_Mode<CryptoPP::AES>::Decryption decryption;
+  decryption.SetKey(reinterpret_cast<const byte *>(key.data()), key.size());
+  decryption.ProcessData(reinterpret_cast<byte *>(output),
+                         reinterpret_cast<const byte *>(input.data()),
+                         input.size());
+}
+
 std::string util::decrypt_AES(const std::string &key, const std::string &iv,
                               const std::string &input) {
   std::string result(input.size(), '\0');
@@ -84,6 +360,17 @@ std::string util::decrypt_AES(const std::string &key, const std::string &iv,
   return result;
 }
 
+void util::decrypt_AES(const std::string &key, const std::string &iv,
+                       std::string_view input, char *output) {
+  CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption decryption;
+  decryption.SetKeyWithIV(reinterpret_cast<const byte *>(key.data()),
+                          key.size(), reinterpret_cast<const byte *>(iv.data()),
+                          iv.size());
+  decryption.ProcessData(reinterpret_cast<byte *>(output),
+                         reinterpret_cast<const byte *>(input.data()),
+                         input.size());
+}
+
 std::string util::decrypt_TripleDES(const std::string &key,
                                     const std::string &iv,
                                     const std::string &input) {
@@ -112,6 +399,46 @@ std::string util::decrypt_Blowfish(const std::string &key,
   return result;
 }
 
+namespace {
+template <typename Mode>
+class CryptoppDecryptor final : public util::Decryptor {
+public:
+  CryptoppDecryptor(const std::string &key, const std::string &iv) {
+    m_decryption.SetKeyWithIV(reinterpret_cast<const byte *>(key.data()),
+                              key.size(),
+                              reinterpret_cast<const byte *>(iv.data()),
+                              iv.size());
+  }
+
+  void decrypt(std::string_view input, char *output) final {
+    m_decryption.ProcessData(reinterpret_cast<byte *>(output),
+                             reinterpret_cast<const byte *>(input.data()),
+                             input.size());
+  }
+
+private:
+  typename Mode::Decryption m_decryption;
+};
+} // namespace
+
+std::unique_ptr<util::Decryptor> util::AES_decryptor(const std::string &key,
+                                                     const std::string &iv) {
+  return std::make_unique<CryptoppDecryptor<CryptoPP::CBC_Mode<CryptoPP::AES>>>(
+      key, iv);
+}
+
+std::unique_ptr<util::Decryptor>
+util::TripleDES_decryptor(const std::string &key, const std::string &iv) {
+  return std::make_unique<
+      CryptoppDecryptor<CryptoPP::CBC_Mode<CryptoPP::DES_EDE3>>>(key, iv);
+}
+
+std::unique_ptr<util::Decryptor>
+util::Blowfish_decryptor(const std::string &key, const std::string &iv) {
+  return std::make_unique<
+      CryptoppDecryptor<CryptoPP::CFB_Mode<CryptoPP::Blowfish>>>(key, iv);
+}
+
 namespace {
 /// discard non deflated content caused by padding
 class MyInflator final : public CryptoPP::Inflator {
@@ -130,29 +457,194 @@ protected:
 private:
   std::uint32_t m_padding{0};
 };
+
+constexpr int raw_window_bits = -15;
+constexpr int zlib_window_bits = 15;
+
+struct Miniz {
+  using Stream = mz_stream;
+  static constexpr int ok = MZ_OK;
+  static constexpr int stream_end = MZ_STREAM_END;
+  static constexpr int buf_error = MZ_BUF_ERROR;
+
+  static int init(Stream *stream, int window_bits) {
+    return mz_inflateInit2(stream, window_bits);
+  }
+  static int process(Stream *stream) { return mz_inflate(stream, MZ_NO_FLUSH); }
+  static int end(Stream *stream) { return mz_inflateEnd(stream); }
+};
+
+#ifdef ODR_ZLIB_NG
+struct ZlibNg {
+  using Stream = zng_stream;
+  static constexpr int ok = Z_OK;
+  static constexpr int stream_end = Z_STREAM_END;
+  static constexpr int buf_error = Z_BUF_ERROR;
+
+  static int init(Stream *stream, int window_bits) {
+    return zng_inflateInit2(stream, window_bits);
+  }
+  static int process(Stream *stream) { return zng_inflate(stream, Z_NO_FLUSH); }
+  static int end(Stream *stream) { return zng_inflateEnd(stream); }
+};
+#endif
+
+/// `Inflater` on top of the zlib style API which miniz and zlib-ng share.
+template <typename Api> class ZlibStyleInflater final : public util::Inflater {
+public:
+  explicit ZlibStyleInflater(int window_bits) {
+    if (Api::init(&m_stream, window_bits) != Api::ok) {
+      throw std::runtime_error("cannot initialize inflate");
+    }
+  }
+  ZlibStyleInflater(const ZlibStyleInflater &) = delete;
+  ZlibStyleInflater &operator=(const ZlibStyleInflater &) = delete;
+  ~ZlibStyleInflater() final { Api::end(&m_stream); }
+
+  std::size_t inflate(std::string_view &input, char *output,
+                      std::size_t size) final {
+    // the stream counts in 32 bit
+    constexpr std::size_t max_size = std::numeric_limits<std::uint32_t>::max();
+
+    std::size_t written = 0;
+    while (!m_finished && written < size) {
+      const auto available_in = std::min(input.size(), max_size);
+      const auto available_out = std::min(size - written, max_size);
+      m_stream.next_in = reinterpret_cast<const byte *>(input.data());
+      m_stream.avail_in = static_cast<std::uint32_t>(available_in);
+      m_stream.next_out = reinterpret_cast<byte *>(output + written);
+      m_stream.avail_out = static_cast<std::uint32_t>(available_out);
+
+      const int status = Api::process(&m_stream);
+      const std::size_t consumed = available_in - m_stream.avail_in;
+      const std::size_t produced = available_out - m_stream.avail_out;
+      input.remove_prefix(consumed);
+      written += produced;
+
+      if (status == Api::stream_end) {
+        m_finished = true;
+      } else if (status == Api::buf_error ||
+                 (consumed == 0 && produced == 0)) {
+        break;
+      } else if (status != Api::ok) {
+        throw std::runtime_error("inflate failed");
+      }
+    }
+    return written;
+  }
+
+  [[nodiscard]] bool finished() const final { return m_finished; }
+
+private:
+  typename Api::Stream m_stream{};
+  bool m_finished{false};
+};
+
+std::unique_ptr<util::Inflater> make_inflater(util::InflateBackend backend,
+                                              int window_bits) {
+  switch (backend) {
+  case util::InflateBackend::miniz:
+    return std::make_unique<ZlibStyleInflater<Miniz>>(window_bits);
+#ifdef ODR_ZLIB_NG
+  case util::InflateBackend::zlib_ng:
+    return std::make_unique<ZlibStyleInflater<ZlibNg>>(window_bits);
+#endif
+  default:
+    throw std::invalid_argument("inflate backend");
+  }
+}
+
+/// Inflates all of `input` to the end of `output`, growing it as needed, and
+/// leaves whatever follows the deflate stream in `input`.
+void inflate_all(util::Inflater &inflater, std::string_view &input,
+                 std::string &output) {
+  std::size_t written = output.size();
+  output.resize(written + std::max<std::size_t>(4 * input.size(), 4096));
+  while (true) {
+    written += inflater.inflate(input, output.data() + written,
+                                output.size() - written);
+    if (inflater.finished()) {
+      break;
+    }
+    if (written < output.size()) {
+      throw std::runtime_error("deflate stream cut off");
+    }
+    output.resize(2 * output.size());
+  }
+  output.resize(written);
+}
 } // namespace
 
+bool util::available(const InflateBackend backend) noexcept {
+  switch (backend) {
+  case InflateBackend::cryptopp:
+  case InflateBackend::miniz:
+    return true;
+  case InflateBackend::zlib_ng:
+#ifdef ODR_ZLIB_NG
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+util::InflateBackend util::default_inflate_backend() noexcept {
+#ifdef ODR_ZLIB_NG
+  return InflateBackend::zlib_ng;
+#else
+  return InflateBackend::miniz;
+#endif
+}
+
 std::string util::inflate(const std::string &input) {
   std::string result;
-  MyInflator inflator(new CryptoPP::StringSink(result));
-  inflator.Put(reinterpret_cast<const byte *>(input.data()), input.size());
-  inflator.MessageEnd();
+  inflate(input, result);
   return result;
 }
 
+std::size_t util::inflate(std::string_view input, std::string &output,
+                          const InflateBackend backend) {
+  if (backend == InflateBackend::cryptopp) {
+    MyInflator inflator(new CryptoPP::StringSink(output));
+    inflator.Put(reinterpret_cast<const byte *>(input.data()), input.size());
+    inflator.MessageEnd();
+    return inflator.GetPadding();
+  }
+  inflate_all(*inflater(backend), input, output);
+  return input.size();
+}
+
 std::size_t util::padding(const std::string &input) {
-  MyInflator inflator;
-  inflator.Put(reinterpret_cast<const byte *>(input.data()), input.size());
-  inflator.MessageEnd();
-  return inflator.GetPadding();
+  std::string output;
+  return inflate(input, output);
 }
 
-std::string util::zlib_inflate(const std::string &input) {
+std::unique_ptr<util::Inflater> util::inflater(const InflateBackend backend) {
+  return make_inflater(backend, raw_window_bits);
+}
+
+std::unique_ptr<util::Inflater>
+util::zlib_inflater(const InflateBackend backend) {
+  return make_inflater(backend, zlib_window_bits);
+}
+
+std::string util::zlib_inflate(std::string_view input) {
   std::string result;
-  CryptoPP::ZlibDecompressor inflator(new CryptoPP::StringSink(result));
-  inflator.Put(reinterpret_cast<const byte *>(input.data()), input.size());
-  inflator.MessageEnd();
+  zlib_inflate(input, result);
   return result;
 }
 
+void util::zlib_inflate(std::string_view input, std::string &output,
+                        const InflateBackend backend) {
+  if (backend == InflateBackend::cryptopp) {
+    CryptoPP::ZlibDecompressor inflator(new CryptoPP::StringSink(output));
+    inflator.Put(reinterpret_cast<const byte *>(input.data()), input.size());
+    inflator.MessageEnd();
+    return;
+  }
+  inflate_all(*zlib_inflater(backend), input, output);
+}
+
 } // namespace odr::internal::crypto
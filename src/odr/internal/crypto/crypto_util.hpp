@@ -1,35 +1,141 @@
 #ifndef ODR_INTERNAL_CRYPTO_UTIL_HPP
 #define ODR_INTERNAL_CRYPTO_UTIL_HPP
 
+#include <array>
+#include <cstddef>
 #include <iosfwd>
 #include <memory>
+#include <streambuf>
 #include <string>
+#include <string_view>
 
 namespace odr::internal::crypto {
 
 namespace util {
 
 std::string base64_encode(const std::string &);
+void base64_encode(std::string_view in, std::ostream &out);
+void base64_encode(std::istream &in, std::ostream &out);
 std::string base64_decode(const std::string &);
 
-std::string sha1(const std::string &);
-std::string sha256(const std::string &);
+/// Stream buffer which base64-encodes everything written through it into
+/// `out`, so that the input never has to be held as a whole. `finish` writes
+/// the padded rest; nothing may be written afterwards.
+class Base64Encoder final : public std::streambuf {
+public:
+  explicit Base64Encoder(std::ostream &out);
 
+  void finish();
+
+protected:
+  int_type overflow(int_type c) final;
+  int sync() final;
+
+private:
+  std::ostream &m_out;
+  // a multiple of 3 so that only the rest written by `finish` is padded
+  std::array<char, 3 * 4096> m_input{};
+
+  void encode(bool last);
+};
+
+/// Implementations of the hashes and of PBKDF2. Crypto++ is always built,
+/// OpenSSL with `ODR_OPENSSL`.
+enum class HashBackend { cryptopp, openssl };
+
+[[nodiscard]] bool available(HashBackend) noexcept;
+/// The fastest backend built in; used unless another one is asked for.
+[[nodiscard]] HashBackend default_hash_backend() noexcept;
+
+std::string sha1(std::string_view,
+                 HashBackend backend = default_hash_backend());
+std::string sha256(std::string_view,
+                   HashBackend backend = default_hash_backend());
+/// Hashes `in` a piece at a time up to its end.
+std::string sha256(std::istream &in,
+                   HashBackend backend = default_hash_backend());
+std::string sha512(std::string_view,
+                   HashBackend backend = default_hash_backend());
+
+/// PBKDF2 with HMAC-SHA1.
 std::string pbkdf2(std::size_t key_size, const std::string &start_key,
-                   const std::string &salt, std::size_t iteration_count);
+                   const std::string &salt, std::size_t iteration_count,
+                   HashBackend backend = default_hash_backend());
 
 std::string decrypt_AES(const std::string &key, const std::string &input);
+/// ECB without padding; writes `input.size()` bytes to `output`.
+void decrypt_AES(const std::string &key, std::string_view input, char *output);
 std::string decrypt_AES(const std::string &key, const std::string &iv,
                         const std::string &input);
+/// CBC without padding; writes `input.size()` bytes to `output`.
+void decrypt_AES(const std::string &key, const std::string &iv,
+                 std::string_view input, char *output);
 std::string decrypt_TripleDES(const std::string &key, const std::string &iv,
                               const std::string &input);
 std::string decrypt_Blowfish(const std::string &key, const std::string &iv,
                              const std::string &input);
 
+/// Implementations of inflate. miniz is always built, zlib-ng with
+/// `ODR_ZLIB_NG`. Crypto++ only inflates in one piece and is kept for
+/// comparison.
+enum class InflateBackend { cryptopp, miniz, zlib_ng };
+
+[[nodiscard]] bool available(InflateBackend) noexcept;
+/// The fastest backend built in; used unless another one is asked for.
+[[nodiscard]] InflateBackend default_inflate_backend() noexcept;
+
 std::string inflate(const std::string &input);
+/// Raw inflate of `input` appended to `output`. Anything after the final
+/// deflate block is ignored; returns its size.
+std::size_t inflate(std::string_view input, std::string &output,
+                    InflateBackend backend = default_inflate_backend());
 std::size_t padding(const std::string &input);
 
-std::string zlib_inflate(const std::string &input);
+/// Decryption of a stream in pieces; the chaining state carries over from
+/// one call to the next.
+class Decryptor {
+public:
+  virtual ~Decryptor() = default;
+
+  /// Writes `input.size()` bytes to `output`. Except for the last piece the
+  /// size has to be a multiple of the block size.
+  virtual void decrypt(std::string_view input, char *output) = 0;
+};
+
+std::unique_ptr<Decryptor> AES_decryptor(const std::string &key,
+                                         const std::string &iv);
+std::unique_ptr<Decryptor> TripleDES_decryptor(const std::string &key,
+                                               const std::string &iv);
+std::unique_ptr<Decryptor> Blowfish_decryptor(const std::string &key,
+                                              const std::string &iv);
+
+/// Inflate of a stream in pieces into buffers of the caller.
+class Inflater {
+public:
+  virtual ~Inflater() = default;
+
+  /// Inflates from the front of `input` into the `size` bytes at `output`
+  /// and drops the consumed bytes from `input`. Returns the number of bytes
+  /// written, which is less than `size` only if `input` is used up or the
+  /// stream ended. Whatever follows the end of the stream stays in `input`.
+  virtual std::size_t inflate(std::string_view &input, char *output,
+                              std::size_t size) = 0;
+
+  /// True once the end of the deflate stream was reached.
+  [[nodiscard]] virtual bool finished() const = 0;
+};
+
+/// Raw deflate as used by ZIP and encrypted ODF parts.
+std::unique_ptr<Inflater>
+inflater(InflateBackend backend = default_inflate_backend());
+/// Deflate with zlib header as used by PDF streams.
+std::unique_ptr<Inflater>
+zlib_inflater(InflateBackend backend = default_inflate_backend());
+
+std::string zlib_inflate(std::string_view input);
+/// Appends to `output` so that callers can reuse its capacity.
+void zlib_inflate(std::string_view input, std::string &output,
+                  InflateBackend backend = default_inflate_backend());
 
 } // namespace util
 
@@ -3,15 +3,38 @@
 #include <odr/internal/abstract/file.hpp>
 #include <odr/internal/common/path.hpp>
 #include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/html/image_file.hpp>
 #include <odr/internal/util/stream_util.hpp>
 #include <odr/internal/util/string_util.hpp>
 
+#include <odr/file.hpp>
 #include <odr/html.hpp>
 
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace odr::internal::html {
+namespace {
+
+std::string hex(const std::string &bytes) {
+  static constexpr const char *digits = "0123456789abcdef";
+  std::string result;
+  result.reserve(bytes.size() * 2);
+  for (unsigned char c : bytes) {
+    result += digits[c >> 4];
+    result += digits[c & 0xf];
+  }
+  return result;
+}
+
+} // namespace
+} // namespace odr::internal::html
 
 namespace odr::internal {
 
@@ -59,20 +82,80 @@ std::string html::file_to_url(const abstract::File &file,
   return file_to_url(*file.stream(), mimeType);
 }
 
+void html::file_to_url(std::string_view file, const std::string &mimeType,
+                       std::ostream &out) {
+  out << "data:" << mimeType << ";base64,";
+  crypto::util::base64_encode(file, out);
+}
+
+void html::file_to_url(std::istream &file, const std::string &mimeType,
+                       std::ostream &out) {
+  out << "data:" << mimeType << ";base64,";
+  crypto::util::base64_encode(file, out);
+}
+
 HtmlResourceLocator html::local_resource_locator(const std::string &output_path,
                                                  const HtmlConfig &config) {
-  return [&](HtmlResourceType type, const std::string &name,
-             const std::string &path, const File &resource,
-             bool is_core_resource) -> HtmlResourceLocation {
-    (void)type;
+  // shared by all copies of the locator so that every resource is written
+  // once per output, no matter how often it is referenced
+  struct Cache {
+    std::mutex mutex;
+    std::unordered_set<std::string> written_paths;
+    std::unordered_map<std::string, std::shared_future<std::string>>
+        image_locations;
+  };
+  auto cache = std::make_shared<Cache>();
+
+  return [&, cache](HtmlResourceType type, const std::string &name,
+                    const std::string &path, const File &resource,
+                    bool is_core_resource) -> HtmlResourceLocation {
     (void)name;
 
-    // TODO remove `!is_core_resource` check after supporting external resources
-    if (config.embed_resources || !is_core_resource) {
+    if (!is_core_resource) {
+      // embedded images are streamed into the `src` attribute by the caller
+      if (type != HtmlResourceType::image || config.embed_resources) {
+        return std::nullopt;
+      }
+
+      std::string hash = hex(crypto::util::sha256(*resource.stream()));
+
+      std::promise<std::string> promise;
+      {
+        std::unique_lock lock(cache->mutex);
+        if (auto it = cache->image_locations.find(hash);
+            it != std::end(cache->image_locations)) {
+          std::shared_future<std::string> location = it->second;
+          lock.unlock();
+          return location.get();
+        }
+        cache->image_locations.emplace(hash, promise.get_future().share());
+      }
+
+      // decoding and writing happen outside the lock; concurrent requests for
+      // the same image wait for the future above
+      try {
+        HtmlImage image(resource);
+        std::string location = "resources/" + hash;
+        if (image.mime_type() == "image/svg+xml") {
+          location += ".svg";
+        }
+        auto resource_path = common::Path(output_path).join(location);
+        std::filesystem::create_directories(resource_path.parent().path());
+        std::ofstream os(resource_path.path(), std::ios::binary);
+        image.write(os);
+        promise.set_value(location);
+        return location;
+      } catch (...) {
+        promise.set_exception(std::current_exception());
+        throw;
+      }
+    }
+
+    if (config.embed_resources) {
       return std::nullopt;
     }
 
-    if (is_core_resource && !config.external_resource_path.empty()) {
+    if (!config.external_resource_path.empty()) {
       auto resource_path =
           common::Path(config.external_resource_path).join(path);
       if (config.relative_resource_paths) {
@@ -83,10 +166,13 @@ HtmlResourceLocator html::local_resource_locator(const std::string &output_path,
 
     // TODO relocate file if necessary
 
-    auto resource_path = common::Path(output_path).join(path);
-    std::filesystem::create_directories(resource_path.parent().path());
-    std::ofstream os(resource_path.path());
-    util::stream::pipe(*resource.stream(), os);
+    std::lock_guard lock(cache->mutex);
+    if (cache->written_paths.insert(path).second) {
+      auto resource_path = common::Path(output_path).join(path);
+      std::filesystem::create_directories(resource_path.parent().path());
+      std::ofstream os(resource_path.path());
+      util::stream::pipe(*resource.stream(), os);
+    }
     return path;
   };
 }
@@ -3,6 +3,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 
 #include <odr/html_service.hpp>
 #include <odr/internal/abstract/html_service.hpp>
@@ -27,6 +28,10 @@ std::string file_to_url(const std::string &file, const std::string &mimeType);
 std::string file_to_url(std::istream &file, const std::string &mimeType);
 std::string file_to_url(const abstract::File &file,
                         const std::string &mimeType);
+void file_to_url(std::string_view file, const std::string &mimeType,
+                 std::ostream &out);
+void file_to_url(std::istream &file, const std::string &mimeType,
+                 std::ostream &out);
 
 HtmlResourceLocator local_resource_locator(const std::string &output_path,
                                            const HtmlConfig &config);
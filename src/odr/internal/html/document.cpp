@@ -2,6 +2,7 @@
 
 #include <odr/document.hpp>
 #include <odr/document_element.hpp>
+#include <odr/document_path.hpp>
 #include <odr/exceptions.hpp>
 #include <odr/file.hpp>
 #include <odr/html.hpp>
@@ -9,6 +10,7 @@
 #include <odr/internal/abstract/file.hpp>
 #include <odr/internal/abstract/html_service.hpp>
 #include <odr/internal/common/path.hpp>
+#include <odr/internal/common/table_range.hpp>
 #include <odr/internal/html/common.hpp>
 #include <odr/internal/html/document_element.hpp>
 #include <odr/internal/html/document_style.hpp>
@@ -18,6 +20,7 @@
 #include <odr/internal/util/string_util.hpp>
 
 #include <fstream>
+#include <optional>
 #include <utility>
 
 namespace odr::internal::html {
@@ -185,6 +188,7 @@ public:
                       const HtmlResourceLocator &resourceLocator) const final {
     auto root = m_document.root_element();
     auto element = root.text_root();
+    DocumentPath path;
 
     if (config.text_document_margin) {
       auto page_layout = element.page_layout();
@@ -197,13 +201,15 @@ public:
                               HtmlElementOptions().set_style(
                                   translate_inner_page_style(page_layout)));
 
-      translate_children(element.children(), out, config, resourceLocator);
+      translate_children(element.children(), path, out, config,
+                         resourceLocator);
 
       out.write_element_end("div");
       out.write_element_end("div");
     } else {
       out.write_element_begin("div");
-      translate_children(element.children(), out, config, resourceLocator);
+      translate_children(element.children(), path, out, config,
+                         resourceLocator);
       out.write_element_end("div");
     }
   }
@@ -211,53 +217,72 @@ public:
 
 class SlideHtmlFragment final : public HtmlFragmentBase {
 public:
-  explicit SlideHtmlFragment(Document document, Slide slide)
-      : HtmlFragmentBase(std::move(document)), m_slide{slide} {}
+  SlideHtmlFragment(Document document, Slide slide, DocumentPath path)
+      : HtmlFragmentBase(std::move(document)), m_slide{slide},
+        m_path{std::move(path)} {}
 
   [[nodiscard]] std::string name() const final { return m_slide.name(); }
 
   void
   write_html_fragment(HtmlWriter &out, const HtmlConfig &config,
                       const HtmlResourceLocator &resourceLocator) const final {
-    internal::html::translate_slide(m_slide, out, config, resourceLocator);
+    DocumentPath path = m_path;
+    internal::html::translate_slide(m_slide, path, out, config,
+                                    resourceLocator);
   }
 
 private:
   Slide m_slide;
+  DocumentPath m_path;
 };
 
 class SheetHtmlFragment final : public HtmlFragmentBase {
 public:
-  explicit SheetHtmlFragment(Document document, Sheet sheet)
-      : HtmlFragmentBase(std::move(document)), m_sheet{sheet} {}
+  SheetHtmlFragment(Document document, Sheet sheet, DocumentPath path)
+      : HtmlFragmentBase(std::move(document)), m_sheet{sheet},
+        m_path{std::move(path)} {}
+  SheetHtmlFragment(Document document, Sheet sheet, DocumentPath path,
+                    common::TableRange range)
+      : HtmlFragmentBase(std::move(document)), m_sheet{sheet},
+        m_path{std::move(path)}, m_range{range} {}
 
   [[nodiscard]] std::string name() const final { return m_sheet.name(); }
 
   void
   write_html_fragment(HtmlWriter &out, const HtmlConfig &config,
                       const HtmlResourceLocator &resourceLocator) const final {
-    translate_sheet(m_sheet, out, config, resourceLocator);
+    DocumentPath path = m_path;
+    if (m_range) {
+      translate_sheet(m_sheet, *m_range, path, out, config, resourceLocator);
+    } else {
+      translate_sheet(m_sheet, path, out, config, resourceLocator);
+    }
   }
 
 private:
   Sheet m_sheet;
+  DocumentPath m_path;
+  std::optional<common::TableRange> m_range;
 };
 
 class PageHtmlFragment final : public HtmlFragmentBase {
 public:
-  explicit PageHtmlFragment(Document document, Page page)
-      : HtmlFragmentBase(std::move(document)), m_page{page} {}
+  PageHtmlFragment(Document document, Page page, DocumentPath path)
+      : HtmlFragmentBase(std::move(document)), m_page{page},
+        m_path{std::move(path)} {}
 
   [[nodiscard]] std::string name() const final { return m_page.name(); }
 
   void
   write_html_fragment(HtmlWriter &out, const HtmlConfig &config,
                       const HtmlResourceLocator &resourceLocator) const final {
-    internal::html::translate_page(m_page, out, config, resourceLocator);
+    DocumentPath path = m_path;
+    internal::html::translate_page(m_page, path, out, config, resourceLocator);
   }
 
 private:
   Page m_page;
+  DocumentPath m_path;
 };
 
 } // namespace
@@ -271,19 +296,25 @@ HtmlService html::translate_document(const Document &document) {
   if (document.document_type() == DocumentType::text) {
     fragments.push_back(std::make_unique<TextHtmlFragment>(document));
   } else if (document.document_type() == DocumentType::presentation) {
+    std::uint32_t index = 0;
     for (auto child : document.root_element().children()) {
-      fragments.push_back(
-          std::make_unique<SlideHtmlFragment>(document, child.slide()));
+      fragments.push_back(std::make_unique<SlideHtmlFragment>(
+          document, child.slide(), DocumentPath({DocumentPath::Child(index)})));
+      ++index;
     }
   } else if (document.document_type() == DocumentType::spreadsheet) {
+    std::uint32_t index = 0;
     for (auto child : document.root_element().children()) {
-      fragments.push_back(
-          std::make_unique<SheetHtmlFragment>(document, child.sheet()));
+      fragments.push_back(std::make_unique<SheetHtmlFragment>(
+          document, child.sheet(), DocumentPath({DocumentPath::Child(index)})));
+      ++index;
     }
   } else if (document.document_type() == DocumentType::drawing) {
+    std::uint32_t index = 0;
     for (auto child : document.root_element().children()) {
-      fragments.push_back(
-          std::make_unique<PageHtmlFragment>(document, child.page()));
+      fragments.push_back(std::make_unique<PageHtmlFragment>(
+          document, child.page(), DocumentPath({DocumentPath::Child(index)})));
+      ++index;
     }
   } else {
     throw UnknownDocumentType();
@@ -292,6 +323,13 @@ HtmlService html::translate_document(const Document &document) {
   return HtmlService(std::make_unique<StaticHtmlService>(document, fragments));
 }
 
+HtmlFragment html::translate_sheet(const Document &document,
+                                   const Sheet &sheet,
+                                   const common::TableRange &range) {
+  return HtmlFragment(std::make_shared<SheetHtmlFragment>(
+      document, sheet, DocumentPath::extract(sheet), range));
+}
+
 Html html::translate_document(const odr::Document &document,
                               const std::string &output_path,
                               const odr::HtmlConfig &config) {
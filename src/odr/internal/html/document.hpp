@@ -8,12 +8,21 @@ class Document;
 struct HtmlConfig;
 class Html;
 class HtmlService;
+class HtmlFragment;
+class Sheet;
 } // namespace odr
 
+namespace odr::internal::common {
+class TableRange;
+} // namespace odr::internal::common
+
 namespace odr::internal::html {
 
 HtmlService translate_document(const Document &document);
 
+HtmlFragment translate_sheet(const Document &document, const Sheet &sheet,
+                             const common::TableRange &range);
+
 Html translate_document(const Document &document,
                         const std::string &output_path,
                         const HtmlConfig &config);
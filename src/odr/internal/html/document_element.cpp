@@ -4,7 +4,7 @@
 #include <odr/document_path.hpp>
 #include <odr/html.hpp>
 
-#include <odr/internal/common/table_cursor.hpp>
+#include <odr/internal/common/table_range.hpp>
 #include <odr/internal/html/common.hpp>
 #include <odr/internal/html/document_style.hpp>
 #include <odr/internal/html/html_writer.hpp>
@@ -12,62 +12,61 @@
 
 namespace odr::internal {
 
-void html::translate_children(ElementRange range, HtmlWriter &out,
-                              const HtmlConfig &config,
+void html::translate_children(ElementRange range, DocumentPath &path,
+                              HtmlWriter &out, const HtmlConfig &config,
                               const HtmlResourceLocator &resourceLocator) {
+  std::uint32_t index = 0;
   for (Element child : range) {
-    translate_element(child, out, config, resourceLocator);
+    path.push_back(DocumentPath::component_from_element(child, index));
+    translate_element(child, path, out, config, resourceLocator);
+    path.pop_back();
+    ++index;
   }
 }
 
-void html::translate_element(Element element, HtmlWriter &out,
-                             const HtmlConfig &config,
+void html::translate_element(Element element, DocumentPath &path,
+                             HtmlWriter &out, const HtmlConfig &config,
                              const HtmlResourceLocator &resourceLocator) {
   if (element.type() == ElementType::text) {
-    translate_text(element, out, config, resourceLocator);
+    translate_text(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::line_break) {
-    translate_line_break(element, out, config, resourceLocator);
+    translate_line_break(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::paragraph) {
-    translate_paragraph(element, out, config, resourceLocator);
+    translate_paragraph(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::span) {
-    translate_span(element, out, config, resourceLocator);
+    translate_span(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::link) {
-    translate_link(element, out, config, resourceLocator);
+    translate_link(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::bookmark) {
-    translate_bookmark(element, out, config, resourceLocator);
+    translate_bookmark(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::list) {
-    translate_list(element, out, config, resourceLocator);
+    translate_list(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::list_item) {
-    translate_list_item(element, out, config, resourceLocator);
+    translate_list_item(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::table) {
-    translate_table(element, out, config, resourceLocator);
+    translate_table(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::frame) {
-    translate_frame(element, out, config, resourceLocator);
+    translate_frame(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::image) {
-    translate_image(element, out, config, resourceLocator);
+    translate_image(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::rect) {
-    translate_rect(element, out, config, resourceLocator);
+    translate_rect(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::line) {
-    translate_line(element, out, config, resourceLocator);
+    translate_line(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::circle) {
-    translate_circle(element, out, config, resourceLocator);
+    translate_circle(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::custom_shape) {
-    translate_custom_shape(element, out, config, resourceLocator);
+    translate_custom_shape(element, path, out, config, resourceLocator);
   } else if (element.type() == ElementType::group) {
-    translate_children(element.children(), out, config, resourceLocator);
+    translate_children(element.children(), path, out, config, resourceLocator);
   } else {
     // TODO log
   }
 }
 
-void html::translate_sheet(Sheet sheet, HtmlWriter &out,
+void html::translate_sheet(Sheet sheet, DocumentPath &path, HtmlWriter &out,
                            const HtmlConfig &config,
                            const HtmlResourceLocator &resourceLocator) {
-  out.write_element_begin(
-      "table",
-      HtmlElementOptions().set_attributes(HtmlAttributesVector{
-          {"cellpadding", "0"}, {"border", "0"}, {"cellspacing", "0"}}));
-
   TableDimensions dimensions = sheet.dimensions();
   std::uint32_t end_column = dimensions.columns;
   std::uint32_t end_row = dimensions.rows;
@@ -83,10 +82,28 @@ void html::translate_sheet(Sheet sheet, HtmlWriter &out,
   end_column = std::max(1u, end_column);
   end_row = std::max(1u, end_row);
 
+  translate_sheet(sheet, common::TableRange({0, 0}, {end_column, end_row}),
+                  path, out, config, resourceLocator);
+}
+
+void html::translate_sheet(Sheet sheet, const common::TableRange &range,
+                           DocumentPath &path, HtmlWriter &out,
+                           const HtmlConfig &config,
+                           const HtmlResourceLocator &resourceLocator) {
+  const std::uint32_t begin_column = range.from().column();
+  const std::uint32_t begin_row = range.from().row();
+  const std::uint32_t end_column = range.to().column();
+  const std::uint32_t end_row = range.to().row();
+
+  out.write_element_begin(
+      "table",
+      HtmlElementOptions().set_attributes(HtmlAttributesVector{
+          {"cellpadding", "0"}, {"border", "0"}, {"cellspacing", "0"}}));
+
   out.write_element_begin(
       "col", HtmlElementOptions().set_close_type(HtmlCloseType::none));
 
-  for (std::uint32_t column_index = 0; column_index < end_column;
+  for (std::uint32_t column_index = begin_column; column_index < end_column;
        ++column_index) {
     SheetColumn table_column = sheet.column(column_index);
     TableColumnStyle table_column_style = table_column.style();
@@ -104,7 +121,7 @@ void html::translate_sheet(Sheet sheet, HtmlWriter &out,
                                       .set_close_type(HtmlCloseType::trailing)
                                       .set_style("width:30px;height:20px;"));
 
-    for (std::uint32_t column_index = 0; column_index < end_column;
+    for (std::uint32_t column_index = begin_column; column_index < end_column;
          ++column_index) {
       out.write_element_begin("td",
                               HtmlElementOptions().set_inline(true).set_style(
@@ -116,9 +133,7 @@ void html::translate_sheet(Sheet sheet, HtmlWriter &out,
     out.write_element_end("tr");
   }
 
-  common::TableCursor cursor;
-  for (std::uint32_t row_index = cursor.row(); row_index < end_row;
-       row_index = cursor.row()) {
+  for (std::uint32_t row_index = begin_row; row_index < end_row; ++row_index) {
     SheetRow table_row = sheet.row(row_index);
     TableRowStyle table_row_style = table_row.style();
 
@@ -138,10 +153,16 @@ void html::translate_sheet(Sheet sheet, HtmlWriter &out,
     out.write_raw(common::TablePosition::to_row_string(row_index));
     out.write_element_end("td");
 
-    for (std::uint32_t column_index = cursor.column();
-         column_index < end_column; column_index = cursor.column()) {
-      SheetCell cell = sheet.cell(column_index, row_index);
+    for (std::uint32_t column_index = begin_column; column_index < end_column;
+         ++column_index) {
+      SheetCell cell = sheet.anchor_cell(column_index, row_index);
 
+      // merged cells are clipped to the range and written once at the top
+      // left of their visible part
+      if ((column_index != std::max(cell.column(), begin_column)) ||
+          (row_index != std::max(cell.row(), begin_row))) {
+        continue;
+      }
       if (cell.is_covered()) {
         continue;
       }
@@ -152,6 +173,12 @@ void html::translate_sheet(Sheet sheet, HtmlWriter &out,
       TableDimensions cell_span = cell.span();
       ValueType cell_value_type = cell.value_type();
 
+      cell_span.columns =
+          std::min(cell.column() + cell_span.columns, end_column) -
+          column_index;
+      cell_span.rows =
+          std::min(cell.row() + cell_span.rows, end_row) - row_index;
+
       out.write_element_begin(
           "td",
           HtmlElementOptions()
@@ -170,26 +197,33 @@ void html::translate_sheet(Sheet sheet, HtmlWriter &out,
                 }
                 return std::nullopt;
               }()));
+      // shapes are positioned relative to A1; finding the tiles a shape
+      // overlaps would need the sizes of all rows and columns before them, so
+      // only the tile containing A1 draws them
       if ((column_index == 0) && (row_index == 0)) {
+        std::uint32_t shape_index = 0;
         for (Element shape : sheet.shapes()) {
-          translate_element(shape, out, config, resourceLocator);
+          path.push_back(DocumentPath::Child(shape_index));
+          translate_element(shape, path, out, config, resourceLocator);
+          path.pop_back();
+          ++shape_index;
         }
       }
-      translate_children(cell.children(), out, config, resourceLocator);
+      path.push_back(DocumentPath::Row(cell.row()));
+      path.push_back(DocumentPath::Column(cell.column()));
+      translate_children(cell.children(), path, out, config, resourceLocator);
+      path.pop_back();
+      path.pop_back();
       out.write_element_end("td");
-
-      cursor.add_cell(cell_span.columns, cell_span.rows);
     }
 
     out.write_element_end("tr");
-
-    cursor.add_row();
   }
 
   out.write_element_end("table");
 }
 
-void html::translate_slide(Slide slide, HtmlWriter &out,
+void html::translate_slide(Slide slide, DocumentPath &path, HtmlWriter &out,
                            const HtmlConfig &config,
                            const HtmlResourceLocator &resourceLocator) {
   out.write_element_begin("div",
@@ -199,14 +233,19 @@ void html::translate_slide(Slide slide, HtmlWriter &out,
                           HtmlElementOptions().set_style(
                               translate_inner_page_style(slide.page_layout())));
 
-  translate_master_page(slide.master_page(), out, config, resourceLocator);
-  translate_children(slide.children(), out, config, resourceLocator);
+  // master pages are not below the root, so their elements are addressed
+  // relative to the master page itself
+  DocumentPath master_page_path;
+  translate_master_page(slide.master_page(), master_page_path, out, config,
+                        resourceLocator);
+  translate_children(slide.children(), path, out, config, resourceLocator);
 
   out.write_element_end("div");
   out.write_element_end("div");
 }
 
-void html::translate_page(Page page, HtmlWriter &out, const HtmlConfig &config,
+void html::translate_page(Page page, DocumentPath &path, HtmlWriter &out,
+                          const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
   out.write_element_begin("div",
                           HtmlElementOptions().set_style(
@@ -214,23 +253,23 @@ void html::translate_page(Page page, HtmlWriter &out, const HtmlConfig &config,
   out.write_element_begin("div",
                           HtmlElementOptions().set_style(
                               translate_inner_page_style(page.page_layout())));
-  translate_master_page(page.master_page(), out, config, resourceLocator);
-  translate_children(page.children(), out, config, resourceLocator);
+  DocumentPath master_page_path;
+  translate_master_page(page.master_page(), master_page_path, out, config,
+                        resourceLocator);
+  translate_children(page.children(), path, out, config, resourceLocator);
   out.write_element_end("div");
   out.write_element_end("div");
 }
 
-void html::translate_master_page(MasterPage masterPage, HtmlWriter &out,
-                                 const HtmlConfig &config,
+void html::translate_master_page(MasterPage masterPage, DocumentPath &path,
+                                 HtmlWriter &out, const HtmlConfig &config,
                                  const HtmlResourceLocator &resourceLocator) {
-  for (Element child : masterPage.children()) {
-    // TODO filter placeholders
-    translate_element(child, out, config, resourceLocator);
-  }
+  // TODO filter placeholders
+  translate_children(masterPage.children(), path, out, config, resourceLocator);
 }
 
-void html::translate_text(const Element element, HtmlWriter &out,
-                          const HtmlConfig &config,
+void html::translate_text(const Element element, DocumentPath &path,
+                          HtmlWriter &out, const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
   (void)resourceLocator;
 
@@ -242,8 +281,7 @@ void html::translate_text(const Element element, HtmlWriter &out,
                  .set_attributes([&](const HtmlAttributeWriterCallback &clb) {
                    if (config.editable && element.is_editable()) {
                      clb("contenteditable", "true");
-                     clb("data-odr-path",
-                         DocumentPath::extract(element).to_string());
+                     clb("data-odr-path", path.to_string());
                    }
                  })
                  .set_style(translate_text_style(text.style())));
@@ -251,9 +289,10 @@ void html::translate_text(const Element element, HtmlWriter &out,
   out.write_element_end("x-s");
 }
 
-void html::translate_line_break(Element element, HtmlWriter &out,
-                                const HtmlConfig &config,
+void html::translate_line_break(Element element, DocumentPath &path,
+                                HtmlWriter &out, const HtmlConfig &config,
                                 const HtmlResourceLocator &resourceLocator) {
+  (void)path;
   (void)config;
   (void)resourceLocator;
 
@@ -267,8 +306,8 @@ void html::translate_line_break(Element element, HtmlWriter &out,
   out.write_element_end("x-s");
 }
 
-void html::translate_paragraph(Element element, HtmlWriter &out,
-                               const HtmlConfig &config,
+void html::translate_paragraph(Element element, DocumentPath &path,
+                               HtmlWriter &out, const HtmlConfig &config,
                                const HtmlResourceLocator &resourceLocator) {
   Paragraph paragraph = element.paragraph();
 
@@ -276,7 +315,7 @@ void html::translate_paragraph(Element element, HtmlWriter &out,
       "x-p",
       HtmlElementOptions().set_inline(true).set_style(
           "display:block;" + translate_paragraph_style(paragraph.style())));
-  translate_children(paragraph.children(), out, config, resourceLocator);
+  translate_children(paragraph.children(), path, out, config, resourceLocator);
   if (paragraph.first_child()) {
     // TODO if element is content (e.g. bookmark does not count)
 
@@ -295,7 +334,7 @@ void html::translate_paragraph(Element element, HtmlWriter &out,
   out.write_element_end("x-p");
 }
 
-void html::translate_span(Element element, HtmlWriter &out,
+void html::translate_span(Element element, DocumentPath &path, HtmlWriter &out,
                           const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
   Span span = element.span();
@@ -303,11 +342,11 @@ void html::translate_span(Element element, HtmlWriter &out,
   out.write_element_begin("x-s",
                           HtmlElementOptions().set_inline(true).set_style(
                               translate_text_style(span.style())));
-  translate_children(span.children(), out, config, resourceLocator);
+  translate_children(span.children(), path, out, config, resourceLocator);
   out.write_element_end("x-s");
 }
 
-void html::translate_link(Element element, HtmlWriter &out,
+void html::translate_link(Element element, DocumentPath &path, HtmlWriter &out,
                           const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
   Link link = element.link();
@@ -315,13 +354,14 @@ void html::translate_link(Element element, HtmlWriter &out,
   out.write_element_begin("a",
                           HtmlElementOptions().set_inline(true).set_attributes(
                               HtmlAttributesVector{{"href", link.href()}}));
-  translate_children(link.children(), out, config, resourceLocator);
+  translate_children(link.children(), path, out, config, resourceLocator);
   out.write_element_end("a");
 }
 
-void html::translate_bookmark(Element element, HtmlWriter &out,
-                              const HtmlConfig &config,
+void html::translate_bookmark(Element element, DocumentPath &path,
+                              HtmlWriter &out, const HtmlConfig &config,
                               const HtmlResourceLocator &resourceLocator) {
+  (void)path;
   (void)config;
   (void)resourceLocator;
 
@@ -333,26 +373,26 @@ void html::translate_bookmark(Element element, HtmlWriter &out,
   out.write_element_end("a");
 }
 
-void html::translate_list(Element element, HtmlWriter &out,
+void html::translate_list(Element element, DocumentPath &path, HtmlWriter &out,
                           const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
   out.write_element_begin("ul");
-  translate_children(element.children(), out, config, resourceLocator);
+  translate_children(element.children(), path, out, config, resourceLocator);
   out.write_element_end("ul");
 }
 
-void html::translate_list_item(Element element, HtmlWriter &out,
-                               const HtmlConfig &config,
+void html::translate_list_item(Element element, DocumentPath &path,
+                               HtmlWriter &out, const HtmlConfig &config,
                                const HtmlResourceLocator &resourceLocator) {
   ListItem list_item = element.list_item();
 
   out.write_element_begin("li", HtmlElementOptions().set_style(
                                     translate_text_style(list_item.style())));
-  translate_children(list_item.children(), out, config, resourceLocator);
+  translate_children(list_item.children(), path, out, config, resourceLocator);
   out.write_element_end("li");
 }
 
-void html::translate_table(Element element, HtmlWriter &out,
+void html::translate_table(Element element, DocumentPath &path, HtmlWriter &out,
                            const HtmlConfig &config,
                            const HtmlResourceLocator &resourceLocator) {
   Table table = element.table();
@@ -373,15 +413,19 @@ void html::translate_table(Element element, HtmlWriter &out,
                                            table_column.style())));
   }
 
+  std::uint32_t row_index = 0;
   for (Element row : table.rows()) {
     TableRow table_row = row.table_row();
+    path.push_back(DocumentPath::Row(row_index));
 
     out.write_element_begin("tr",
                             HtmlElementOptions().set_style(
                                 translate_table_row_style(table_row.style())));
 
+    std::uint32_t next_column_index = 0;
     for (Element cell : table_row.children()) {
       TableCell table_cell = cell.table_cell();
+      const std::uint32_t column_index = next_column_index++;
 
       if (table_cell.is_covered()) {
         continue;
@@ -402,20 +446,27 @@ void html::translate_table(Element element, HtmlWriter &out,
               })
               .set_style(translate_table_cell_style(table_cell.style())));
 
-      translate_children(cell.children(), out, config, resourceLocator);
+      path.push_back(DocumentPath::Column(column_index));
+      translate_children(cell.children(), path, out, config, resourceLocator);
+      path.pop_back();
 
       out.write_element_end("td");
     }
 
     out.write_element_end("tr");
+
+    path.pop_back();
+    ++row_index;
   }
 
   out.write_element_end("table");
 }
 
-void html::translate_image(Element element, HtmlWriter &out,
+void html::translate_image(Element element, DocumentPath &path, HtmlWriter &out,
                            const HtmlConfig &config,
                            const HtmlResourceLocator &resourceLocator) {
+  (void)path;
+
   Image image = element.image();
 
   HtmlResourceLocation resourceLocation;
@@ -443,7 +494,7 @@ void html::translate_image(Element element, HtmlWriter &out,
           .set_style("position:absolute;left:0;top:0;width:100%;height:100%"));
 }
 
-void html::translate_frame(Element element, HtmlWriter &out,
+void html::translate_frame(Element element, DocumentPath &path, HtmlWriter &out,
                            const HtmlConfig &config,
                            const HtmlResourceLocator &resourceLocator) {
   Frame frame = element.frame();
@@ -452,11 +503,11 @@ void html::translate_frame(Element element, HtmlWriter &out,
   out.write_element_begin(
       "div", HtmlElementOptions().set_style(translate_frame_properties(frame) +
                                             translate_drawing_style(style)));
-  translate_children(frame.children(), out, config, resourceLocator);
+  translate_children(frame.children(), path, out, config, resourceLocator);
   out.write_element_end("div");
 }
 
-void html::translate_rect(Element element, HtmlWriter &out,
+void html::translate_rect(Element element, DocumentPath &path, HtmlWriter &out,
                           const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
   Rect rect = element.rect();
@@ -465,16 +516,17 @@ void html::translate_rect(Element element, HtmlWriter &out,
   out.write_element_begin(
       "div", HtmlElementOptions().set_style(translate_rect_properties(rect) +
                                             translate_drawing_style(style)));
-  translate_children(rect.children(), out, config, resourceLocator);
+  translate_children(rect.children(), path, out, config, resourceLocator);
   out.write_new_line();
   out.write_raw(
       R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1" overflow="visible" preserveAspectRatio="none" style="z-index:-1;width:inherit;height:inherit;position:absolute;top:0;left:0;padding:inherit;"><rect x="0" y="0" width="100%" height="100%" /></svg>)");
   out.write_element_end("div");
 }
 
-void html::translate_line(Element element, HtmlWriter &out,
+void html::translate_line(Element element, DocumentPath &path, HtmlWriter &out,
                           const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator) {
+  (void)path;
   (void)config;
   (void)resourceLocator;
 
@@ -501,8 +553,8 @@ void html::translate_line(Element element, HtmlWriter &out,
   out.write_element_end("svg");
 }
 
-void html::translate_circle(Element element, HtmlWriter &out,
-                            const HtmlConfig &config,
+void html::translate_circle(Element element, DocumentPath &path,
+                            HtmlWriter &out, const HtmlConfig &config,
                             const HtmlResourceLocator &resourceLocator) {
   Circle circle = element.circle();
   GraphicStyle style = circle.style();
@@ -511,14 +563,14 @@ void html::translate_circle(Element element, HtmlWriter &out,
                                      translate_circle_properties(circle) +
                                      translate_drawing_style(style)));
   out.write_new_line();
-  translate_children(circle.children(), out, config, resourceLocator);
+  translate_children(circle.children(), path, out, config, resourceLocator);
   out.write_raw(
       R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1" overflow="visible" preserveAspectRatio="none" style="z-index:-1;width:inherit;height:inherit;position:absolute;top:0;left:0;padding:inherit;"><circle cx="50%" cy="50%" r="50%" /></svg>)");
   out.write_element_end("div");
 }
 
-void html::translate_custom_shape(Element element, HtmlWriter &out,
-                                  const HtmlConfig &config,
+void html::translate_custom_shape(Element element, DocumentPath &path,
+                                  HtmlWriter &out, const HtmlConfig &config,
                                   const HtmlResourceLocator &resourceLocator) {
   CustomShape custom_shape = element.custom_shape();
   GraphicStyle style = custom_shape.style();
@@ -527,7 +579,8 @@ void html::translate_custom_shape(Element element, HtmlWriter &out,
                           HtmlElementOptions().set_style(
                               translate_custom_shape_properties(custom_shape) +
                               translate_drawing_style(style)));
-  translate_children(custom_shape.children(), out, config, resourceLocator);
+  translate_children(custom_shape.children(), path, out, config,
+                     resourceLocator);
   // TODO draw shape in svg
   out.write_element_end("div");
 }
@@ -4,6 +4,7 @@
 #include <odr/html_service.hpp>
 
 namespace odr {
+class DocumentPath;
 class Element;
 class ElementRange;
 class MasterPage;
@@ -12,62 +13,82 @@ class Sheet;
 class Page;
 } // namespace odr
 
+namespace odr::internal::common {
+class TableRange;
+} // namespace odr::internal::common
+
 namespace odr::internal::html {
 class HtmlWriter;
 
-void translate_children(ElementRange range, HtmlWriter &out,
+void translate_children(ElementRange range, DocumentPath &path, HtmlWriter &out,
                         const HtmlConfig &config,
                         const HtmlResourceLocator &resourceLocator);
-void translate_element(Element element, HtmlWriter &out,
+void translate_element(Element element, DocumentPath &path, HtmlWriter &out,
                        const HtmlConfig &config,
                        const HtmlResourceLocator &resourceLocator);
 
-void translate_slide(Slide slide, HtmlWriter &out, const HtmlConfig &config,
+void translate_slide(Slide slide, DocumentPath &path, HtmlWriter &out,
+                     const HtmlConfig &config,
+                     const HtmlResourceLocator &resourceLocator);
+void translate_sheet(Sheet sheet, DocumentPath &path, HtmlWriter &out,
+                     const HtmlConfig &config,
                      const HtmlResourceLocator &resourceLocator);
-void translate_sheet(Sheet sheet, HtmlWriter &out, const HtmlConfig &config,
+void translate_sheet(Sheet sheet, const common::TableRange &range,
+                     DocumentPath &path, HtmlWriter &out,
+                     const HtmlConfig &config,
                      const HtmlResourceLocator &resourceLocator);
-void translate_page(Page page, HtmlWriter &out, const HtmlConfig &config,
+void translate_page(Page page, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
 
-void translate_master_page(MasterPage masterPage, HtmlWriter &out,
-                           const HtmlConfig &config,
+void translate_master_page(MasterPage masterPage, DocumentPath &path,
+                           HtmlWriter &out, const HtmlConfig &config,
                            const HtmlResourceLocator &resourceLocator);
 
-void translate_text(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_text(Element element, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
-void translate_line_break(Element element, HtmlWriter &out,
+void translate_line_break(Element element, DocumentPath &path, HtmlWriter &out,
                           const HtmlConfig &config,
                           const HtmlResourceLocator &resourceLocator);
-void translate_paragraph(Element element, HtmlWriter &out,
+void translate_paragraph(Element element, DocumentPath &path, HtmlWriter &out,
                          const HtmlConfig &config,
                          const HtmlResourceLocator &resourceLocator);
-void translate_span(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_span(Element element, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
-void translate_link(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_link(Element element, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
-void translate_bookmark(Element element, HtmlWriter &out,
+void translate_bookmark(Element element, DocumentPath &path, HtmlWriter &out,
                         const HtmlConfig &config,
                         const HtmlResourceLocator &resourceLocator);
-void translate_list(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_list(Element element, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
-void translate_list_item(Element element, HtmlWriter &out,
+void translate_list_item(Element element, DocumentPath &path, HtmlWriter &out,
                          const HtmlConfig &config,
                          const HtmlResourceLocator &resourceLocator);
-void translate_table(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_table(Element element, DocumentPath &path, HtmlWriter &out,
+                     const HtmlConfig &config,
                      const HtmlResourceLocator &resourceLocator);
-void translate_image(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_image(Element element, DocumentPath &path, HtmlWriter &out,
+                     const HtmlConfig &config,
                      const HtmlResourceLocator &resourceLocator);
-void translate_frame(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_frame(Element element, DocumentPath &path, HtmlWriter &out,
+                     const HtmlConfig &config,
                      const HtmlResourceLocator &resourceLocator);
-void translate_rect(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_rect(Element element, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
-void translate_line(Element element, HtmlWriter &out, const HtmlConfig &config,
+void translate_line(Element element, DocumentPath &path, HtmlWriter &out,
+                    const HtmlConfig &config,
                     const HtmlResourceLocator &resourceLocator);
-void translate_circle(Element element, HtmlWriter &out,
+void translate_circle(Element element, DocumentPath &path, HtmlWriter &out,
                       const HtmlConfig &config,
                       const HtmlResourceLocator &resourceLocator);
-void translate_custom_shape(Element element, HtmlWriter &out,
-                            const HtmlConfig &config,
+void translate_custom_shape(Element element, DocumentPath &path,
+                            HtmlWriter &out, const HtmlConfig &config,
                             const HtmlResourceLocator &resourceLocator);
 
 } // namespace odr::internal::html
@@ -79,7 +79,10 @@ Html html::translate_filesystem(FileType file_type,
 
         out.write_element_begin(
             "a", HtmlElementOptions().set_attributes(HtmlAttributesVector{
-                     {"href", file_to_url(*stream, "application/octet-stream")},
+                     {"href",
+                      [&](std::ostream &o) {
+                        file_to_url(*stream, "application/octet-stream", o);
+                      }},
                      {"download", file_path.basename()}}));
         out.write_raw("download");
         out.write_element_end("a");
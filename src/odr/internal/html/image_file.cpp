@@ -4,51 +4,64 @@
 #include <odr/file.hpp>
 #include <odr/html.hpp>
 
-#include <odr/internal/common/file.hpp>
+#include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/html/common.hpp>
 #include <odr/internal/html/html_writer.hpp>
 #include <odr/internal/svm/svm_file.hpp>
 #include <odr/internal/svm/svm_to_svg.hpp>
+#include <odr/internal/util/stream_util.hpp>
 
 #include <fstream>
-#include <sstream>
+#include <ostream>
 
 namespace odr::internal {
 
-void html::translate_image_src(const File &file, std::ostream &out,
-                               const HtmlConfig &config) {
+html::HtmlImage::HtmlImage(const File &file) : m_file{file.impl()} {
   try {
-    translate_image_src(DecodedFile(file).image_file(), out, config);
+    m_svm_file = std::make_shared<svm::SvmFile>(m_file);
   } catch (...) {
-    // TODO hacky - `image/jpg` works for all common image types in chrome
-    // TODO use stream
-    out << file_to_url(*file.stream(), "image/jpg");
+    // else we guess that it is a usual image
   }
 }
 
-void html::translate_image_src(const ImageFile &image_file, std::ostream &out,
-                               const HtmlConfig & /*config*/) {
-  // try svm
+std::string html::HtmlImage::mime_type() const {
+  if (m_svm_file != nullptr) {
+    return "image/svg+xml";
+  }
+  // TODO hacky - `image/jpg` works for all common image types in chrome
+  return "image/jpg";
+}
+
+void html::HtmlImage::write(std::ostream &out) const {
+  if (m_svm_file == nullptr) {
+    util::stream::pipe(*m_file->stream(), out);
+    return;
+  }
+
   try {
-    // TODO `image_file` is already an `SvmFile`
-    // TODO `impl()` might be a bit dirty
-    auto image_file_impl = image_file.file().impl();
-    // TODO memory file might not be necessary; other istreams didn't support
-    // `tellg`
-    svm::SvmFile svm_file(
-        std::make_shared<common::MemoryFile>(*image_file_impl));
-    std::ostringstream svg_out;
-    svm::Translator::svg(svm_file, svg_out);
-    // TODO use stream
-    out << file_to_url(svg_out.str(), "image/svg+xml");
+    svm::Translator::svg(*m_svm_file, out);
   } catch (...) {
-    // else we guess that it is a usual image
-    // TODO hacky - `image/jpg` works for all common image types in chrome
-    // TODO use stream
-    out << file_to_url(*image_file.stream(), "image/jpg");
+    // the header was fine, so keep what was drawn up to the broken action
+    out << "</svg>";
   }
 }
 
+void html::translate_image_src(const File &file, std::ostream &out,
+                               const HtmlConfig & /*config*/) {
+  HtmlImage image(file);
+  out << "data:" << image.mime_type() << ";base64,";
+  // encoded while it is written, so large images are never held as a whole
+  crypto::util::Base64Encoder encoder(out);
+  std::ostream encoded(&encoder);
+  image.write(encoded);
+  encoder.finish();
+}
+
+void html::translate_image_src(const ImageFile &image_file, std::ostream &out,
+                               const HtmlConfig &config) {
+  translate_image_src(image_file.file(), out, config);
+}
+
 Html html::translate_image_file(const ImageFile &image_file,
                                 const std::string &output_path,
                                 const HtmlConfig &config) {
@@ -1,6 +1,8 @@
 #ifndef ODR_INTERNAL_HTML_IMAGE_FILE_HPP
 #define ODR_INTERNAL_HTML_IMAGE_FILE_HPP
 
+#include <iosfwd>
+#include <memory>
 #include <string>
 
 namespace odr {
@@ -11,8 +13,32 @@ struct HtmlConfig;
 class Html;
 } // namespace odr
 
+namespace odr::internal::abstract {
+class File;
+} // namespace odr::internal::abstract
+
+namespace odr::internal::svm {
+class SvmFile;
+} // namespace odr::internal::svm
+
 namespace odr::internal::html {
 
+/// Image as it is put into HTML, either embedded or next to it. Metafiles are
+/// translated to SVG while they are written, anything else is copied as is.
+class HtmlImage final {
+public:
+  explicit HtmlImage(const File &file);
+
+  [[nodiscard]] std::string mime_type() const;
+
+  /// Writes the image to `out` a piece at a time.
+  void write(std::ostream &out) const;
+
+private:
+  std::shared_ptr<abstract::File> m_file;
+  std::shared_ptr<svm::SvmFile> m_svm_file;
+};
+
 void translate_image_src(const File &file, std::ostream &out,
                          const HtmlConfig &config);
 void translate_image_src(const ImageFile &image_file, std::ostream &out,
@@ -3,53 +3,89 @@
 #include <odr/exceptions.hpp>
 #include <odr/file.hpp>
 #include <odr/html.hpp>
+#include <odr/html_service.hpp>
 
+#include <odr/internal/abstract/html_service.hpp>
 #include <odr/internal/common/file.hpp>
-#include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/html/html_writer.hpp>
 #include <odr/internal/pdf/pdf_document.hpp>
 #include <odr/internal/pdf/pdf_document_element.hpp>
 #include <odr/internal/pdf/pdf_document_parser.hpp>
+#include <odr/internal/pdf/pdf_filter.hpp>
 #include <odr/internal/pdf/pdf_graphics_operator.hpp>
 #include <odr/internal/pdf/pdf_graphics_operator_parser.hpp>
 #include <odr/internal/pdf/pdf_graphics_state.hpp>
+#include <odr/internal/pdf/pdf_trace.hpp>
+#include <odr/internal/util/stream_util.hpp>
+#include <odr/internal/util/thread_util.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <utility>
 
-namespace odr::internal {
+namespace odr::internal::html {
+namespace {
 
-Html html::translate_pdf_file(const PdfFile &pdf_file,
-                              const std::string &output_path,
-                              const HtmlConfig &config) {
-  auto in = pdf_file.file().stream();
-  pdf::DocumentParser parser(*in);
-
-  std::unique_ptr<pdf::Document> document = parser.parse_document();
-
-  std::vector<pdf::Page *> ordered_pages;
-  std::function<void(pdf::Pages * pages)> recurse_pages =
-      [&](pdf::Pages *pages) {
-        for (pdf::Element *kid : pages->kids) {
-          if (auto p = dynamic_cast<pdf::Pages *>(kid); p != nullptr) {
-            recurse_pages(p);
-          } else if (auto page = dynamic_cast<pdf::Page *>(kid);
-                     page != nullptr) {
-            ordered_pages.push_back(page);
-          } else {
-            throw std::runtime_error("unhandled element");
-          }
-        }
-      };
-
-  recurse_pages(document->catalog->pages);
+/// Parsed document shared by all page fragments. The parser caches objects,
+/// pages and fonts as it goes, so lookups go through `mutex`; inflating and
+/// rendering the page content does not touch the parser and runs unlocked.
+struct PdfState {
+  File file;
+  std::string buffer;
+  std::unique_ptr<pdf::DocumentParser> parser;
+  std::unique_ptr<pdf::Document> document;
+  std::uint32_t page_count{};
+  std::mutex mutex;
 
-  auto output_file_path = output_path + "/document.html";
-  std::ofstream ostream(output_file_path);
-  if (!ostream.is_open()) {
-    throw FileWriteError();
+  explicit PdfState(File _file) : file{std::move(_file)} {
+    // parse straight out of memory if the file already is; otherwise read it
+    // once and parse the copy
+    std::string_view data;
+    if (const char *memory_data = file.memory_data(); memory_data != nullptr) {
+      data = std::string_view(memory_data, file.size());
+    } else {
+      buffer = util::stream::read(*file.stream());
+      data = buffer;
+    }
+    parser = std::make_unique<pdf::DocumentParser>(data);
+    document = parser->parse_document();
+    // pages are looked up when they are rendered; until then only the root
+    // `/Count` is known
+    page_count = parser->page_count(*document);
   }
-  HtmlWriter out(ostream, config.format_html, config.html_indent);
 
+  pdf::Page &page(std::uint32_t index) {
+    std::lock_guard lock(mutex);
+    return *parser->page(*document, index);
+  }
+
+  void read_page_contents(const pdf::Page &page, std::string &stream) {
+    std::vector<std::unique_ptr<pdf::ByteSource>> contents;
+    {
+      std::lock_guard lock(mutex);
+      for (const auto &content_reference : page.contents_reference) {
+        contents.push_back(
+            parser->open_object_stream(parser->read_object(content_reference)));
+      }
+    }
+    // the sources only view the file data which is never modified
+    for (const auto &content : contents) {
+      pdf::read_all(*content, stream);
+      // the streams of a page are joined as if separated by whitespace
+      stream += '\n';
+    }
+  }
+
+  pdf::Font *font(pdf::Page &page, const std::string &name) {
+    std::lock_guard lock(mutex);
+    return parser->font(*document, *page.resources, name);
+  }
+};
+
+void front(HtmlWriter &out) {
   out.write_begin();
   out.write_header_begin();
   out.write_header_charset("UTF-8");
@@ -60,94 +96,186 @@ Html html::translate_pdf_file(const PdfFile &pdf_file,
   out.write_header_end();
 
   out.write_body_begin();
+}
+
+void back(HtmlWriter &out) {
+  out.write_body_end();
+  out.write_end();
+}
+
+void translate_page(PdfState &pdf, pdf::Page &page, HtmlWriter &out) {
+  // const access so concurrent pages never insert into the shared objects
+  const pdf::Array &page_box =
+      std::as_const(page.object).as_dictionary()["MediaBox"].as_array();
+
+  out.write_element_begin(
+      "div", HtmlElementOptions().set_style([&](std::ostream &o) {
+        o << "position:relative;";
+        o << "width:" << page_box[2].as_real() / 72.0 << "in;";
+        o << "height:" << page_box[3].as_real() / 72.0 << "in;";
+      }));
+
+  std::string stream;
+  pdf.read_page_contents(page, stream);
+
+  pdf::GraphicsOperatorParser parser2(stream);
+  pdf::GraphicsState state;
+  pdf::GraphicsOperator op;
+  std::string unicode;
+  while (!parser2.at_end()) {
+    parser2.read_operator(op);
+    state.execute(op);
+
+    if (op.type == pdf::GraphicsOperatorType::text_next_line) {
+      double leading = state.current().text.leading;
+      double size = state.current().text.size;
 
-  for (pdf::Page *page : ordered_pages) {
-    pdf::Array page_box = page->object.as_dictionary()["MediaBox"].as_array();
-
-    out.write_element_begin(
-        "div", HtmlElementOptions().set_style([&](std::ostream &o) {
-          o << "position:relative;";
-          o << "width:" << page_box[2].as_real() / 72.0 << "in;";
-          o << "height:" << page_box[3].as_real() / 72.0 << "in;";
-        }));
-
-    std::string stream;
-    for (const auto &content_reference : page->contents_reference) {
-      pdf::IndirectObject page_contents_object =
-          parser.read_object(content_reference);
-      std::string page_content =
-          parser.read_object_stream(page_contents_object);
-      page_content = crypto::util::zlib_inflate(page_content);
-      stream += page_content;
+      state.current().text.offset[1] -= size + leading;
+    } else if (op.type == pdf::GraphicsOperatorType::show_text &&
+               !op.arguments.empty() && op.arguments[0].is_string()) {
+      const std::string &font_ref = state.current().text.font;
+      double size = state.current().text.size;
+
+      std::array<double, 2> offset = state.current().text.offset;
+
+      pdf::Font *font = pdf.font(page, font_ref);
+
+      const std::string &glyphs = op.arguments[0].as_string();
+      unicode.clear();
+      font->cmap->translate_string(glyphs, unicode);
+
+      out.write_element_begin(
+          "span", HtmlElementOptions().set_style([&](std::ostream &o) {
+            o << "position:absolute;";
+            o << "left:" << offset[0] / 72.0 << "in;";
+            o << "bottom:" << offset[1] / 72.0 << "in;";
+            o << "font-size:" << size << "pt;";
+          }));
+      out.write_raw(unicode);
+      out.write_element_end("span");
+    } else if (op.type ==
+                   pdf::GraphicsOperatorType::show_text_manual_spacing ||
+               op.type == pdf::GraphicsOperatorType::show_text_next_line ||
+               op.type ==
+                   pdf::GraphicsOperatorType::show_text_next_line_set_spacing) {
+      ODR_PDF_TRACE_EVENT(op.type, "text operator not implemented");
     }
+  }
 
-    std::istringstream ss(stream);
-    pdf::GraphicsOperatorParser parser2(ss);
-    pdf::GraphicsState state;
-    while (!ss.eof()) {
-      pdf::GraphicsOperator op = parser2.read_operator();
-      state.execute(op);
-
-      if (op.type == pdf::GraphicsOperatorType::text_next_line) {
-        double leading = state.current().text.leading;
-        double size = state.current().text.size;
-
-        state.current().text.offset[1] -= size + leading;
-      } else if (op.type == pdf::GraphicsOperatorType::show_text) {
-        const std::string &font_ref = state.current().text.font;
-        double size = state.current().text.size;
-
-        std::array<double, 2> offset = state.current().text.offset;
-
-        pdf::Font *font = page->resources->font.at(font_ref);
-
-        const std::string &glyphs = op.arguments[0].as_string();
-        std::string unicode = font->cmap.translate_string(glyphs);
-
-        if (unicode.find("Colored Line") != std::string::npos) {
-          std::cout << "hi" << std::endl;
-        }
-
-        out.write_element_begin(
-            "span", HtmlElementOptions().set_style([&](std::ostream &o) {
-              o << "position:absolute;";
-              o << "left:" << offset[0] / 72.0 << "in;";
-              o << "bottom:" << offset[1] / 72.0 << "in;";
-              o << "font-size:" << size << "pt;";
-            }));
-        out.write_raw(unicode);
-        out.write_element_end("span");
-      } else if (op.type ==
-                 pdf::GraphicsOperatorType::show_text_manual_spacing) {
-        const std::string &font_ref = state.current().text.font;
-        pdf::Font *font = page->resources->font.at(font_ref);
-        double size = state.current().text.size;
-
-        std::cout << font->object << std::endl;
-
-        for (const auto &element : op.arguments[0].as_array()) {
-          if (element.is_real()) {
-            std::cout << "spacing: " << element.as_real() << std::endl;
-          } else if (element.is_string()) {
-            const std::string &glyphs = element.as_string();
-            std::string unicode = font->cmap.translate_string(glyphs);
-            std::cout << "show text manual spacing: font=" << font
-                      << ", size=" << size << ", text=" << unicode << std::endl;
-          }
-        }
-      } else if (op.type == pdf::GraphicsOperatorType::show_text_next_line) {
-        std::cout << "TODO show_text_next_line" << std::endl;
-      } else if (op.type ==
-                 pdf::GraphicsOperatorType::show_text_next_line_set_spacing) {
-        std::cout << "TODO show_text_next_line_set_spacing" << std::endl;
-      }
+  out.write_element_end("div");
+}
+
+class PdfHtmlFragment final : public abstract::HtmlFragment {
+public:
+  PdfHtmlFragment(std::shared_ptr<PdfState> pdf, std::uint32_t index)
+      : m_pdf{std::move(pdf)}, m_index{index} {}
+
+  [[nodiscard]] std::string name() const final {
+    return "page" + std::to_string(m_index);
+  }
+
+  void write_html_fragment(HtmlWriter &out, const HtmlConfig &,
+                           const HtmlResourceLocator &) const final {
+    translate_page(*m_pdf, m_pdf->page(m_index), out);
+  }
+
+  void
+  write_html_document(HtmlWriter &out, const HtmlConfig &config,
+                      const HtmlResourceLocator &resourceLocator) const final {
+    front(out);
+    write_html_fragment(out, config, resourceLocator);
+    back(out);
+  }
+
+private:
+  std::shared_ptr<PdfState> m_pdf;
+  std::uint32_t m_index;
+};
+
+class PdfHtmlService final : public abstract::HtmlService {
+public:
+  explicit PdfHtmlService(std::shared_ptr<PdfState> pdf) {
+    for (std::uint32_t i = 0; i < pdf->page_count; ++i) {
+      m_fragments.push_back(std::make_shared<PdfHtmlFragment>(pdf, i));
     }
+  }
 
-    out.write_element_end("div");
+  [[nodiscard]] const std::vector<std::shared_ptr<abstract::HtmlFragment>> &
+  fragments() const final {
+    return m_fragments;
   }
 
-  out.write_body_end();
-  out.write_end();
+  void
+  write_html_document(HtmlWriter &out, const HtmlConfig &config,
+                      const HtmlResourceLocator &resourceLocator) const final {
+    front(out);
+    for (const auto &fragment : m_fragments) {
+      fragment->write_html_fragment(out, config, resourceLocator);
+    }
+    back(out);
+  }
+
+private:
+  std::vector<std::shared_ptr<abstract::HtmlFragment>> m_fragments;
+};
+
+/// Renders the pages on `thread_count` workers and writes them in order. Pages
+/// are rendered in batches, so only a few of them are buffered at a time.
+void translate_pages(PdfState &pdf, const HtmlConfig &config,
+                     std::uint32_t thread_count, HtmlWriter &out) {
+  const std::uint32_t batch_size = 4 * thread_count;
+  std::vector<std::string> results(batch_size);
+  for (std::uint32_t begin = 0; begin < pdf.page_count; begin += batch_size) {
+    std::uint32_t count = std::min(batch_size, pdf.page_count - begin);
+    util::thread::parallel_for(count, thread_count, [&](std::size_t index) {
+      std::ostringstream buffer;
+      // pages sit inside `<html><body>`
+      HtmlWriter page_out(buffer, config.format_html, config.html_indent, 1);
+      translate_page(pdf, pdf.page(begin + index), page_out);
+      results[index] = std::move(buffer).str();
+    });
+    for (std::uint32_t i = 0; i < count; ++i) {
+      out.out() << results[i];
+      results[i].clear();
+    }
+  }
+}
+
+} // namespace
+} // namespace odr::internal::html
+
+namespace odr::internal {
+
+HtmlService html::translate_pdf_file(const PdfFile &pdf_file) {
+  return HtmlService(std::make_shared<PdfHtmlService>(
+      std::make_shared<PdfState>(pdf_file.file())));
+}
+
+Html html::translate_pdf_file(const PdfFile &pdf_file,
+                              const std::string &output_path,
+                              const HtmlConfig &config) {
+  PdfState pdf(pdf_file.file());
+
+  std::uint32_t thread_count =
+      util::thread::thread_count(config.pdf_thread_count);
+  thread_count = std::min(thread_count, pdf.page_count);
+
+  auto output_file_path = output_path + "/document.html";
+  std::ofstream ostream(output_file_path);
+  if (!ostream.is_open()) {
+    throw FileWriteError();
+  }
+  HtmlWriter out(ostream, config.format_html, config.html_indent);
+
+  front(out);
+  if (thread_count <= 1) {
+    for (std::uint32_t i = 0; i < pdf.page_count; ++i) {
+      translate_page(pdf, pdf.page(i), out);
+    }
+  } else {
+    translate_pages(pdf, config, thread_count, out);
+  }
+  back(out);
 
   return {FileType::portable_document_format,
           config,
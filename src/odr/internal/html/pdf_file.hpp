@@ -1,5 +1,5 @@
-#ifndef ODR_INTERNAL_PDF_FILE_HPP
-#define ODR_INTERNAL_PDF_FILE_HPP
+#ifndef ODR_INTERNAL_HTML_PDF_FILE_HPP
+#define ODR_INTERNAL_HTML_PDF_FILE_HPP
 
 #include <string>
 
@@ -8,13 +8,16 @@ class PdfFile;
 
 struct HtmlConfig;
 class Html;
+class HtmlService;
 } // namespace odr
 
 namespace odr::internal::html {
 
+HtmlService translate_pdf_file(const PdfFile &pdf_file);
+
 Html translate_pdf_file(const PdfFile &pdf_file, const std::string &output_path,
                         const HtmlConfig &config);
 
 }
 
-#endif // ODR_INTERNAL_PDF_FILE_HPP
+#endif // ODR_INTERNAL_HTML_PDF_FILE_HPP
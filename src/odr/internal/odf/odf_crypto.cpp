@@ -1,15 +1,27 @@
 #include <odr/internal/odf/odf_crypto.hpp>
 
 #include <odr/exceptions.hpp>
+#include <odr/file.hpp>
 
 #include <odr/internal/abstract/file.hpp>
 #include <odr/internal/abstract/filesystem.hpp>
 #include <odr/internal/common/file.hpp>
 #include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/util/stream_util.hpp>
+#include <odr/internal/util/thread_util.hpp>
 
+#include <algorithm>
+#include <array>
+#include <istream>
+#include <list>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 namespace odr::internal::odf {
 
@@ -27,9 +39,9 @@ std::string hash(const std::string &input, const ChecksumType checksum_type) {
   case ChecksumType::SHA1:
     return crypto::util::sha1(input);
   case ChecksumType::SHA256_1K:
-    return crypto::util::sha256(input.substr(0, 1024));
+    return crypto::util::sha256(std::string_view(input).substr(0, 1024));
   case ChecksumType::SHA1_1K:
-    return crypto::util::sha1(input.substr(0, 1024));
+    return crypto::util::sha1(std::string_view(input).substr(0, 1024));
   default:
     throw std::invalid_argument("checksum type");
   }
@@ -83,54 +95,311 @@ bool validate_password(const Manifest::Entry &entry,
 }
 
 namespace {
-class DecryptedFilesystem final : public abstract::ReadableFilesystem {
-public:
-  DecryptedFilesystem(std::shared_ptr<abstract::ReadableFilesystem> parent,
-                      Manifest manifest, std::string start_key)
-      : m_parent(std::move(parent)), m_manifest(std::move(manifest)),
-        m_start_key(std::move(start_key)) {}
+/// Checksums of this type only cover the first kilobyte.
+bool partial_checksum(const ChecksumType checksum_type) {
+  return checksum_type == ChecksumType::SHA256_1K ||
+         checksum_type == ChecksumType::SHA1_1K;
+}
+
+constexpr std::size_t piece_size = DecryptedFile::piece_size;
 
-  [[nodiscard]] bool exists(const common::Path &path) const final {
-    return m_parent->exists(path);
+std::unique_ptr<crypto::util::Decryptor>
+decryptor(const Manifest::Entry &entry, const std::string &derived_key) {
+  switch (entry.algorithm) {
+  case AlgorithmType::AES256_CBC:
+    return crypto::util::AES_decryptor(derived_key,
+                                       entry.initialisation_vector);
+  case AlgorithmType::TRIPLE_DES_CBC:
+    return crypto::util::TripleDES_decryptor(derived_key,
+                                             entry.initialisation_vector);
+  case AlgorithmType::BLOWFISH_CFB:
+    return crypto::util::Blowfish_decryptor(derived_key,
+                                            entry.initialisation_vector);
+  default:
+    throw std::invalid_argument("algorithm");
   }
+}
+
+/// Decrypts and inflates a part piece by piece.
+class PartDecoder {
+public:
+  PartDecoder(const Manifest::Entry &entry, const std::string &derived_key)
+      : m_decryptor{decryptor(entry, derived_key)},
+        m_inflater{crypto::util::inflater()} {}
+
+  /// Appends the plaintext of `input` to `output`. Except for the last piece
+  /// `input` has to be a multiple of `piece_size`.
+  void decode(std::string_view input, std::string &output) {
+    m_decrypted.resize(input.size());
+    m_decryptor->decrypt(input, m_decrypted.data());
 
-  [[nodiscard]] bool is_file(const common::Path &path) const final {
-    return m_parent->is_file(path);
+    std::string_view decrypted = m_decrypted;
+    while (!m_inflater->finished()) {
+      // room for a typical compression ratio; `output` grows geometrically
+      const std::size_t offset = output.size();
+      const std::size_t space = 4 * piece_size;
+      output.resize(offset + space);
+      const std::size_t written =
+          m_inflater->inflate(decrypted, output.data() + offset, space);
+      output.resize(offset + written);
+      if (written < space) {
+        break;
+      }
+    }
   }
 
-  [[nodiscard]] bool is_directory(const common::Path &path) const final {
-    return m_parent->is_directory(path);
+  /// Throws if the ciphertext ended before the deflate stream.
+  void finish() const {
+    if (!m_inflater->finished()) {
+      throw std::runtime_error("deflate stream cut off");
+    }
   }
 
-  [[nodiscard]] std::unique_ptr<abstract::FileWalker>
-  file_walker(const common::Path &path) const final {
-    return m_parent->file_walker(path);
+  /// True once the rest of the ciphertext is padding.
+  [[nodiscard]] bool finished() const { return m_inflater->finished(); }
+
+private:
+  std::unique_ptr<crypto::util::Decryptor> m_decryptor;
+  std::unique_ptr<crypto::util::Inflater> m_inflater;
+  std::string m_decrypted;
+};
+
+std::string decode_part(const Manifest::Entry &entry,
+                        const std::string &derived_key,
+                        std::string_view input) {
+  PartDecoder decoder(entry, derived_key);
+  std::string result;
+  result.reserve(entry.size);
+  for (std::size_t offset = 0;
+       offset < input.size() && !decoder.finished(); offset += piece_size) {
+    decoder.decode(input.substr(offset, piece_size), result);
   }
+  decoder.finish();
+  return result;
+}
+
+class DecryptedBuffer final : public std::streambuf {
+public:
+  DecryptedBuffer(std::unique_ptr<std::istream> source,
+                  const Manifest::Entry &entry, const std::string &derived_key)
+      : m_source{std::move(source)}, m_decoder(entry, derived_key) {}
 
-  [[nodiscard]] std::shared_ptr<abstract::File>
-  open(const common::Path &path) const final {
-    const auto it = m_manifest.entries.find(path);
-    if (it == std::end(m_manifest.entries)) {
-      return m_parent->open(path);
+  int underflow() final {
+    m_output.clear();
+    while (m_output.empty() && !m_done) {
+      m_source->read(m_input.data(), m_input.size());
+      auto size = static_cast<std::size_t>(m_source->gcount());
+      m_decoder.decode({m_input.data(), size}, m_output);
+      if (size < m_input.size() || m_decoder.finished()) {
+        m_decoder.finish();
+        m_done = true;
+      }
     }
-    if (!can_decrypt(it->second)) {
-      throw UnsupportedCryptoAlgorithm();
+    if (m_output.empty()) {
+      return std::char_traits<char>::eof();
     }
-    // TODO stream
-    auto source = m_parent->open(path)->stream();
-    const std::string input = util::stream::read(*source);
-    std::string result = crypto::util::inflate(
-        derive_key_and_decrypt(it->second, m_start_key, input));
-    return std::make_shared<common::MemoryFile>(result);
+
+    setg(m_output.data(), m_output.data(), m_output.data() + m_output.size());
+
+    return std::char_traits<char>::to_int_type(*gptr());
   }
 
 private:
-  const std::shared_ptr<abstract::ReadableFilesystem> m_parent;
-  const Manifest m_manifest;
-  const std::string m_start_key;
+  std::unique_ptr<std::istream> m_source;
+  PartDecoder m_decoder;
+  std::array<char, piece_size> m_input;
+  std::string m_output;
+  bool m_done{false};
 };
+
+class DecryptedIstream final : public std::istream {
+public:
+  explicit DecryptedIstream(std::unique_ptr<DecryptedBuffer> sbuf)
+      : std::istream(sbuf.get()), m_sbuf{std::move(sbuf)} {}
+
+private:
+  std::unique_ptr<DecryptedBuffer> m_sbuf;
+};
+
 } // namespace
 
+DecryptedFile::DecryptedFile(std::shared_ptr<abstract::File> file,
+                             Manifest::Entry entry, std::string derived_key)
+    : m_file{std::move(file)}, m_entry{std::move(entry)},
+      m_derived_key{std::move(derived_key)} {}
+
+FileLocation DecryptedFile::location() const noexcept {
+  return m_file->location();
+}
+
+std::size_t DecryptedFile::size() const { return m_entry.size; }
+
+std::optional<common::Path> DecryptedFile::disk_path() const {
+  return std::nullopt;
+}
+
+const char *DecryptedFile::memory_data() const { return nullptr; }
+
+std::unique_ptr<std::istream> DecryptedFile::stream() const {
+  return std::make_unique<DecryptedIstream>(std::make_unique<DecryptedBuffer>(
+      m_file->stream(), m_entry, m_derived_key));
+}
+
+DecryptedFilesystem::DecryptedFilesystem(
+    std::shared_ptr<abstract::ReadableFilesystem> parent, Manifest manifest,
+    std::string start_key, const std::size_t cache_limit)
+    : m_parent(std::move(parent)), m_manifest(std::move(manifest)),
+      m_start_key(std::move(start_key)), m_cache_limit{cache_limit} {}
+
+bool DecryptedFilesystem::exists(const common::Path &path) const {
+  return m_parent->exists(path);
+}
+
+bool DecryptedFilesystem::is_file(const common::Path &path) const {
+  return m_parent->is_file(path);
+}
+
+bool DecryptedFilesystem::is_directory(const common::Path &path) const {
+  return m_parent->is_directory(path);
+}
+
+std::unique_ptr<abstract::FileWalker>
+DecryptedFilesystem::file_walker(const common::Path &path) const {
+  return m_parent->file_walker(path);
+}
+
+std::shared_ptr<abstract::File>
+DecryptedFilesystem::open(const common::Path &path) const {
+  const auto it = m_manifest.entries.find(path);
+  if (it == std::end(m_manifest.entries)) {
+    return m_parent->open(path);
+  }
+  if (!can_decrypt(it->second)) {
+    throw UnsupportedCryptoAlgorithm();
+  }
+  // only once a part is needed, so documents which are just probed do not
+  // pay for the rest
+  std::call_once(m_prefetch_once, [this] { prefetch(); });
+  if (auto file = cached(path)) {
+    return file;
+  }
+  return std::make_shared<DecryptedFile>(m_parent->open(path), it->second,
+                                         derived_key(it->second));
+}
+
+void DecryptedFilesystem::cache(
+    const common::Path &path, std::shared_ptr<common::MemoryFile> file) const {
+  const std::size_t size = file->size();
+  if (size > m_cache_limit) {
+    return;
+  }
+
+  std::lock_guard lock(m_mutex);
+  if (m_parts.find(path) != std::end(m_parts)) {
+    return;
+  }
+  while (m_cached_size + size > m_cache_limit) {
+    auto oldest = m_parts.find(m_age.back());
+    m_cached_size -= oldest->second.file->size();
+    m_parts.erase(oldest);
+    m_age.pop_back();
+  }
+  m_age.push_front(path);
+  m_parts.emplace(path, CachedPart{std::move(file), std::begin(m_age)});
+  m_cached_size += size;
+}
+
+std::shared_ptr<common::MemoryFile>
+DecryptedFilesystem::cached(const common::Path &path) const {
+  std::lock_guard lock(m_mutex);
+  const auto it = m_parts.find(path);
+  if (it == std::end(m_parts)) {
+    return nullptr;
+  }
+  m_age.splice(std::begin(m_age), m_age, it->second.age);
+  return it->second.file;
+}
+
+void DecryptedFilesystem::prefetch() const {
+  std::vector<const std::pair<const common::Path, Manifest::Entry> *> parts;
+  for (const auto &part : m_manifest.entries) {
+    if (can_decrypt(part.second) && !cached(part.first)) {
+      parts.push_back(&part);
+    }
+  }
+  std::sort(std::begin(parts), std::end(parts), [](auto a, auto b) {
+    return a->second.size < b->second.size;
+  });
+
+  // the ciphertexts are read sequentially since the parent is not safe to
+  // share between threads, then decrypted and inflated in parallel because
+  // every part has its own salt and therefore its own key derivation
+  std::size_t budget = m_cache_limit - cached_size();
+  std::vector<std::string> inputs;
+  for (auto part : parts) {
+    if (part->second.size > budget) {
+      break;
+    }
+    budget -= part->second.size;
+    try {
+      inputs.push_back(
+          util::stream::read(*m_parent->open(part->first)->stream()));
+    } catch (...) {
+      // left for `open` to report
+      inputs.emplace_back();
+    }
+  }
+
+  util::thread::parallel_for(
+      inputs.size(), util::thread::thread_count(0), [&](std::size_t i) {
+        if (inputs[i].empty()) {
+          return;
+        }
+        try {
+          cache(parts[i]->first, decrypt_part(parts[i]->second, inputs[i]));
+        } catch (...) {
+          // left for `open` to report
+        }
+        std::string().swap(inputs[i]);
+      });
+}
+
+std::size_t DecryptedFilesystem::derived_key_count() const {
+  std::lock_guard lock(m_mutex);
+  return m_derived_keys.size();
+}
+
+std::size_t DecryptedFilesystem::cached_size() const {
+  std::lock_guard lock(m_mutex);
+  return m_cached_size;
+}
+
+std::string
+DecryptedFilesystem::derived_key(const Manifest::Entry &entry) const {
+  KeyParameters parameters{entry.key_salt, entry.key_iteration_count,
+                           entry.key_size};
+  {
+    std::lock_guard lock(m_mutex);
+    const auto it = m_derived_keys.find(parameters);
+    if (it != std::end(m_derived_keys)) {
+      return it->second;
+    }
+  }
+  // derived outside of the lock so different salts derive in parallel
+  std::string result = crypto::util::pbkdf2(
+      entry.key_size, m_start_key, entry.key_salt, entry.key_iteration_count);
+  std::lock_guard lock(m_mutex);
+  m_derived_keys.emplace(std::move(parameters), result);
+  return result;
+}
+
+std::shared_ptr<common::MemoryFile>
+DecryptedFilesystem::decrypt_part(const Manifest::Entry &entry,
+                                  const std::string &input) const {
+  return std::make_shared<common::MemoryFile>(
+      decode_part(entry, derived_key(entry), input));
+}
+
 bool decrypt(std::shared_ptr<abstract::ReadableFilesystem> &storage,
              const Manifest &manifest, const std::string &password) {
   if (!manifest.encrypted) {
@@ -150,9 +419,46 @@ bool decrypt(std::shared_ptr<abstract::ReadableFilesystem> &storage,
   if (!validate_password(smallest_file_entry, decrypt)) {
     return false;
   }
-  storage = std::make_shared<DecryptedFilesystem>(std::move(storage), manifest,
-                                                  start_key);
+  auto decrypted = std::make_shared<DecryptedFilesystem>(
+      std::move(storage), manifest, start_key);
+  try {
+    std::string smallest_file = crypto::util::inflate(decrypt);
+    decrypted->cache(smallest_file_path, std::make_shared<common::MemoryFile>(
+                                             std::move(smallest_file)));
+  } catch (...) {
+    // left for `open` to report
+  }
+  storage = std::move(decrypted);
   return true;
 }
 
+std::optional<std::size_t>
+find_password(const abstract::ReadableFilesystem &storage,
+              const Manifest &manifest,
+              const std::vector<std::string> &passwords) {
+  auto &&entry = manifest.smallest_file_entry();
+  if (!can_decrypt(entry)) {
+    throw UnsupportedCryptoAlgorithm();
+  }
+  std::string input =
+      util::stream::read(*storage.open(manifest.smallest_file_path)->stream());
+  // the padding of the last block stays clear of the first kilobyte
+  const bool partial =
+      partial_checksum(entry.checksum_type) && input.size() >= 1024 + 16;
+  if (partial) {
+    input.resize(1024);
+  }
+
+  return util::thread::find_first(
+      passwords.size(), util::thread::thread_count(0),
+      [&](const std::size_t index) {
+        const std::string decrypted = derive_key_and_decrypt(
+            entry, start_key(entry, passwords[index]), input);
+        if (partial) {
+          return hash(decrypted, entry.checksum_type) == entry.checksum;
+        }
+        return validate_password(entry, decrypted);
+      });
+}
+
 } // namespace odr::internal::odf
@@ -1,16 +1,26 @@
 #ifndef ODR_INTERNAL_ODF_CRYPTO_HPP
 #define ODR_INTERNAL_ODF_CRYPTO_HPP
 
+#include <odr/internal/abstract/file.hpp>
+#include <odr/internal/abstract/filesystem.hpp>
 #include <odr/internal/odf/odf_manifest.hpp>
 #include <odr/internal/odf/odf_meta.hpp>
 
+#include <cstdint>
 #include <exception>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
-namespace odr::internal::abstract {
-class ReadableFilesystem;
-} // namespace odr::internal::abstract
+namespace odr::internal::common {
+class MemoryFile;
+} // namespace odr::internal::common
 
 namespace odr::internal::odf {
 
@@ -30,9 +40,102 @@ std::string derive_key_and_decrypt(const Manifest::Entry &,
 
 bool validate_password(const Manifest::Entry &, std::string decrypted) noexcept;
 
+/// Encrypted part which is decrypted and inflated while it is read, so only
+/// a few pieces are held in memory at a time.
+class DecryptedFile final : public abstract::File {
+public:
+  /// Pieces of ciphertext are decrypted at once; a multiple of every
+  /// supported block size.
+  static constexpr std::size_t piece_size = 16 * 1024;
+
+  DecryptedFile(std::shared_ptr<abstract::File> file, Manifest::Entry entry,
+                std::string derived_key);
+
+  [[nodiscard]] FileLocation location() const noexcept final;
+  [[nodiscard]] std::size_t size() const final;
+
+  [[nodiscard]] std::optional<common::Path> disk_path() const final;
+  [[nodiscard]] const char *memory_data() const final;
+
+  [[nodiscard]] std::unique_ptr<std::istream> stream() const final;
+
+private:
+  std::shared_ptr<abstract::File> m_file;
+  const Manifest::Entry m_entry;
+  const std::string m_derived_key;
+};
+
+/// Encrypted parts of `parent` as plaintext. Parts are streamed through a
+/// `DecryptedFile` unless they are in the cache, which is only filled by
+/// `cache` and `prefetch`. It is of bounded size and drops the least recently
+/// used part first.
+class DecryptedFilesystem final : public abstract::ReadableFilesystem {
+public:
+  static constexpr std::size_t default_cache_limit = 64 * 1024 * 1024;
+
+  DecryptedFilesystem(std::shared_ptr<abstract::ReadableFilesystem> parent,
+                      Manifest manifest, std::string start_key,
+                      std::size_t cache_limit = default_cache_limit);
+
+  [[nodiscard]] bool exists(const common::Path &path) const final;
+  [[nodiscard]] bool is_file(const common::Path &path) const final;
+  [[nodiscard]] bool is_directory(const common::Path &path) const final;
+
+  [[nodiscard]] std::unique_ptr<abstract::FileWalker>
+  file_walker(const common::Path &path) const final;
+
+  /// The first call of an encrypted part runs `prefetch`.
+  [[nodiscard]] std::shared_ptr<abstract::File>
+  open(const common::Path &path) const final;
+
+  void cache(const common::Path &path,
+             std::shared_ptr<common::MemoryFile> file) const;
+  [[nodiscard]] std::shared_ptr<common::MemoryFile>
+  cached(const common::Path &path) const;
+
+  /// Decrypts the encrypted parts smallest first, as many as fit into the
+  /// cache.
+  void prefetch() const;
+
+  [[nodiscard]] std::size_t derived_key_count() const;
+
+private:
+  struct CachedPart {
+    std::shared_ptr<common::MemoryFile> file;
+    std::list<common::Path>::iterator age;
+  };
+
+  using KeyParameters = std::tuple<std::string, std::uint64_t, std::uint64_t>;
+
+  const std::shared_ptr<abstract::ReadableFilesystem> m_parent;
+  const Manifest m_manifest;
+  const std::string m_start_key;
+  const std::size_t m_cache_limit;
+
+  mutable std::once_flag m_prefetch_once;
+  mutable std::mutex m_mutex;
+  mutable std::map<KeyParameters, std::string> m_derived_keys;
+  mutable std::unordered_map<common::Path, CachedPart> m_parts;
+  /// most recently used first
+  mutable std::list<common::Path> m_age;
+  mutable std::size_t m_cached_size{0};
+
+  std::size_t cached_size() const;
+  std::string derived_key(const Manifest::Entry &entry) const;
+  std::shared_ptr<common::MemoryFile>
+  decrypt_part(const Manifest::Entry &entry, const std::string &input) const;
+};
+
 bool decrypt(std::shared_ptr<abstract::ReadableFilesystem> &, const Manifest &,
              const std::string &password);
 
+/// Index of the first of `passwords` which matches the checksum of the
+/// smallest file. Only its first kilobyte is decrypted where the checksum
+/// allows, nothing is inflated.
+std::optional<std::size_t>
+find_password(const abstract::ReadableFilesystem &, const Manifest &,
+              const std::vector<std::string> &passwords);
+
 } // namespace odr::internal::odf
 
 #endif // ODR_INTERNAL_ODF_CRYPTO_HPP
@@ -69,6 +69,14 @@ bool OpenDocumentFile::decrypt(const std::string &password) {
   return true;
 }
 
+std::optional<std::size_t> OpenDocumentFile::find_password(
+    const std::vector<std::string> &passwords) const {
+  if (m_encryption_state != EncryptionState::encrypted) {
+    return std::nullopt; // TODO throw
+  }
+  return odf::find_password(*m_filesystem, m_manifest, passwords);
+}
+
 std::shared_ptr<abstract::Document> OpenDocumentFile::document() const {
   // TODO throw if encrypted
   switch (file_type()) {
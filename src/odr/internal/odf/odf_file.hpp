@@ -7,7 +7,9 @@
 #include <odr/internal/odf/odf_manifest.hpp>
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace odr::internal::abstract {
 class Document;
@@ -34,6 +36,8 @@ public:
   [[nodiscard]] bool password_encrypted() const noexcept final;
   [[nodiscard]] EncryptionState encryption_state() const noexcept final;
   bool decrypt(const std::string &password) final;
+  [[nodiscard]] std::optional<std::size_t>
+  find_password(const std::vector<std::string> &passwords) const final;
 
   [[nodiscard]] std::shared_ptr<abstract::Document> document() const final;
 
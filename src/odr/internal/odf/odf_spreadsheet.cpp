@@ -3,6 +3,7 @@
 #include <odr/internal/common/table_cursor.hpp>
 #include <odr/internal/util/map_util.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -187,6 +188,12 @@ abstract::SheetCell *Sheet::cell(const abstract::Document *,
   return nullptr;
 }
 
+std::pair<std::uint32_t, std::uint32_t>
+Sheet::anchor(const abstract::Document *, std::uint32_t column,
+              std::uint32_t row) const {
+  return m_index.merges.anchor(column, row);
+}
+
 abstract::Element *Sheet::first_shape(const abstract::Document *) const {
   return m_first_shape;
 }
@@ -243,6 +250,11 @@ void Sheet::init_cell_(std::uint32_t column, std::uint32_t row,
   m_index.init_cell(column, row, columns_repeated, rows_repeated, element);
 }
 
+void Sheet::init_merge_(std::uint32_t column, std::uint32_t row,
+                        TableDimensions span) {
+  m_index.merges.add(column, row, span);
+}
+
 void Sheet::init_cell_element_(std::uint32_t column, std::uint32_t row,
                                SheetCell *element) {
   m_cells[{column, row}] = element;
@@ -313,11 +325,24 @@ odf::parse_element_tree<odf::Sheet>(Document &document, pugi::xml_node node) {
       sheet.init_cell_(cursor.column(), cursor.row(), columns_repeated,
                        rows_repeated, cell_node);
 
+      // merged cells are kept even if empty so that their span is known
+      const bool merged = (colspan > 1) || (rowspan > 1);
       bool empty = false;
-      if (!cell_node.first_child()) {
+      if (!cell_node.first_child() && !merged) {
         empty = true;
       }
 
+      if (merged) {
+        for (std::uint32_t row_repeat = 0; row_repeat < rows_repeated;
+             ++row_repeat) {
+          for (std::uint32_t column_repeat = 0;
+               column_repeat < columns_repeated; ++column_repeat) {
+            sheet.init_merge_(cursor.column() + column_repeat * colspan,
+                              cursor.row() + row_repeat, {rowspan, colspan});
+          }
+        }
+      }
+
       if (!empty) {
         for (std::uint32_t row_repeat = 0; row_repeat < rows_repeated;
              ++row_repeat) {
@@ -4,6 +4,7 @@
 #include <odr/internal/abstract/document.hpp>
 #include <odr/internal/abstract/sheet_element.hpp>
 #include <odr/internal/common/style.hpp>
+#include <odr/internal/common/table_merges.hpp>
 #include <odr/internal/common/table_position.hpp>
 #include <odr/internal/odf/odf_element.hpp>
 #include <odr/internal/odf/odf_parser.hpp>
@@ -36,6 +37,8 @@ struct SheetIndex final {
   std::map<std::uint32_t, pugi::xml_node> columns;
   std::map<std::uint32_t, Row> rows;
 
+  common::TableMerges merges;
+
   void init_column(std::uint32_t column, std::uint32_t repeated,
                    pugi::xml_node element);
   void init_row(std::uint32_t row, std::uint32_t repeated,
@@ -64,6 +67,9 @@ public:
 
   abstract::SheetCell *cell(const abstract::Document *, std::uint32_t column,
                             std::uint32_t row) const final;
+  [[nodiscard]] std::pair<std::uint32_t, std::uint32_t>
+  anchor(const abstract::Document *, std::uint32_t column,
+         std::uint32_t row) const final;
 
   [[nodiscard]] abstract::Element *
   first_shape(const abstract::Document *) const final;
@@ -84,6 +90,8 @@ public:
   void init_cell_(std::uint32_t column, std::uint32_t row,
                   std::uint32_t columns_repeated, std::uint32_t rows_repeated,
                   pugi::xml_node element);
+  void init_merge_(std::uint32_t column, std::uint32_t row,
+                   TableDimensions span);
   void init_cell_element_(std::uint32_t column, std::uint32_t row,
                           SheetCell *element);
   void init_dimensions_(TableDimensions dimensions);
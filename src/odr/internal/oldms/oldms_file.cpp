@@ -82,6 +82,11 @@ bool LegacyMicrosoftFile::decrypt(const std::string &) {
   return false; // TODO throw
 }
 
+std::optional<std::size_t>
+LegacyMicrosoftFile::find_password(const std::vector<std::string> &) const {
+  return std::nullopt; // TODO throw
+}
+
 std::shared_ptr<abstract::Document> LegacyMicrosoftFile::document() const {
   return {}; // TODO throw
 }
@@ -4,11 +4,17 @@
 
 #include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/util/string_util.hpp>
+#include <odr/internal/util/thread_util.hpp>
+#include <odr/internal/util/xml_util.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
+#include <string_view>
 #include <utility>
 
+#include <pugixml.hpp>
+
 namespace {
 template <typename I, typename O> void to_little_endian(I in, O &out) {
   for (std::size_t i = 0; i < sizeof(in); ++i) {
@@ -125,13 +131,270 @@ bool ECMA376Standard::verify(const std::string &key) const noexcept {
   return hash == verifier_hash;
 }
 
-std::string ECMA376Standard::decrypt(const std::string &encrypted_package,
-                                     const std::string &key) const noexcept {
-  const std::uint64_t total_size =
-      *(reinterpret_cast<const std::uint64_t *>(encrypted_package.data()));
-  std::string result =
-      internal::crypto::util::decrypt_AES(key, encrypted_package.substr(8))
-          .substr(0, total_size);
+std::string ECMA376Standard::decrypt(std::string_view encrypted_package,
+                                     const std::string &key) const {
+  // https://msdn.microsoft.com/en-us/library/dd926426(v=office.12).aspx
+
+  std::uint64_t total_size = 0;
+  if (encrypted_package.size() >= sizeof(total_size)) {
+    std::memcpy(&total_size, encrypted_package.data(), sizeof(total_size));
+    encrypted_package.remove_prefix(sizeof(total_size));
+  }
+  // only whole blocks can be decrypted
+  const std::size_t block_size = 16;
+  total_size = std::min<std::uint64_t>(
+      total_size, encrypted_package.size() / block_size * block_size);
+
+  // ECB blocks are independent of each other, so segments of the package are
+  // decrypted straight into the result on all threads
+  std::string result((total_size + block_size - 1) / block_size * block_size,
+                     '\0');
+  const std::size_t segment_count =
+      (result.size() + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+  util::thread::parallel_for(
+      segment_count, util::thread::thread_count(0), [&](std::size_t segment) {
+        const std::size_t offset = segment * SEGMENT_SIZE;
+        const std::size_t size =
+            std::min<std::size_t>(SEGMENT_SIZE, result.size() - offset);
+        internal::crypto::util::decrypt_AES(
+            key, encrypted_package.substr(offset, size),
+            result.data() + offset);
+      });
+  result.resize(total_size);
+
+  return result;
+}
+
+namespace {
+// block keys of the password key encryptor, see [MS-OFFCRYPTO] 2.3.4.13
+constexpr std::string_view VERIFIER_HASH_INPUT_BLOCK =
+    "\xfe\xa7\xd2\x76\x3b\x4b\x9e\x79";
+constexpr std::string_view VERIFIER_HASH_VALUE_BLOCK =
+    "\xd7\xaa\x0f\x6d\x30\x61\x34\x4e";
+constexpr std::string_view ENCRYPTED_KEY_VALUE_BLOCK =
+    "\x14\x6e\x0b\xe7\xab\xac\xd0\xd6";
+
+constexpr auto PASSWORD_KEY_ENCRYPTOR_URI =
+    "http://schemas.microsoft.com/office/2006/keyEncryptor/password";
+
+bool is_supported_hash(const std::string &algorithm) {
+  return algorithm == "SHA1" || algorithm == "SHA256" ||
+         algorithm == "SHA512";
+}
+
+std::string agile_hash(const std::string &algorithm, const std::string &in) {
+  if (algorithm == "SHA512") {
+    return internal::crypto::util::sha512(in);
+  }
+  if (algorithm == "SHA256") {
+    return internal::crypto::util::sha256(in);
+  }
+  return internal::crypto::util::sha1(in);
+}
+
+/// Truncates or pads with 0x36 as the spec does for keys and IVs.
+std::string fit(std::string value, std::size_t size) {
+  value.resize(size, '\x36');
+  return value;
+}
+
+/// First child element called `local_name`, whatever its namespace prefix.
+pugi::xml_node child_by_local_name(const pugi::xml_node node,
+                                   const std::string_view local_name) {
+  for (const pugi::xml_node child : node.children()) {
+    std::string_view name = child.name();
+    if (const auto colon = name.find(':'); colon != std::string_view::npos) {
+      name.remove_prefix(colon + 1);
+    }
+    if (name == local_name) {
+      return child;
+    }
+  }
+  return {};
+}
+
+void read_key_data(const pugi::xml_node node, AgileKeyData &key_data) {
+  key_data.salt_size = node.attribute("saltSize").as_uint();
+  key_data.block_size = node.attribute("blockSize").as_uint();
+  key_data.key_bits = node.attribute("keyBits").as_uint();
+  key_data.hash_size = node.attribute("hashSize").as_uint();
+  key_data.cipher_algorithm = node.attribute("cipherAlgorithm").value();
+  key_data.cipher_chaining = node.attribute("cipherChaining").value();
+  key_data.hash_algorithm = node.attribute("hashAlgorithm").value();
+  key_data.salt_value = internal::crypto::util::base64_decode(
+      node.attribute("saltValue").value());
+}
+
+void check_supported(const AgileKeyData &key_data) {
+  if (key_data.cipher_algorithm != "AES" ||
+      key_data.cipher_chaining != "ChainingModeCBC" ||
+      key_data.block_size != 16 || key_data.salt_value.size() != 16 ||
+      !is_supported_hash(key_data.hash_algorithm) ||
+      (key_data.key_bits != 128 && key_data.key_bits != 192 &&
+       key_data.key_bits != 256)) {
+    throw MsUnsupportedCryptoAlgorithm();
+  }
+}
+} // namespace
+
+ECMA376Agile::ECMA376Agile(AgileKeyData key_data,
+                           AgileEncryptedKey encrypted_key)
+    : m_key_data{std::move(key_data)},
+      m_encrypted_key{std::move(encrypted_key)} {
+  check_supported(m_key_data);
+  check_supported(m_encrypted_key);
+}
+
+ECMA376Agile::ECMA376Agile(const std::string &encryption_info) {
+  // the XML descriptor follows the version and the reserved flags
+  if (encryption_info.size() < sizeof(VersionInfo) + 4) {
+    throw MsUnsupportedCryptoAlgorithm();
+  }
+  const pugi::xml_document document = util::xml::parse(
+      encryption_info.substr(sizeof(VersionInfo) + 4));
+  const pugi::xml_node encryption = document.child("encryption");
+
+  read_key_data(encryption.child("keyData"), m_key_data);
+
+  bool has_password_key_encryptor = false;
+  for (const pugi::xml_node key_encryptor :
+       encryption.child("keyEncryptors").children("keyEncryptor")) {
+    if (std::strcmp(key_encryptor.attribute("uri").value(),
+                    PASSWORD_KEY_ENCRYPTOR_URI) != 0) {
+      continue;
+    }
+    // `p:encryptedKey` with whatever prefix the writer chose
+    const pugi::xml_node encrypted_key =
+        child_by_local_name(key_encryptor, "encryptedKey");
+    if (!encrypted_key) {
+      continue;
+    }
+    read_key_data(encrypted_key, m_encrypted_key);
+    m_encrypted_key.spin_count =
+        encrypted_key.attribute("spinCount").as_uint();
+    m_encrypted_key.encrypted_verifier_hash_input =
+        internal::crypto::util::base64_decode(
+            encrypted_key.attribute("encryptedVerifierHashInput").value());
+    m_encrypted_key.encrypted_verifier_hash_value =
+        internal::crypto::util::base64_decode(
+            encrypted_key.attribute("encryptedVerifierHashValue").value());
+    m_encrypted_key.encrypted_key_value = internal::crypto::util::base64_decode(
+        encrypted_key.attribute("encryptedKeyValue").value());
+    has_password_key_encryptor = true;
+    break;
+  }
+  if (!has_password_key_encryptor) {
+    // certificate only
+    throw MsUnsupportedCryptoAlgorithm();
+  }
+
+  check_supported(m_key_data);
+  check_supported(m_encrypted_key);
+}
+
+std::string
+ECMA376Agile::derive_key(const std::string &password) const noexcept {
+  // [MS-OFFCRYPTO] 2.3.4.11
+
+  const std::u16string password_u16 =
+      util::string::string_to_u16string(password);
+  const std::string password_u16_bytes(
+      reinterpret_cast<const char *>(password_u16.data()),
+      2 * password_u16.size());
+
+  const std::string &algorithm = m_encrypted_key.hash_algorithm;
+  std::string hash =
+      agile_hash(algorithm, m_encrypted_key.salt_value + password_u16_bytes);
+  std::string ibytes(4, ' ');
+  for (std::uint32_t i = 0; i < m_encrypted_key.spin_count; ++i) {
+    to_little_endian(i, ibytes);
+    hash = agile_hash(algorithm, ibytes + hash);
+  }
+
+  return hash;
+}
+
+std::string ECMA376Agile::block_key(const std::string &hash,
+                                    const std::string_view block) const {
+  return fit(agile_hash(m_encrypted_key.hash_algorithm,
+                        hash + std::string(block)),
+             m_encrypted_key.key_bits / 8);
+}
+
+bool ECMA376Agile::verify(const std::string &key) const noexcept {
+  // [MS-OFFCRYPTO] 2.3.4.13
+
+  try {
+    const std::string &salt = m_encrypted_key.salt_value;
+    const std::string verifier_hash_input =
+        internal::crypto::util::decrypt_AES(
+            block_key(key, VERIFIER_HASH_INPUT_BLOCK), salt,
+            m_encrypted_key.encrypted_verifier_hash_input)
+            .substr(0, m_encrypted_key.salt_size);
+    const std::string verifier_hash_value =
+        internal::crypto::util::decrypt_AES(
+            block_key(key, VERIFIER_HASH_VALUE_BLOCK), salt,
+            m_encrypted_key.encrypted_verifier_hash_value)
+            .substr(0, m_encrypted_key.hash_size);
+
+    return agile_hash(m_encrypted_key.hash_algorithm, verifier_hash_input)
+               .substr(0, m_encrypted_key.hash_size) == verifier_hash_value;
+  } catch (...) {
+    return false;
+  }
+}
+
+std::string ECMA376Agile::decrypt(std::string_view encrypted_package,
+                                  const std::string &key) const {
+  // [MS-OFFCRYPTO] 2.3.4.15
+
+  const std::string secret_key =
+      internal::crypto::util::decrypt_AES(
+          block_key(key, ENCRYPTED_KEY_VALUE_BLOCK),
+          m_encrypted_key.salt_value, m_encrypted_key.encrypted_key_value)
+          .substr(0, m_key_data.key_bits / 8);
+
+  std::uint64_t total_size = 0;
+  if (encrypted_package.size() >= sizeof(total_size)) {
+    std::memcpy(&total_size, encrypted_package.data(), sizeof(total_size));
+    encrypted_package.remove_prefix(sizeof(total_size));
+  }
+  // only whole blocks can be decrypted
+  const std::size_t block_size = m_key_data.block_size;
+  total_size = std::min<std::uint64_t>(
+      total_size, encrypted_package.size() / block_size * block_size);
+
+  // every segment has its own IV, so they are decrypted independently
+  // straight into the result on all threads
+  std::string result((total_size + block_size - 1) / block_size * block_size,
+                     '\0');
+  const std::size_t segment_count =
+      (result.size() + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+  const std::size_t task_count =
+      (segment_count + SEGMENTS_PER_TASK - 1) / SEGMENTS_PER_TASK;
+  util::thread::parallel_for(
+      task_count, util::thread::thread_count(0), [&](std::size_t task) {
+        // the salt followed by the little endian segment index
+        std::string segment_salt = m_key_data.salt_value + "    ";
+        char *segment_index =
+            segment_salt.data() + m_key_data.salt_value.size();
+        const std::size_t end =
+            std::min(segment_count, (task + 1) * SEGMENTS_PER_TASK);
+        for (std::size_t segment = task * SEGMENTS_PER_TASK; segment < end;
+             ++segment) {
+          to_little_endian(static_cast<std::uint32_t>(segment), segment_index);
+          const std::string iv =
+              fit(agile_hash(m_key_data.hash_algorithm, segment_salt),
+                  block_size);
+          const std::size_t offset = segment * SEGMENT_SIZE;
+          const std::size_t size =
+              std::min(SEGMENT_SIZE, result.size() - offset);
+          internal::crypto::util::decrypt_AES(
+              secret_key, iv, encrypted_package.substr(offset, size),
+              result.data() + offset);
+        }
+      });
+  result.resize(total_size);
 
   return result;
 }
@@ -152,7 +415,7 @@ Util::Util(const std::string &encryption_info) {
       (version_info.minor == 2)) {
     impl = std::make_unique<ECMA376Standard>(encryption_info);
   } else if ((version_info.major == 4) && (version_info.minor == 4)) {
-    throw MsUnsupportedCryptoAlgorithm(); // agile
+    impl = std::make_unique<ECMA376Agile>(encryption_info);
   } else if (((version_info.major == 3) || (version_info.major == 4)) &&
              (version_info.minor == 3)) {
     throw MsUnsupportedCryptoAlgorithm(); // extensible
@@ -171,8 +434,8 @@ bool Util::verify(const std::string &key) const noexcept {
   return impl->verify(key);
 }
 
-std::string Util::decrypt(const std::string &encrypted_package,
-                          const std::string &key) const noexcept {
+std::string Util::decrypt(std::string_view encrypted_package,
+                          const std::string &key) const {
   return impl->decrypt(encrypted_package, key);
 }
 
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace odr::internal::ooxml::crypto {
 
@@ -53,8 +54,7 @@ public:
   derive_key(const std::string &password) const noexcept = 0;
   [[nodiscard]] virtual bool verify(const std::string &key) const noexcept = 0;
   [[nodiscard]] virtual std::string
-  decrypt(const std::string &encrypted_package,
-          const std::string &key) const noexcept = 0;
+  decrypt(std::string_view encrypted_package, const std::string &key) const = 0;
 };
 
 class ECMA376Standard final : public Algorithm {
@@ -66,18 +66,66 @@ public:
   [[nodiscard]] std::string
   derive_key(const std::string &password) const noexcept final;
   [[nodiscard]] bool verify(const std::string &key) const noexcept final;
-  [[nodiscard]] std::string
-  decrypt(const std::string &encrypted_package,
-          const std::string &key) const noexcept final;
+  [[nodiscard]] std::string decrypt(std::string_view encrypted_package,
+                                    const std::string &key) const final;
 
 private:
   static constexpr auto ITER_COUNT = 50000;
+  /// Bytes decrypted by one task; a multiple of the AES block size.
+  static constexpr std::size_t SEGMENT_SIZE = 1 << 20;
 
   EncryptionHeader m_encryption_header;
   EncryptionVerifier m_encryption_verifier;
   std::string m_encrypted_verifier_hash;
 };
 
+/// Cipher and hash parameters shared by `keyData` and the key encryptors of
+/// an agile `EncryptionInfo`.
+struct AgileKeyData {
+  std::uint32_t salt_size{0};
+  std::uint32_t block_size{0};
+  std::uint32_t key_bits{0};
+  std::uint32_t hash_size{0};
+  std::string cipher_algorithm;
+  std::string cipher_chaining;
+  std::string hash_algorithm;
+  std::string salt_value;
+};
+
+/// The password key encryptor of an agile `EncryptionInfo`.
+struct AgileEncryptedKey : AgileKeyData {
+  std::uint32_t spin_count{0};
+  std::string encrypted_verifier_hash_input;
+  std::string encrypted_verifier_hash_value;
+  std::string encrypted_key_value;
+};
+
+/// Agile encryption, see [MS-OFFCRYPTO] 2.3.4.10 and following.
+class ECMA376Agile final : public Algorithm {
+public:
+  ECMA376Agile(AgileKeyData key_data, AgileEncryptedKey encrypted_key);
+  explicit ECMA376Agile(const std::string &encryption_info);
+
+  /// The key is the spun password hash which the other keys derive from.
+  [[nodiscard]] std::string
+  derive_key(const std::string &password) const noexcept final;
+  [[nodiscard]] bool verify(const std::string &key) const noexcept final;
+  [[nodiscard]] std::string decrypt(std::string_view encrypted_package,
+                                    const std::string &key) const final;
+
+private:
+  /// The package is encrypted in segments of this size with their own IVs.
+  static constexpr std::size_t SEGMENT_SIZE = 4096;
+  /// Segments decrypted by one task.
+  static constexpr std::size_t SEGMENTS_PER_TASK = 256;
+
+  AgileKeyData m_key_data;
+  AgileEncryptedKey m_encrypted_key;
+
+  [[nodiscard]] std::string block_key(const std::string &hash,
+                                      std::string_view block) const;
+};
+
 class Util final : public Algorithm {
 public:
   explicit Util(const std::string &encryption_info);
@@ -86,9 +134,8 @@ public:
   [[nodiscard]] std::string
   derive_key(const std::string &password) const noexcept final;
   [[nodiscard]] bool verify(const std::string &key) const noexcept final;
-  [[nodiscard]] std::string
-  decrypt(const std::string &encrypted_package,
-          const std::string &key) const noexcept final;
+  [[nodiscard]] std::string decrypt(std::string_view encrypted_package,
+                                    const std::string &key) const final;
 
 private:
   std::unique_ptr<Algorithm> impl;
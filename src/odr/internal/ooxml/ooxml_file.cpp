@@ -11,8 +11,10 @@
 #include <odr/internal/ooxml/spreadsheet/ooxml_spreadsheet_document.hpp>
 #include <odr/internal/ooxml/text/ooxml_text_document.hpp>
 #include <odr/internal/util/stream_util.hpp>
+#include <odr/internal/util/thread_util.hpp>
 #include <odr/internal/zip/zip_file.hpp>
 
+#include <string_view>
 #include <utility>
 
 namespace odr::internal::abstract {
@@ -64,8 +66,19 @@ bool OfficeOpenXmlFile::decrypt(const std::string &password) {
   if (!util.verify(key)) {
     return false;
   }
-  std::string encrypted_package =
-      util::stream::read(*m_filesystem->open("/EncryptedPackage")->stream());
+  // decrypt straight out of the compound file if the package is stored in
+  // one piece
+  auto encrypted_package_file = m_filesystem->open("/EncryptedPackage");
+  std::string encrypted_package_buffer;
+  std::string_view encrypted_package;
+  if (const char *memory_data = encrypted_package_file->memory_data();
+      memory_data != nullptr) {
+    encrypted_package = {memory_data, encrypted_package_file->size()};
+  } else {
+    encrypted_package_buffer =
+        util::stream::read(*encrypted_package_file->stream());
+    encrypted_package = encrypted_package_buffer;
+  }
   std::string decrypted_package = util.decrypt(encrypted_package, key);
   auto memory_file =
       std::make_shared<common::MemoryFile>(std::move(decrypted_package));
@@ -75,6 +88,21 @@ bool OfficeOpenXmlFile::decrypt(const std::string &password) {
   return true;
 }
 
+std::optional<std::size_t> OfficeOpenXmlFile::find_password(
+    const std::vector<std::string> &passwords) const {
+  if (!m_file_meta.password_encrypted) {
+    return std::nullopt; // TODO throw
+  }
+  std::string encryption_info =
+      util::stream::read(*m_filesystem->open("/EncryptionInfo")->stream());
+  crypto::Util util(encryption_info);
+  return odr::internal::util::thread::find_first(
+      passwords.size(), odr::internal::util::thread::thread_count(0),
+      [&](const std::size_t index) {
+        return util.verify(util.derive_key(passwords[index]));
+      });
+}
+
 std::shared_ptr<abstract::Document> OfficeOpenXmlFile::document() const {
   // TODO throw if encrypted
   switch (file_type()) {
@@ -6,6 +6,7 @@
 #include <odr/internal/ooxml/spreadsheet/ooxml_spreadsheet_document.hpp>
 #include <odr/internal/util/map_util.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <optional>
 
@@ -157,6 +158,12 @@ abstract::SheetCell *Sheet::cell(const abstract::Document *,
   return nullptr;
 }
 
+std::pair<std::uint32_t, std::uint32_t>
+Sheet::anchor(const abstract::Document *, std::uint32_t column,
+              std::uint32_t row) const {
+  return m_index.merges.anchor(column, row);
+}
+
 abstract::Element *Sheet::first_shape(const abstract::Document *) const {
   return m_first_shape;
 }
@@ -213,6 +220,11 @@ void Sheet::init_cell_(std::uint32_t column, std::uint32_t row,
   m_index.init_cell(column, row, element);
 }
 
+void Sheet::init_merge_(std::uint32_t column, std::uint32_t row,
+                        TableDimensions span) {
+  m_index.merges.add(column, row, span);
+}
+
 void Sheet::init_cell_element_(std::uint32_t column, std::uint32_t row,
                                SheetCell *element) {
   m_cells[{column, row}] = element;
@@ -234,6 +246,10 @@ void Sheet::append_shape_(Element *shape) {
   m_last_shape = shape;
 }
 
+TableDimensions Sheet::span_(std::uint32_t column, std::uint32_t row) const {
+  return m_index.merges.span(column, row);
+}
+
 bool SheetCell::is_covered(const abstract::Document *) const {
   return false; // TODO
 }
@@ -250,8 +266,10 @@ SheetCell::partial_style(const abstract::Document *document) const {
   return {};
 }
 
-TableDimensions SheetCell::span(const abstract::Document *) const {
-  return {1, 1};
+TableDimensions SheetCell::span(const abstract::Document *document) const {
+  auto sheet = dynamic_cast<const Sheet *>(parent(document));
+  auto position = common::TablePosition(m_node.attribute("r").value());
+  return sheet->span_(position.column(), position.row());
 }
 
 TableCellStyle SheetCell::style(const abstract::Document *document) const {
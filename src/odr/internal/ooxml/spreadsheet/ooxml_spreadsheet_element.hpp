@@ -7,6 +7,7 @@
 #include <odr/internal/common/document_element.hpp>
 #include <odr/internal/common/path.hpp>
 #include <odr/internal/common/style.hpp>
+#include <odr/internal/common/table_merges.hpp>
 #include <odr/internal/common/table_position.hpp>
 #include <odr/internal/ooxml/ooxml_util.hpp>
 
@@ -81,6 +82,8 @@ struct SheetIndex final {
   std::map<std::uint32_t, pugi::xml_node> columns;
   std::map<std::uint32_t, Row> rows;
 
+  common::TableMerges merges;
+
   void init_column(std::uint32_t min, std::uint32_t max,
                    pugi::xml_node element);
   void init_row(std::uint32_t row, pugi::xml_node element);
@@ -108,6 +111,9 @@ public:
   [[nodiscard]] abstract::SheetCell *cell(const abstract::Document *,
                                           std::uint32_t column,
                                           std::uint32_t row) const final;
+  [[nodiscard]] std::pair<std::uint32_t, std::uint32_t>
+  anchor(const abstract::Document *, std::uint32_t column,
+         std::uint32_t row) const final;
 
   [[nodiscard]] abstract::Element *
   first_shape(const abstract::Document *) const final;
@@ -126,11 +132,16 @@ public:
   void init_row_(std::uint32_t row, pugi::xml_node element);
   void init_cell_(std::uint32_t column, std::uint32_t row,
                   pugi::xml_node element);
+  void init_merge_(std::uint32_t column, std::uint32_t row,
+                   TableDimensions span);
   void init_cell_element_(std::uint32_t column, std::uint32_t row,
                           SheetCell *element);
   void init_dimensions_(TableDimensions dimensions);
   void append_shape_(Element *shape);
 
+  [[nodiscard]] TableDimensions span_(std::uint32_t column,
+                                      std::uint32_t row) const;
+
 protected:
   [[nodiscard]] const common::Path &
   document_path_(const abstract::Document *) const final;
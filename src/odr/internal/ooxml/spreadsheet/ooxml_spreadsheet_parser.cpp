@@ -136,6 +136,14 @@ parse_element_tree(Document &document, pugi::xml_node node,
     }
   }
 
+  for (auto merge_node : node.child("mergeCells").children("mergeCell")) {
+    auto range = common::TableRange(merge_node.attribute("ref").value());
+    element->init_merge_(
+        range.from().column(), range.from().row(),
+        TableDimensions(range.to().row() - range.from().row() + 1,
+                        range.to().column() - range.from().column() + 1));
+  }
+
   {
     std::string dimension_ref =
         node.child("dimension").attribute("ref").value();
@@ -27,10 +27,9 @@ open_strategy::types(std::shared_ptr<abstract::File> file) {
 
   auto file_type = magic::file_type(*file);
 
-  // TODO if `file` is in memory we would copy it unnecessarily
-  auto memory_file = std::make_shared<common::MemoryFile>(*file);
-
   if (file_type == FileType::zip) {
+    // TODO if `file` is in memory we would copy it unnecessarily
+    auto memory_file = std::make_shared<common::MemoryFile>(*file);
     zip::ZipFile zip_file(memory_file);
     result.push_back(FileType::zip);
 
@@ -46,6 +45,8 @@ open_strategy::types(std::shared_ptr<abstract::File> file) {
     } catch (...) {
     }
   } else if (file_type == FileType::compound_file_binary_format) {
+    // TODO if `file` is in memory we would copy it unnecessarily
+    auto memory_file = std::make_shared<common::MemoryFile>(*file);
     cfb::CfbFile cfb_file(memory_file);
     result.push_back(FileType::compound_file_binary_format);
 
@@ -67,7 +68,7 @@ open_strategy::types(std::shared_ptr<abstract::File> file) {
     result.push_back(file_type);
   } else if (file_type == FileType::starview_metafile) {
     try {
-      result.push_back(svm::SvmFile(memory_file).file_type());
+      result.push_back(svm::SvmFile(file).file_type());
     } catch (...) {
     }
   } else if (file_type == FileType::unknown) {
@@ -97,10 +98,9 @@ std::unique_ptr<abstract::DecodedFile>
 open_strategy::open_file(std::shared_ptr<abstract::File> file) {
   auto file_type = magic::file_type(*file);
 
-  // TODO if `file` is in memory we would copy it unnecessarily
-  auto memory_file = std::make_shared<common::MemoryFile>(*file);
-
   if (file_type == FileType::zip) {
+    // TODO if `file` is in memory we would copy it unnecessarily
+    auto memory_file = std::make_shared<common::MemoryFile>(*file);
     auto zip_file = std::make_unique<zip::ZipFile>(std::move(memory_file));
 
     auto filesystem = zip_file->archive()->filesystem();
@@ -117,6 +117,8 @@ open_strategy::open_file(std::shared_ptr<abstract::File> file) {
 
     return zip_file;
   } else if (file_type == FileType::compound_file_binary_format) {
+    // TODO if `file` is in memory we would copy it unnecessarily
+    auto memory_file = std::make_shared<common::MemoryFile>(*file);
     auto cfb_file = std::make_unique<cfb::CfbFile>(std::move(memory_file));
 
     auto filesystem = cfb_file->archive()->filesystem();
@@ -140,7 +142,7 @@ open_strategy::open_file(std::shared_ptr<abstract::File> file) {
              file_type == FileType::bitmap_image_file) {
     return std::make_unique<common::ImageFile>(file, file_type);
   } else if (file_type == FileType::starview_metafile) {
-    return std::make_unique<svm::SvmFile>(memory_file);
+    return std::make_unique<svm::SvmFile>(file);
   } else if (file_type == FileType::unknown) {
     try {
       auto text = std::make_shared<text::TextFile>(file);
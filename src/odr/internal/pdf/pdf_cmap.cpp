@@ -1,28 +1,220 @@
 #include <odr/internal/pdf/pdf_cmap.hpp>
 
-#include <odr/internal/util/map_util.hpp>
-#include <odr/internal/util/string_util.hpp>
+#include <algorithm>
 
 namespace odr::internal::pdf {
 
-CMap::CMap() = default;
+namespace {
 
-void CMap::map_bfchar(char glyph, char16_t unicode) {
-  m_bfchar[glyph] = unicode;
+void append_utf8(char32_t c, std::string &out) {
+  if (c < 0x80) {
+    out += static_cast<char>(c);
+  } else if (c < 0x800) {
+    out += static_cast<char>(0xc0 | (c >> 6));
+    out += static_cast<char>(0x80 | (c & 0x3f));
+  } else if (c < 0x10000) {
+    out += static_cast<char>(0xe0 | (c >> 12));
+    out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (c & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (c >> 18));
+    out += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (c & 0x3f));
+  }
+}
+
+/// Decodes UTF-16BE; unpaired surrogates become U+FFFD.
+std::u32string decode_utf16be(std::string_view data) {
+  std::u32string result;
+  for (std::size_t i = 0; i + 1 < data.size(); i += 2) {
+    char32_t unit = static_cast<std::uint8_t>(data[i]) << 8 |
+                    static_cast<std::uint8_t>(data[i + 1]);
+    if (unit >= 0xd800 && unit < 0xdc00 && i + 3 < data.size()) {
+      char32_t low = static_cast<std::uint8_t>(data[i + 2]) << 8 |
+                     static_cast<std::uint8_t>(data[i + 3]);
+      if (low >= 0xdc00 && low < 0xe000) {
+        result += 0x10000 + ((unit - 0xd800) << 10) + (low - 0xdc00);
+        i += 2;
+        continue;
+      }
+    }
+    if (unit >= 0xd800 && unit < 0xe000) {
+      unit = 0xfffd;
+    }
+    result += unit;
+  }
+  return result;
+}
+
+} // namespace
+
+CMap::CMap() { m_one_byte.fill(unmapped); }
+
+std::uint32_t CMap::read_code(std::string_view code) {
+  std::uint32_t result = 0;
+  for (char c : code.substr(0, 4)) {
+    result = (result << 8) | static_cast<std::uint8_t>(c);
+  }
+  return result;
+}
+
+void CMap::add_codespace_range(std::string_view low, std::string_view high) {
+  if (low.empty() || low.size() > 4 || low.size() != high.size()) {
+    return;
+  }
+
+  CodespaceRange range;
+  range.length = static_cast<std::uint32_t>(low.size());
+  for (std::size_t i = 0; i < low.size(); ++i) {
+    range.low[i] = static_cast<std::uint8_t>(low[i]);
+    range.high[i] = static_cast<std::uint8_t>(high[i]);
+  }
+  m_codespace_ranges.push_back(range);
+
+  m_uniform_length = m_codespace_ranges.size() == 1 ||
+                             m_uniform_length == range.length
+                         ? range.length
+                         : 0;
+}
+
+void CMap::map_bfchar(std::string_view code, std::string_view unicode) {
+  if (code.empty() || code.size() > 4) {
+    return;
+  }
+  map_code(read_code(code), static_cast<std::uint32_t>(code.size()), unicode);
+}
+
+void CMap::map_bfrange(std::string_view low, std::string_view high,
+                       std::string_view unicode) {
+  if (low.empty() || low.size() > 4) {
+    return;
+  }
+  auto length = static_cast<std::uint32_t>(low.size());
+  std::uint32_t from = read_code(low);
+  // ranges are not supposed to span more than the last byte; bound them
+  // anyway so a broken stream cannot blow up the tables
+  std::uint32_t to = std::min(read_code(high), from + 0xffff);
+
+  std::u32string characters = decode_utf16be(unicode);
+  if (characters.empty()) {
+    return;
+  }
+  if (characters.size() == 1) {
+    for (std::uint32_t code = from; code <= to && code >= from; ++code) {
+      std::uint32_t c = characters[0] + (code - from);
+      set_entry(code, length, c < sequence_base ? c : 0xfffd);
+    }
+    return;
+  }
+
+  for (std::uint32_t code = from; code <= to && code >= from; ++code) {
+    std::string sequence;
+    for (std::size_t i = 0; i + 1 < characters.size(); ++i) {
+      append_utf8(characters[i], sequence);
+    }
+    append_utf8(characters.back() + (code - from), sequence);
+    set_entry(code, length,
+              sequence_base + static_cast<std::uint32_t>(m_sequences.size()));
+    m_sequences.push_back(std::move(sequence));
+  }
+}
+
+void CMap::map_code(std::uint32_t code, std::uint32_t length,
+                    std::string_view unicode) {
+  std::u32string characters = decode_utf16be(unicode);
+  if (characters.size() == 1) {
+    set_entry(code, length, characters[0]);
+    return;
+  }
+
+  std::string sequence;
+  for (char32_t c : characters) {
+    append_utf8(c, sequence);
+  }
+  set_entry(code, length,
+            sequence_base + static_cast<std::uint32_t>(m_sequences.size()));
+  m_sequences.push_back(std::move(sequence));
+}
+
+void CMap::set_entry(std::uint32_t code, std::uint32_t length,
+                     std::uint32_t entry) {
+  if (length == 1) {
+    m_one_byte[code & 0xff] = entry;
+  } else if (length == 2) {
+    if (m_two_byte.empty()) {
+      m_two_byte.resize(0x10000, unmapped);
+    }
+    m_two_byte[code & 0xffff] = entry;
+  } else {
+    m_wide[static_cast<std::uint64_t>(length) << 32 | code] = entry;
+  }
 }
 
-char16_t CMap::translate_glyph(char glyph) const {
-  return util::map::lookup_default(m_bfchar, glyph, glyph);
+std::uint32_t CMap::lookup(std::uint32_t code, std::uint32_t length) const {
+  if (length == 1) {
+    return m_one_byte[code];
+  }
+  if (length == 2) {
+    return m_two_byte.empty() ? unmapped : m_two_byte[code];
+  }
+  auto it = m_wide.find(static_cast<std::uint64_t>(length) << 32 | code);
+  return it == std::end(m_wide) ? unmapped : it->second;
 }
 
-std::string CMap::translate_string(const std::string &glyphs) const {
-  std::u16string result;
+std::uint32_t CMap::code_length(std::string_view glyphs) const {
+  if (m_codespace_ranges.empty()) {
+    return 1;
+  }
+  if (m_uniform_length != 0) {
+    return std::min<std::uint32_t>(
+        m_uniform_length, static_cast<std::uint32_t>(glyphs.size()));
+  }
 
-  for (char glyph : glyphs) {
-    result += translate_glyph(glyph);
+  // the shortest range matching the leading bytes wins
+  std::uint32_t best = 0;
+  for (const CodespaceRange &range : m_codespace_ranges) {
+    if (range.length > glyphs.size() || (best != 0 && range.length >= best)) {
+      continue;
+    }
+    bool match = true;
+    for (std::uint32_t i = 0; i < range.length; ++i) {
+      auto byte = static_cast<std::uint8_t>(glyphs[i]);
+      if (byte < range.low[i] || byte > range.high[i]) {
+        match = false;
+        break;
+      }
+    }
+    if (match) {
+      best = range.length;
+    }
   }
 
-  return util::string::u16string_to_string(result);
+  return best != 0 ? best : 1;
+}
+
+void CMap::translate_string(std::string_view glyphs, std::string &out) const {
+  while (!glyphs.empty()) {
+    std::uint32_t length = code_length(glyphs);
+    std::uint32_t code = read_code(glyphs.substr(0, length));
+    glyphs.remove_prefix(length);
+
+    std::uint32_t entry = lookup(code, length);
+    if (entry == unmapped) {
+      // single bytes without mapping pass through as before
+      append_utf8(length == 1 ? code : 0xfffd, out);
+    } else if (entry >= sequence_base) {
+      out += m_sequences[entry - sequence_base];
+    } else {
+      append_utf8(entry, out);
+    }
+  }
+}
+
+std::string CMap::translate_string(std::string_view glyphs) const {
+  std::string result;
+  translate_string(glyphs, result);
+  return result;
 }
 
 } // namespace odr::internal::pdf
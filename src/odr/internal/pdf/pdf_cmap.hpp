@@ -1,22 +1,66 @@
 #ifndef ODR_INTERNAL_PDF_CMAP_HPP
 #define ODR_INTERNAL_PDF_CMAP_HPP
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace odr::internal::pdf {
 
+/// Maps character codes of a font to unicode. Codes are 1-4 bytes wide as
+/// given by the codespace ranges; without any ranges every byte is a code.
+/// 1- and 2-byte codes are looked up in dense arrays.
 class CMap {
 public:
   CMap();
 
-  void map_bfchar(char glyph, char16_t unicode);
+  /// Big-endian value of a 1-4 byte code.
+  static std::uint32_t read_code(std::string_view code);
 
-  char16_t translate_glyph(char glyph) const;
-  std::string translate_string(const std::string &glyphs) const;
+  void add_codespace_range(std::string_view low, std::string_view high);
+
+  /// `unicode` is UTF-16BE as found in `ToUnicode` streams.
+  void map_bfchar(std::string_view code, std::string_view unicode);
+  /// Maps `low`..`high` to `unicode` with its last character incremented.
+  void map_bfrange(std::string_view low, std::string_view high,
+                   std::string_view unicode);
+  void map_code(std::uint32_t code, std::uint32_t length,
+                std::string_view unicode);
+
+  /// Appends the UTF-8 text of `glyphs` to `out`.
+  void translate_string(std::string_view glyphs, std::string &out) const;
+  std::string translate_string(std::string_view glyphs) const;
 
 private:
-  std::unordered_map<char, char16_t> m_bfchar;
+  struct CodespaceRange {
+    std::array<std::uint8_t, 4> low{};
+    std::array<std::uint8_t, 4> high{};
+    std::uint32_t length{};
+  };
+
+  /// Entries below `sequence_base` are code points, entries above index
+  /// `m_sequences`.
+  static constexpr std::uint32_t unmapped = 0xffffffff;
+  static constexpr std::uint32_t sequence_base = 0x110000;
+
+  std::vector<CodespaceRange> m_codespace_ranges;
+  /// length shared by all codespace ranges or 0 if they differ
+  std::uint32_t m_uniform_length{0};
+  std::array<std::uint32_t, 256> m_one_byte;
+  /// allocated with the first 2-byte mapping
+  std::vector<std::uint32_t> m_two_byte;
+  /// 3- and 4-byte codes keyed by `length << 32 | code`
+  std::unordered_map<std::uint64_t, std::uint32_t> m_wide;
+  /// UTF-8 of mappings to more than one code point, e.g. ligatures
+  std::vector<std::string> m_sequences;
+
+  std::uint32_t code_length(std::string_view glyphs) const;
+  std::uint32_t lookup(std::uint32_t code, std::uint32_t length) const;
+  void set_entry(std::uint32_t code, std::uint32_t length,
+                 std::uint32_t entry);
 };
 
 } // namespace odr::internal::pdf
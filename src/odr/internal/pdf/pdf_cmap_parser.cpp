@@ -1,21 +1,14 @@
 #include <odr/internal/pdf/pdf_cmap_parser.hpp>
 
 #include <odr/internal/pdf/pdf_cmap.hpp>
-#include <odr/internal/util/byte_util.hpp>
-
-#include <iostream>
 
 namespace odr::internal::pdf {
 
-using char_type = std::streambuf::char_type;
-using int_type = std::streambuf::int_type;
-static constexpr int_type eof = std::streambuf::traits_type::eof();
-
-CMapParser::CMapParser(std::istream &in) : m_parser(in) {}
-
-std::istream &CMapParser::in() const { return m_parser.in(); }
+using char_type = ObjectParser::char_type;
+using int_type = ObjectParser::int_type;
+static constexpr int_type eof = ObjectParser::eof;
 
-std::streambuf &CMapParser::sb() const { return m_parser.sb(); }
+CMapParser::CMapParser(std::string_view data) : m_parser(data) {}
 
 const ObjectParser &CMapParser::parser() const { return m_parser; }
 
@@ -51,56 +44,50 @@ std::variant<Object, std::string> CMapParser::read_token() const {
 }
 
 void CMapParser::read_codespacerange(std::uint32_t n, CMap &cmap) const {
-  (void)cmap;
-
   m_parser.skip_whitespace();
   for (std::uint32_t i = 0; i < n; ++i) {
-    auto from_glyph = m_parser.read_object();
+    Object from_glyph = m_parser.read_object();
     m_parser.skip_whitespace();
-    auto to_glyph = m_parser.read_object();
+    Object to_glyph = m_parser.read_object();
     m_parser.skip_whitespace();
 
-    // TODO
+    cmap.add_codespace_range(from_glyph.as_string(), to_glyph.as_string());
   }
 }
 
 void CMapParser::read_bfchar(std::uint32_t n, CMap &cmap) const {
   m_parser.skip_whitespace();
   for (std::uint32_t i = 0; i < n; ++i) {
-    std::string glyph = m_parser.read_object().as_string();
+    Object glyph = m_parser.read_object();
     m_parser.skip_whitespace();
-    std::string unicode = m_parser.read_object().as_string();
+    Object unicode = m_parser.read_object();
     m_parser.skip_whitespace();
 
-    util::reverse_bytes(reinterpret_cast<char16_t *>(unicode.data()),
-                        (std::size_t)unicode.size() / 2);
-    std::u16string_view unicode16(
-        reinterpret_cast<const char16_t *>(unicode.data()), unicode.size() / 2);
-
-    if (glyph.length() != 1) {
-      std::cerr << "unexpected glyph length" << std::endl;
-    }
-    if (unicode16.length() != 1) {
-      std::cerr << "unexpected unicode length" << std::endl;
-    }
-
-    cmap.map_bfchar(glyph[0], unicode16[0]);
+    cmap.map_bfchar(glyph.as_string(), unicode.as_string());
   }
 }
 
 void CMapParser::read_bfrange(std::uint32_t n, CMap &cmap) const {
-  (void)cmap;
-
   m_parser.skip_whitespace();
   for (std::uint32_t i = 0; i < n; ++i) {
-    auto from_glyph = m_parser.read_object();
+    Object from_glyph = m_parser.read_object();
     m_parser.skip_whitespace();
-    auto to_glyph = m_parser.read_object();
+    Object to_glyph = m_parser.read_object();
     m_parser.skip_whitespace();
-    auto unicode = m_parser.read_object();
+    Object unicode = m_parser.read_object();
     m_parser.skip_whitespace();
 
-    // TODO
+    const std::string &from = from_glyph.as_string();
+    if (unicode.is_array()) {
+      // one destination per code
+      auto length = static_cast<std::uint32_t>(from.size());
+      std::uint32_t code = CMap::read_code(from);
+      for (const Object &element : unicode.as_array()) {
+        cmap.map_code(code++, length, element.as_string());
+      }
+    } else {
+      cmap.map_bfrange(from, to_glyph.as_string(), unicode.as_string());
+    }
   }
 }
 
@@ -112,7 +99,7 @@ CMap CMapParser::parse_cmap() const {
   m_parser.skip_whitespace();
   while (true) {
     Token token = read_token();
-    if (in().eof()) {
+    if (m_parser.at_end()) {
       break;
     }
     m_parser.skip_whitespace();
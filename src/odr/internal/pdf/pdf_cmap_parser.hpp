@@ -4,7 +4,8 @@
 #include <odr/internal/pdf/pdf_object.hpp>
 #include <odr/internal/pdf/pdf_object_parser.hpp>
 
-#include <iosfwd>
+#include <string>
+#include <string_view>
 #include <variant>
 
 namespace odr::internal::pdf {
@@ -15,10 +16,8 @@ class CMapParser {
 public:
   using Token = std::variant<Object, std::string>;
 
-  explicit CMapParser(std::istream &);
+  explicit CMapParser(std::string_view data);
 
-  std::istream &in() const;
-  std::streambuf &sb() const;
   const ObjectParser &parser() const;
 
   CMap parse_cmap() const;
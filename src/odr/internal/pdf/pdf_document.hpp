@@ -1,18 +1,28 @@
 #ifndef ODR_INTERNAL_PDF_DOCUMENT_HPP
 #define ODR_INTERNAL_PDF_DOCUMENT_HPP
 
+#include <odr/internal/pdf/pdf_object.hpp>
+
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace odr::internal::pdf {
 
 struct Catalog;
 struct Element;
+struct Font;
+class CMap;
 
 struct Document {
   Catalog *catalog;
   std::vector<std::unique_ptr<Element>> elements;
 
+  /// fonts are shared between pages and only parsed once
+  std::unordered_map<ObjectReference, Font *> fonts;
+  /// `ToUnicode` streams by reference; fonts often share them
+  std::unordered_map<ObjectReference, std::unique_ptr<CMap>> cmaps;
+
   template <typename T, typename... Args> T *create_element(Args &&...args) {
     auto unique = std::make_unique<T>(std::forward<Args>(args)...);
     auto pointer = unique.get();
@@ -4,6 +4,7 @@
 #include <odr/internal/pdf/pdf_cmap.hpp>
 #include <odr/internal/pdf/pdf_object.hpp>
 
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -38,7 +39,13 @@ struct Catalog : Element {
 };
 
 struct Pages : Element {
+  /// kids are parsed on demand; `kids[i]` stays null until then
+  std::vector<ObjectReference> kid_references;
   std::vector<Element *> kids;
+  /// page counts of the kids, filled in as the tree is searched
+  std::vector<std::optional<std::uint32_t>> kid_counts;
+  /// whether every kid is a page, decided on the first lookup
+  std::optional<bool> flat;
   std::uint32_t count{0};
 };
 
@@ -55,11 +62,14 @@ struct Page : Element {
 struct Annotation : Element {};
 
 struct Resources : Element {
+  std::unordered_map<std::string, ObjectReference> font_references;
+  /// fonts are parsed on first use
   std::unordered_map<std::string, Font *> font;
 };
 
 struct Font : Element {
-  CMap cmap;
+  /// owned by `Document::cmaps`; never null
+  const CMap *cmap{nullptr};
 };
 
 } // namespace odr::internal::pdf
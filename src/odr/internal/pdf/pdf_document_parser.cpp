@@ -1,14 +1,14 @@
 #include <odr/internal/pdf/pdf_document_parser.hpp>
 
-#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/pdf/pdf_cmap.hpp>
 #include <odr/internal/pdf/pdf_cmap_parser.hpp>
 #include <odr/internal/pdf/pdf_document.hpp>
 #include <odr/internal/pdf/pdf_document_element.hpp>
 #include <odr/internal/pdf/pdf_file_parser.hpp>
+#include <odr/internal/pdf/pdf_filter.hpp>
 
+#include <array>
 #include <functional>
-#include <iostream>
-#include <sstream>
 
 namespace odr::internal::pdf {
 namespace {
@@ -17,25 +17,39 @@ pdf::Element *parse_page_or_pages(DocumentParser &parser,
                                   const ObjectReference &reference,
                                   Document &document, Element *parent);
 
+std::uint64_t read_big_endian(std::string_view data, std::size_t offset,
+                              std::uint32_t width) {
+  std::uint64_t result = 0;
+  for (std::uint32_t i = 0; i < width; ++i) {
+    result = (result << 8) | static_cast<std::uint8_t>(data[offset + i]);
+  }
+  return result;
+}
+
 pdf::Font *parse_font(DocumentParser &parser, const ObjectReference &reference,
                       Document &document) {
   Font *font = document.create_element<Font>();
 
-  IndirectObject object = parser.read_object(reference);
+  const IndirectObject &object = parser.read_object(reference);
   const Dictionary &dictionary = object.object.as_dictionary();
 
   font->type = Type::font;
   font->object_reference = reference;
   font->object = Object(dictionary);
 
-  if (dictionary.has_key("ToUnicode")) {
-    IndirectObject to_unicode_obj =
-        parser.read_object(dictionary["ToUnicode"].as_reference());
-    std::string stream = parser.read_object_stream(to_unicode_obj);
-    std::string inflate = crypto::util::zlib_inflate(stream);
-    std::istringstream ss(inflate);
-    CMapParser cmap_parser(ss);
-    font->cmap = cmap_parser.parse_cmap();
+  if (const Object *to_unicode = dictionary.find("ToUnicode");
+      to_unicode != nullptr && to_unicode->is_reference()) {
+    std::unique_ptr<CMap> &cmap = document.cmaps[to_unicode->as_reference()];
+    if (cmap == nullptr) {
+      const IndirectObject &to_unicode_obj =
+          parser.read_object(to_unicode->as_reference());
+      std::string data = parser.read_decoded_object_stream(to_unicode_obj);
+      cmap = std::make_unique<CMap>(CMapParser(data).parse_cmap());
+    }
+    font->cmap = cmap.get();
+  } else {
+    static const CMap identity;
+    font->cmap = &identity;
   }
 
   return font;
@@ -54,7 +68,7 @@ pdf::Resources *parse_resources(DocumentParser &parser, const Object &object,
     Dictionary font_table =
         parser.resolve_object_copy(dictionary["Font"]).as_dictionary();
     for (const auto &[key, value] : font_table) {
-      resources->font[key] = parse_font(parser, value.as_reference(), document);
+      resources->font_references.emplace(key.string(), value.as_reference());
     }
   }
 
@@ -80,7 +94,7 @@ pdf::Page *parse_page(DocumentParser &parser, const ObjectReference &reference,
                       Document &document, Element *parent) {
   Page *page = document.create_element<Page>();
 
-  IndirectObject object = parser.read_object(reference);
+  const IndirectObject &object = parser.read_object(reference);
   const Dictionary &dictionary = object.object.as_dictionary();
 
   page->type = Type::page;
@@ -114,7 +128,7 @@ pdf::Pages *parse_pages(DocumentParser &parser,
                         const ObjectReference &reference, Document &document) {
   auto *pages = document.create_element<Pages>();
 
-  IndirectObject object = parser.read_object(reference);
+  const IndirectObject &object = parser.read_object(reference);
   const Dictionary &dictionary = object.object.as_dictionary();
 
   pages->type = Type::pages;
@@ -123,9 +137,10 @@ pdf::Pages *parse_pages(DocumentParser &parser,
   pages->count = dictionary["Count"].as_integer();
 
   for (const Object &kid : dictionary["Kids"].as_array()) {
-    pages->kids.push_back(
-        parse_page_or_pages(parser, kid.as_reference(), document, pages));
+    pages->kid_references.push_back(kid.as_reference());
   }
+  pages->kids.resize(pages->kid_references.size(), nullptr);
+  pages->kid_counts.resize(pages->kid_references.size());
 
   return pages;
 }
@@ -133,8 +148,7 @@ pdf::Pages *parse_pages(DocumentParser &parser,
 pdf::Element *parse_page_or_pages(DocumentParser &parser,
                                   const ObjectReference &reference,
                                   Document &document, Element *parent) {
-  // TODO we are parsing twice
-  IndirectObject object = parser.read_object(reference);
+  const IndirectObject &object = parser.read_object(reference);
   const Dictionary &dictionary = object.object.as_dictionary();
   const std::string &type = dictionary["Type"].as_string();
 
@@ -165,11 +179,77 @@ pdf::Catalog *parse_catalog(DocumentParser &parser,
   return catalog;
 }
 
-} // namespace
+Element *load_kid(DocumentParser &parser, Document &document, Pages &pages,
+                  std::size_t i) {
+  if (pages.kids[i] == nullptr) {
+    pages.kids[i] = parse_page_or_pages(parser, pages.kid_references[i],
+                                        document, &pages);
+  }
+  return pages.kids[i];
+}
+
+/// Number of pages below the `i`th kid without creating an element for it.
+std::uint32_t kid_page_count(DocumentParser &parser, Pages &pages,
+                             std::size_t i) {
+  std::optional<std::uint32_t> &count = pages.kid_counts[i];
+  if (count) {
+    return *count;
+  }
+
+  if (Element *kid = pages.kids[i]; kid != nullptr) {
+    count = kid->type == Type::pages ? static_cast<Pages *>(kid)->count : 1;
+    return *count;
+  }
+
+  const Dictionary &dictionary =
+      parser.read_object(pages.kid_references[i]).object.as_dictionary();
+  count = dictionary["Type"].as_name() == "Pages"
+              ? static_cast<std::uint32_t>(dictionary["Count"].as_integer())
+              : 1;
+  return *count;
+}
+
+/// True if every kid is a page, so that a page index is a kid index. The
+/// count alone does not tell, a node may hold empty and single page nodes.
+bool is_flat(DocumentParser &parser, Pages &pages) {
+  if (pages.flat) {
+    return *pages.flat;
+  }
+
+  pages.flat = pages.count == pages.kids.size();
+  for (std::size_t i = 0; i < pages.kids.size() && *pages.flat; ++i) {
+    if (Element *kid = pages.kids[i]; kid != nullptr) {
+      pages.flat = kid->type == Type::page;
+      continue;
+    }
+    const Dictionary &dictionary =
+        parser.read_object(pages.kid_references[i]).object.as_dictionary();
+    pages.flat = dictionary["Type"].as_name() == "Page";
+  }
+  return *pages.flat;
+}
 
-DocumentParser::DocumentParser(std::istream &in) : m_parser(in) {}
+void collect_pages(DocumentParser &parser, Document &document, Pages &pages,
+                   std::vector<Page *> &result,
+                   std::unordered_set<ObjectReference> &visited) {
+  for (std::size_t i = 0; i < pages.kids.size(); ++i) {
+    Element *kid = load_kid(parser, document, pages, i);
+    if (kid->type == Type::pages) {
+      // a malformed tree may list a node below itself
+      if (!visited.insert(kid->object_reference).second) {
+        continue;
+      }
+      collect_pages(parser, document, *static_cast<Pages *>(kid), result,
+                    visited);
+    } else {
+      result.push_back(static_cast<Page *>(kid));
+    }
+  }
+}
 
-std::istream &DocumentParser::in() const { return m_parser.in(); }
+} // namespace
+
+DocumentParser::DocumentParser(std::string_view data) : m_parser(data) {}
 
 const FileParser &DocumentParser::parser() const { return m_parser; }
 
@@ -181,19 +261,39 @@ DocumentParser::read_object(const ObjectReference &reference) {
     return it->second;
   }
 
-  std::uint32_t position = m_xref.table.at(reference).position;
-  in().seekg(position);
+  const Xref::Entry &entry = m_xref.table.at(reference);
+
+  if (entry.object_stream_id) {
+    const ObjectStream &object_stream =
+        read_compressed_object_stream(*entry.object_stream_id);
+    const auto &[id, offset] =
+        object_stream.objects.at(entry.object_stream_index);
+    if (id != reference.id) {
+      throw std::runtime_error("object stream index mismatch");
+    }
+
+    ObjectParser object_parser(object_stream.data);
+    object_parser.seek(offset);
+    IndirectObject object;
+    object.reference = reference;
+    object.object = object_parser.read_object();
+
+    return m_objects.emplace(reference, std::move(object)).first->second;
+  }
+
+  m_parser.parser().seek(entry.position);
   IndirectObject object = parser().read_indirect_object();
 
   return m_objects.emplace(reference, std::move(object)).first->second;
 }
 
-std::string
+std::string_view
 DocumentParser::read_object_stream(const ObjectReference &reference) {
   return read_object_stream(read_object(reference));
 }
 
-std::string DocumentParser::read_object_stream(const IndirectObject &object) {
+std::string_view
+DocumentParser::read_object_stream(const IndirectObject &object) {
   Object length = object.object.as_dictionary()["Length"];
   std::uint32_t size;
   if (length.is_integer()) {
@@ -204,30 +304,185 @@ std::string DocumentParser::read_object_stream(const IndirectObject &object) {
     throw std::runtime_error("unknown length property");
   }
 
-  in().seekg(object.stream_position.value());
+  m_parser.parser().seek(object.stream_position.value());
   return m_parser.read_stream(size);
 }
 
+std::unique_ptr<ByteSource>
+DocumentParser::open_object_stream(const IndirectObject &object) {
+  auto source = std::make_unique<MemorySource>(read_object_stream(object));
+  const Dictionary &dictionary = object.object.as_dictionary();
+
+  const Object *filter = dictionary.find("Filter");
+  if (filter == nullptr) {
+    return source;
+  }
+  const Object *decode_parms = dictionary.find("DecodeParms");
+  return open_filters(std::move(source), deep_resolve_object_copy(*filter),
+                      decode_parms != nullptr
+                          ? deep_resolve_object_copy(*decode_parms)
+                          : Object());
+}
+
+std::string
+DocumentParser::read_decoded_object_stream(const IndirectObject &object) {
+  std::string result;
+  read_all(*open_object_stream(object), result);
+  return result;
+}
+
+Trailer
+DocumentParser::read_xref_section(std::uint32_t position,
+                                  std::unordered_set<std::uint32_t> &visited) {
+  m_parser.parser().seek(position);
+  bool is_table = m_parser.parser().read_line().starts_with("xref");
+  m_parser.parser().seek(position);
+
+  if (!is_table) {
+    IndirectObject object = parser().read_indirect_object();
+    m_xref.append(read_xref_stream(object));
+
+    const Dictionary &dictionary = object.object.as_dictionary();
+    Trailer trailer;
+    trailer.size = dictionary["Size"].as_integer();
+    trailer.dictionary = dictionary;
+    return trailer;
+  }
+
+  Xref xref = parser().read_xref();
+  parser().parser().skip_whitespace();
+  Trailer trailer = parser().read_trailer();
+
+  // hybrid files list their compressed objects in an additional xref stream;
+  // the table marks them as free, so the stream has to be appended first
+  if (trailer.dictionary.has_key("XRefStm")) {
+    std::uint32_t xref_stream_position =
+        trailer.dictionary["XRefStm"].as_integer();
+    if (visited.insert(xref_stream_position).second) {
+      read_xref_section(xref_stream_position, visited);
+    }
+  }
+  m_xref.append(xref);
+
+  return trailer;
+}
+
+Xref DocumentParser::read_xref_stream(const IndirectObject &object) {
+  const Dictionary &dictionary = object.object.as_dictionary();
+  if (!dictionary.has_key("Type") || !dictionary["Type"].is_name() ||
+      dictionary["Type"].as_name() != "XRef") {
+    throw std::runtime_error("expected xref stream");
+  }
+
+  std::array<std::uint32_t, 3> widths{};
+  const Array &w = dictionary["W"].as_array();
+  for (std::size_t i = 0; i < widths.size(); ++i) {
+    widths[i] = w[i].as_integer();
+    if (widths[i] > 8) {
+      throw std::runtime_error("xref stream field too wide");
+    }
+  }
+  std::size_t entry_size = widths[0] + widths[1] + widths[2];
+
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> subsections;
+  if (dictionary.has_key("Index")) {
+    const Array &index = dictionary["Index"].as_array();
+    for (std::size_t i = 0; i + 1 < index.size(); i += 2) {
+      subsections.emplace_back(index[i].as_integer(),
+                               index[i + 1].as_integer());
+    }
+  } else {
+    subsections.emplace_back(0, dictionary["Size"].as_integer());
+  }
+
+  std::string data = read_decoded_object_stream(object);
+
+  Xref result;
+  std::size_t offset = 0;
+  for (const auto &[first_id, count] : subsections) {
+    for (std::uint64_t i = 0; i < count; ++i, offset += entry_size) {
+      if (offset + entry_size > data.size()) {
+        throw std::runtime_error("xref stream too short");
+      }
+
+      // a missing type field defaults to 1
+      std::uint64_t type =
+          widths[0] == 0 ? 1 : read_big_endian(data, offset, widths[0]);
+      std::uint64_t field2 =
+          read_big_endian(data, offset + widths[0], widths[1]);
+      std::uint64_t field3 =
+          read_big_endian(data, offset + widths[0] + widths[1], widths[2]);
+
+      Xref::Entry entry;
+      std::uint64_t generation = 0;
+      if (type == 1) {
+        entry.position = field2;
+        entry.in_use = true;
+        generation = field3;
+      } else if (type == 2) {
+        entry.in_use = true;
+        entry.object_stream_id = field2;
+        entry.object_stream_index = field3;
+      } else {
+        // free or unknown entries reference nothing
+        generation = field3;
+      }
+
+      result.table.emplace(ObjectReference(first_id + i, generation), entry);
+    }
+  }
+
+  return result;
+}
+
+const DocumentParser::ObjectStream &
+DocumentParser::read_compressed_object_stream(std::uint32_t id) {
+  if (auto it = m_object_streams.find(id); it != std::end(m_object_streams)) {
+    return it->second;
+  }
+
+  const IndirectObject &object = read_object(ObjectReference(id, 0));
+  const Dictionary &dictionary = object.object.as_dictionary();
+  auto count = static_cast<std::size_t>(dictionary["N"].as_integer());
+  auto first = static_cast<std::size_t>(dictionary["First"].as_integer());
+
+  ObjectStream result;
+  result.data = read_decoded_object_stream(object);
+
+  // the stream starts with pairs of object id and offset relative to `First`
+  ObjectParser header_parser(result.data);
+  result.objects.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    header_parser.skip_whitespace();
+    UnsignedInteger object_id = header_parser.read_unsigned_integer();
+    header_parser.skip_whitespace();
+    UnsignedInteger offset = header_parser.read_unsigned_integer();
+    result.objects.emplace_back(object_id, first + offset);
+  }
+
+  return m_object_streams.emplace(id, std::move(result)).first->second;
+}
+
 std::unique_ptr<Document> DocumentParser::parse_document() {
   parser().seek_start_xref();
   StartXref start_xref = parser().read_start_xref();
 
   std::uint32_t xref_position = start_xref.start;
   std::optional<Trailer> trailer;
+  // broken or malicious files may chain their sections into a cycle
+  std::unordered_set<std::uint32_t> visited{xref_position};
 
   while (true) {
-    in().seekg(xref_position);
-
-    m_xref.append(parser().read_xref());
-    parser().parser().skip_whitespace();
-    Trailer new_trailer = parser().read_trailer();
+    Trailer new_trailer = read_xref_section(xref_position, visited);
     if (!trailer) {
       trailer = new_trailer;
     }
 
     if (new_trailer.dictionary.has_key("Prev")) {
       xref_position = new_trailer.dictionary["Prev"].as_integer();
-      continue;
+      if (visited.insert(xref_position).second) {
+        continue;
+      }
     }
 
     break;
@@ -239,6 +494,77 @@ std::unique_ptr<Document> DocumentParser::parse_document() {
   return document;
 }
 
+std::uint32_t DocumentParser::page_count(const Document &document) const {
+  return document.catalog->pages->count;
+}
+
+Page *DocumentParser::page(Document &document, std::uint32_t index) {
+  if (index >= page_count(document)) {
+    throw std::out_of_range("page index out of range");
+  }
+
+  Pages *pages = document.catalog->pages;
+  // a malformed tree may list a node below itself
+  std::unordered_set<ObjectReference> visited{pages->object_reference};
+  while (true) {
+    if (is_flat(*this, *pages)) {
+      return static_cast<Page *>(load_kid(*this, document, *pages, index));
+    }
+
+    bool descended = false;
+    for (std::size_t i = 0; i < pages->kid_references.size(); ++i) {
+      std::uint32_t count = kid_page_count(*this, *pages, i);
+      if (index >= count) {
+        index -= count;
+        continue;
+      }
+
+      Element *kid = load_kid(*this, document, *pages, i);
+      if (kid->type == Type::page) {
+        return static_cast<Page *>(kid);
+      }
+      pages = static_cast<Pages *>(kid);
+      if (!visited.insert(pages->object_reference).second) {
+        throw std::runtime_error("cyclic page tree");
+      }
+      descended = true;
+      break;
+    }
+    if (!descended) {
+      throw std::runtime_error("page tree count mismatch");
+    }
+  }
+}
+
+std::vector<Page *> DocumentParser::pages(Document &document) {
+  std::vector<Page *> result;
+  result.reserve(page_count(document));
+  std::unordered_set<ObjectReference> visited{
+      document.catalog->pages->object_reference};
+  collect_pages(*this, document, *document.catalog->pages, result, visited);
+  return result;
+}
+
+Font *DocumentParser::font(Document &document, Resources &resources,
+                           const std::string &name) {
+  if (auto it = resources.font.find(name); it != std::end(resources.font)) {
+    return it->second;
+  }
+
+  const ObjectReference &reference = resources.font_references.at(name);
+  Font *font;
+  if (auto it = document.fonts.find(reference);
+      it != std::end(document.fonts)) {
+    font = it->second;
+  } else {
+    font = parse_font(*this, reference, document);
+    document.fonts.emplace(reference, font);
+  }
+
+  resources.font.emplace(name, font);
+  return font;
+}
+
 void DocumentParser::resolve_object(Object &object) {
   if (object.is_reference()) {
     object = read_object(object.as_reference()).object;
@@ -4,25 +4,34 @@
 #include <odr/internal/pdf/pdf_file_object.hpp>
 #include <odr/internal/pdf/pdf_file_parser.hpp>
 
-#include <iosfwd>
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace odr::internal::pdf {
 
+class ByteSource;
 struct Document;
+struct Page;
+struct Resources;
+struct Font;
 
 class DocumentParser {
 public:
-  DocumentParser(std::istream &);
+  /// `data` is the whole file and has to outlive the parser.
+  explicit DocumentParser(std::string_view data);
 
-  std::istream &in() const;
   const FileParser &parser() const;
   const Xref &xref() const;
 
   const IndirectObject &read_object(const ObjectReference &reference);
-  std::string read_object_stream(const ObjectReference &reference);
-  std::string read_object_stream(const IndirectObject &object);
+  std::string_view read_object_stream(const ObjectReference &reference);
+  std::string_view read_object_stream(const IndirectObject &object);
 
   void resolve_object(Object &object);
   void deep_resolve_object(Object &object);
@@ -30,12 +39,41 @@ public:
   Object resolve_object_copy(const Object &object);
   Object deep_resolve_object_copy(const Object &object);
 
+  /// Returns a source which decodes the stream payload through its `/Filter`
+  /// chain while it is read. It views the file data, not the parser.
+  std::unique_ptr<ByteSource> open_object_stream(const IndirectObject &object);
+  /// Returns the stream payload with its `/Filter` chain applied.
+  std::string read_decoded_object_stream(const IndirectObject &object);
+
+  /// Parses the cross-reference data, the catalog and the root of the page
+  /// tree. Everything else is parsed on demand.
   std::unique_ptr<Document> parse_document();
 
+  std::uint32_t page_count(const Document &document) const;
+  /// Descends the page tree using `/Count` to skip subtrees.
+  Page *page(Document &document, std::uint32_t index);
+  /// Loads the whole page tree in order.
+  std::vector<Page *> pages(Document &document);
+
+  Font *font(Document &document, Resources &resources,
+             const std::string &name);
+
 private:
+  struct ObjectStream {
+    std::string data;
+    /// object id and offset into `data` for every object in the stream
+    std::vector<std::pair<std::uint64_t, std::size_t>> objects;
+  };
+
   FileParser m_parser;
   Xref m_xref;
   std::map<ObjectReference, IndirectObject> m_objects;
+  std::unordered_map<std::uint32_t, ObjectStream> m_object_streams;
+
+  Trailer read_xref_section(std::uint32_t position,
+                            std::unordered_set<std::uint32_t> &visited);
+  Xref read_xref_stream(const IndirectObject &object);
+  const ObjectStream &read_compressed_object_stream(std::uint32_t id);
 };
 
 } // namespace odr::internal::pdf
@@ -1,5 +1,10 @@
 #include <odr/internal/pdf/pdf_file.hpp>
 
+#include <odr/internal/pdf/pdf_text.hpp>
+#include <odr/internal/util/stream_util.hpp>
+
+#include <istream>
+
 namespace odr::internal::pdf {
 
 PdfFile::PdfFile(std::shared_ptr<abstract::File> file)
@@ -19,4 +24,14 @@ FileType PdfFile::file_type() const noexcept {
 
 FileMeta PdfFile::file_meta() const noexcept { return {}; }
 
+void PdfFile::extract_text(std::ostream &out) const {
+  if (const char *memory_data = m_file->memory_data();
+      memory_data != nullptr) {
+    pdf::extract_text(std::string_view(memory_data, m_file->size()), out);
+    return;
+  }
+  std::string buffer = util::stream::read(*m_file->stream());
+  pdf::extract_text(buffer, out);
+}
+
 } // namespace odr::internal::pdf
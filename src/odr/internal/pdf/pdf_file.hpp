@@ -15,6 +15,8 @@ public:
   [[nodiscard]] FileCategory file_category() const noexcept final;
   [[nodiscard]] FileMeta file_meta() const noexcept final;
 
+  void extract_text(std::ostream &out) const;
+
 private:
   std::shared_ptr<abstract::File> m_file;
 };
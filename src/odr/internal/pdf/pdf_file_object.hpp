@@ -3,6 +3,7 @@
 
 #include <odr/internal/pdf/pdf_object.hpp>
 
+#include <any>
 #include <map>
 #include <optional>
 
@@ -29,6 +30,9 @@ struct Xref {
   struct Entry {
     std::uint32_t position{};
     bool in_use{};
+    /// set for objects stored inside an object stream (`/Type /ObjStm`)
+    std::optional<std::uint32_t> object_stream_id;
+    std::uint32_t object_stream_index{};
   };
   using Table = std::map<ObjectReference, Entry>;
 
@@ -1,19 +1,13 @@
 #include <odr/internal/pdf/pdf_file_parser.hpp>
 
 #include <odr/internal/pdf/pdf_file_object.hpp>
-#include <odr/internal/util/stream_util.hpp>
-#include <odr/internal/util/string_util.hpp>
 
-#include <iostream>
+#include <algorithm>
 #include <stdexcept>
 
 namespace odr::internal::pdf {
 
-FileParser::FileParser(std::istream &in) : m_parser(in) {}
-
-std::istream &FileParser::in() const { return m_parser.in(); }
-
-std::streambuf &FileParser::sb() const { return m_parser.sb(); }
+FileParser::FileParser(std::string_view data) : m_parser(data) {}
 
 const ObjectParser &FileParser::parser() const { return m_parser; }
 
@@ -24,7 +18,7 @@ IndirectObject FileParser::read_indirect_object() const {
   m_parser.skip_whitespace();
   result.reference.gen = m_parser.read_unsigned_integer();
   m_parser.skip_whitespace();
-  if (std::string line = m_parser.read_line(); line != "obj") {
+  if (std::string_view line = m_parser.read_line(); line != "obj") {
     throw std::runtime_error("expected obj");
   }
 
@@ -39,7 +33,7 @@ IndirectObject FileParser::read_indirect_object() const {
   }
   if (next == "stream") {
     result.has_stream = true;
-    result.stream_position = in().tellg();
+    result.stream_position = m_parser.position();
 
     m_parser.skip_whitespace();
     return result;
@@ -64,7 +58,7 @@ Trailer FileParser::read_trailer() const {
 }
 
 Xref FileParser::read_xref() const {
-  if (std::string line = m_parser.read_line(); line != "xref") {
+  if (std::string_view line = m_parser.read_line(); line != "xref") {
     throw std::runtime_error("expected xref");
   }
 
@@ -96,7 +90,7 @@ Xref FileParser::read_xref() const {
 }
 
 StartXref FileParser::read_start_xref() const {
-  if (std::string line = m_parser.read_line(); line != "startxref") {
+  if (std::string_view line = m_parser.read_line(); line != "startxref") {
     throw std::runtime_error("expected startxref");
   }
 
@@ -109,30 +103,36 @@ StartXref FileParser::read_start_xref() const {
   return result;
 }
 
-std::string FileParser::read_stream(std::int32_t size) const {
-  std::string result;
+std::string_view FileParser::read_stream(std::int32_t size) const {
+  std::string_view result;
 
   if (size >= 0) {
-    result = util::stream::read(in(), size);
+    result = m_parser.bumpnc(size);
 
     m_parser.skip_line();
 
-    if (std::string line = m_parser.read_line(); line != "endstream") {
+    if (std::string_view line = m_parser.read_line(); line != "endstream") {
       throw std::runtime_error("expected endstream");
     }
   } else {
-    // TODO improve poor solution
-    while (true) {
-      std::string line = m_parser.read_line(true);
-      if (line == "endstream\n") {
-        result.pop_back();
-        break;
-      }
-      result += line;
+    std::size_t begin = m_parser.position();
+    std::size_t end = m_parser.data().find("endstream", begin);
+    if (end == std::string_view::npos) {
+      throw std::runtime_error("expected endstream");
     }
+    result = m_parser.data().substr(begin, end - begin);
+    // the end-of-line marker before `endstream` is not part of the data
+    if (!result.empty() && result.back() == '\n') {
+      result.remove_suffix(1);
+    }
+    if (!result.empty() && result.back() == '\r') {
+      result.remove_suffix(1);
+    }
+    m_parser.seek(end);
+    m_parser.skip_line();
   }
 
-  if (std::string line = m_parser.read_line(); line != "endobj") {
+  if (std::string_view line = m_parser.read_line(); line != "endobj") {
     throw std::runtime_error("expected endobj");
   }
 
@@ -142,10 +142,11 @@ std::string FileParser::read_stream(std::int32_t size) const {
 }
 
 void FileParser::read_header() const {
-  std::string header1 = m_parser.read_line();
-  std::string header2 = m_parser.read_line();
+  std::string_view header1 = m_parser.read_line();
+  std::string_view header2 = m_parser.read_line();
+  (void)header2;
 
-  if (!util::string::starts_with(header1, "%PDF-")) {
+  if (!header1.starts_with("%PDF-")) {
     throw std::runtime_error("illegal header");
   }
 
@@ -153,11 +154,11 @@ void FileParser::read_header() const {
 }
 
 Entry FileParser::read_entry() const {
-  std::uint32_t position = in().tellg();
-  std::string entry_header = m_parser.read_line();
-  in().seekg(position);
+  std::uint32_t position = m_parser.position();
+  std::string_view entry_header = m_parser.read_line();
+  m_parser.seek(position);
 
-  if (util::string::ends_with(entry_header, "obj")) {
+  if (entry_header.ends_with("obj")) {
     return {read_indirect_object(), position};
   }
   if (entry_header == "xref") {
@@ -181,15 +182,14 @@ Entry FileParser::read_entry() const {
 }
 
 void FileParser::seek_start_xref(std::uint32_t margin) const {
-  in().seekg(0, std::ios::end);
-  std::int64_t size = in().tellg();
-  in().seekg(std::max((std::int64_t)0, size - margin), std::ios::beg);
+  std::size_t size = m_parser.data().size();
+  m_parser.seek(size - std::min<std::size_t>(size, margin));
 
-  while (!m_parser.in().eof()) {
-    std::uint32_t position = m_parser.in().tellg();
-    std::string line = m_parser.read_line();
+  while (!m_parser.at_end()) {
+    std::size_t position = m_parser.position();
+    std::string_view line = m_parser.read_line();
     if (line == "startxref") {
-      m_parser.in().seekg(position);
+      m_parser.seek(position);
       return;
     }
   }
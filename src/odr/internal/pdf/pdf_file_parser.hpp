@@ -3,7 +3,7 @@
 
 #include <odr/internal/pdf/pdf_object_parser.hpp>
 
-#include <iosfwd>
+#include <string_view>
 
 namespace odr::internal::pdf {
 
@@ -16,10 +16,8 @@ class Entry;
 
 class FileParser {
 public:
-  explicit FileParser(std::istream &);
+  explicit FileParser(std::string_view data);
 
-  std::istream &in() const;
-  std::streambuf &sb() const;
   const ObjectParser &parser() const;
 
   IndirectObject read_indirect_object() const;
@@ -27,7 +25,8 @@ public:
   Xref read_xref() const;
   StartXref read_start_xref() const;
 
-  std::string read_stream(std::int32_t size) const;
+  /// Returns a view of the stream payload inside the parsed buffer.
+  std::string_view read_stream(std::int32_t size) const;
 
   void read_header() const;
   Entry read_entry() const;
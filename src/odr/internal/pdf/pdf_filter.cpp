@@ -0,0 +1,515 @@
+#include <odr/internal/pdf/pdf_filter.hpp>
+
+#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/pdf/pdf_object.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace odr::internal::pdf {
+
+namespace {
+
+constexpr std::size_t chunk_size = 16384;
+
+/// Base for filters which decode their input byte by byte. `decode` appends
+/// the next few output bytes to `out` and returns `false` once it reached the
+/// end; the bytes appended by that last call are still delivered.
+class Filter : public ByteSource {
+public:
+  explicit Filter(std::unique_ptr<ByteSource> source)
+      : m_source{std::move(source)} {}
+
+  std::size_t read(char *buffer, std::size_t size) final {
+    std::size_t written = 0;
+    while (written < size) {
+      if (m_output_position == m_output.size()) {
+        if (m_finished) {
+          break;
+        }
+        m_output.clear();
+        m_output_position = 0;
+        m_finished = !decode(m_output);
+        continue;
+      }
+      std::size_t n =
+          std::min(size - written, m_output.size() - m_output_position);
+      std::memcpy(buffer + written, m_output.data() + m_output_position, n);
+      m_output_position += n;
+      written += n;
+    }
+    return written;
+  }
+
+protected:
+  /// Next input byte or -1 at the end of the input.
+  int get() {
+    if (m_input_position == m_input_size) {
+      m_input_size = m_source->read(m_input.data(), m_input.size());
+      m_input_position = 0;
+      if (m_input_size == 0) {
+        return -1;
+      }
+    }
+    return static_cast<std::uint8_t>(m_input[m_input_position++]);
+  }
+
+  /// Next input byte which is not PDF whitespace or -1 at the end.
+  int get_non_whitespace() {
+    while (true) {
+      int c = get();
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && c != '\f' &&
+          c != '\0') {
+        return c;
+      }
+    }
+  }
+
+  virtual bool decode(std::string &out) = 0;
+
+  std::unique_ptr<ByteSource> m_source;
+  std::array<char, chunk_size> m_input{};
+  std::size_t m_input_size{0};
+  std::size_t m_input_position{0};
+
+private:
+  std::string m_output;
+  std::size_t m_output_position{0};
+  bool m_finished{false};
+};
+
+class FlateDecode final : public Filter {
+public:
+  explicit FlateDecode(std::unique_ptr<ByteSource> source)
+      : Filter(std::move(source)), m_inflater{crypto::util::zlib_inflater()} {}
+
+private:
+  std::unique_ptr<crypto::util::Inflater> m_inflater;
+  /// input which was read but not inflated yet
+  std::string_view m_pending;
+  bool m_input_end{false};
+
+  bool decode(std::string &out) final {
+    out.resize(chunk_size);
+
+    std::size_t written = 0;
+    bool end = false;
+    while (written < out.size()) {
+      if (m_pending.empty() && !m_input_end) {
+        m_input_size = m_source->read(m_input.data(), m_input.size());
+        m_input_end = m_input_size == 0;
+        m_pending = {m_input.data(), m_input_size};
+      }
+
+      std::size_t space = out.size() - written;
+      std::size_t n =
+          m_inflater->inflate(m_pending, out.data() + written, space);
+      written += n;
+      // truncated streams are common; keep what was decoded
+      if (m_inflater->finished() ||
+          (n < space && m_pending.empty() && m_input_end)) {
+        end = true;
+        break;
+      }
+    }
+
+    out.resize(written);
+    return !end;
+  }
+};
+
+class AsciiHexDecode final : public Filter {
+public:
+  using Filter::Filter;
+
+private:
+  static int hex_value(int c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  }
+
+  bool decode(std::string &out) final {
+    int high = get_non_whitespace();
+    if (high == -1 || high == '>') {
+      return false;
+    }
+    int low = get_non_whitespace();
+    bool end = low == -1 || low == '>';
+    // a missing last digit counts as 0
+    int value = hex_value(high) << 4 | (end ? 0 : hex_value(low));
+    if (hex_value(high) < 0 || (!end && hex_value(low) < 0)) {
+      throw std::runtime_error("invalid ASCIIHexDecode data");
+    }
+    out += static_cast<char>(value);
+    return !end;
+  }
+};
+
+class Ascii85Decode final : public Filter {
+public:
+  using Filter::Filter;
+
+private:
+  bool decode(std::string &out) final {
+    std::uint32_t value = 0;
+    int count = 0;
+    while (count < 5) {
+      int c = get_non_whitespace();
+      if (c == 'z' && count == 0) {
+        out.append(4, '\0');
+        return true;
+      }
+      if (c == -1 || c == '~') {
+        break;
+      }
+      if (c < '!' || c > 'u') {
+        throw std::runtime_error("invalid ASCII85Decode data");
+      }
+      value = value * 85 + (c - '!');
+      ++count;
+    }
+
+    if (count == 0) {
+      return false;
+    }
+    if (count == 1) {
+      throw std::runtime_error("invalid ASCII85Decode data");
+    }
+    // a partial group is padded with 'u' and yields one byte less
+    for (int i = count; i < 5; ++i) {
+      value = value * 85 + ('u' - '!');
+    }
+    for (int i = 0; i < count - 1; ++i) {
+      out += static_cast<char>(value >> (24 - 8 * i));
+    }
+    return count == 5;
+  }
+};
+
+class LzwDecode final : public Filter {
+public:
+  LzwDecode(std::unique_ptr<ByteSource> source, bool early_change)
+      : Filter(std::move(source)), m_early_change{early_change ? 1u : 0u} {
+    for (std::uint32_t i = 0; i < 256; ++i) {
+      m_prefix[i] = -1;
+      m_suffix[i] = static_cast<std::uint8_t>(i);
+      m_first[i] = static_cast<std::uint8_t>(i);
+      m_length[i] = 1;
+    }
+  }
+
+private:
+  static constexpr std::uint32_t clear_table = 256;
+  static constexpr std::uint32_t end_of_data = 257;
+  static constexpr std::uint32_t table_size = 4096;
+
+  std::uint32_t m_early_change;
+  std::array<std::int32_t, table_size> m_prefix{};
+  std::array<std::uint8_t, table_size> m_suffix{};
+  std::array<std::uint8_t, table_size> m_first{};
+  std::array<std::uint16_t, table_size> m_length{};
+  std::uint32_t m_next{258};
+  std::uint32_t m_code_width{9};
+  std::int32_t m_previous{-1};
+  std::uint32_t m_bits{0};
+  std::uint32_t m_bit_count{0};
+
+  std::int32_t read_code() {
+    while (m_bit_count < m_code_width) {
+      int c = get();
+      if (c == -1) {
+        return -1;
+      }
+      m_bits = (m_bits << 8) | static_cast<std::uint32_t>(c);
+      m_bit_count += 8;
+    }
+    m_bit_count -= m_code_width;
+    return static_cast<std::int32_t>((m_bits >> m_bit_count) &
+                                     ((1u << m_code_width) - 1));
+  }
+
+  bool decode(std::string &out) final {
+    std::int32_t code = read_code();
+    if (code == -1 || code == end_of_data) {
+      return false;
+    }
+    if (code == clear_table) {
+      m_next = 258;
+      m_code_width = 9;
+      m_previous = -1;
+      return true;
+    }
+
+    auto unsigned_code = static_cast<std::uint32_t>(code);
+    if (m_previous != -1) {
+      if (unsigned_code > m_next) {
+        throw std::runtime_error("invalid LZWDecode data");
+      }
+      if (m_next < table_size) {
+        // the new entry is the previous string plus the first byte of the
+        // current one; for `code == m_next` both start the same
+        std::uint8_t first = unsigned_code == m_next ? m_first[m_previous]
+                                                     : m_first[unsigned_code];
+        m_prefix[m_next] = m_previous;
+        m_suffix[m_next] = first;
+        m_first[m_next] = m_first[m_previous];
+        m_length[m_next] = m_length[m_previous] + 1;
+        ++m_next;
+      }
+    } else if (unsigned_code > 255) {
+      throw std::runtime_error("invalid LZWDecode data");
+    }
+
+    std::size_t length = m_length[unsigned_code];
+    out.resize(length);
+    std::int32_t entry = code;
+    for (std::size_t i = length; i > 0; --i) {
+      out[i - 1] = static_cast<char>(m_suffix[entry]);
+      entry = m_prefix[entry];
+    }
+    m_previous = code;
+
+    std::uint32_t used = m_next + m_early_change;
+    m_code_width = used >= 2048  ? 12
+                   : used >= 1024 ? 11
+                   : used >= 512  ? 10
+                                  : 9;
+    return true;
+  }
+};
+
+class RunLengthDecode final : public Filter {
+public:
+  using Filter::Filter;
+
+private:
+  bool decode(std::string &out) final {
+    int length = get();
+    if (length == -1 || length == 128) {
+      return false;
+    }
+    if (length < 128) {
+      for (int i = 0; i <= length; ++i) {
+        int c = get();
+        if (c == -1) {
+          return false;
+        }
+        out += static_cast<char>(c);
+      }
+      return true;
+    }
+    int c = get();
+    if (c == -1) {
+      return false;
+    }
+    out.append(257 - length, static_cast<char>(c));
+    return true;
+  }
+};
+
+std::uint8_t paeth_predictor(std::uint8_t a, std::uint8_t b, std::uint8_t c) {
+  int p = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return a;
+  }
+  if (pb <= pc) {
+    return b;
+  }
+  return c;
+}
+
+/// Reverses the TIFF (`/Predictor` 2) and PNG (10 to 15) predictors one row
+/// at a time. PNG predictors are used by virtually every xref stream.
+class Predictor final : public Filter {
+public:
+  Predictor(std::unique_ptr<ByteSource> source, std::uint32_t predictor,
+            std::uint32_t colors, std::uint32_t bits_per_component,
+            std::uint32_t columns)
+      : Filter(std::move(source)), m_png{predictor >= 10}, m_colors{colors},
+        m_pixel_size{std::max<std::size_t>(1, colors * bits_per_component / 8)},
+        m_previous((colors * bits_per_component * columns + 7) / 8, '\0') {
+    if (!m_png && bits_per_component != 8) {
+      throw std::runtime_error("unsupported TIFF predictor bit depth");
+    }
+  }
+
+private:
+  bool m_png;
+  std::uint32_t m_colors;
+  std::size_t m_pixel_size;
+  std::string m_previous;
+
+  bool decode(std::string &out) final {
+    int type = 2;
+    if (m_png) {
+      type = get();
+      if (type == -1) {
+        return false;
+      }
+    }
+
+    std::size_t row_size = m_previous.size();
+    out.resize(row_size);
+    for (std::size_t i = 0; i < row_size; ++i) {
+      int c = get();
+      if (c == -1) {
+        out.resize(i);
+        return false;
+      }
+      out[i] = static_cast<char>(c);
+    }
+
+    if (!m_png) {
+      // TIFF: every component is the difference to the one on its left
+      for (std::size_t i = m_colors; i < row_size; ++i) {
+        out[i] = static_cast<char>(out[i] + out[i - m_colors]);
+      }
+      return true;
+    }
+
+    for (std::size_t i = 0; i < row_size; ++i) {
+      auto x = static_cast<std::uint8_t>(out[i]);
+      std::uint8_t a =
+          i >= m_pixel_size ? static_cast<std::uint8_t>(out[i - m_pixel_size])
+                            : 0;
+      auto b = static_cast<std::uint8_t>(m_previous[i]);
+      std::uint8_t c =
+          i >= m_pixel_size
+              ? static_cast<std::uint8_t>(m_previous[i - m_pixel_size])
+              : 0;
+      switch (type) {
+      case 0:
+        break;
+      case 1:
+        x += a;
+        break;
+      case 2:
+        x += b;
+        break;
+      case 3:
+        x += (a + b) / 2;
+        break;
+      case 4:
+        x += paeth_predictor(a, b, c);
+        break;
+      default:
+        throw std::runtime_error("unknown png predictor");
+      }
+      out[i] = static_cast<char>(x);
+    }
+    m_previous = out;
+    return true;
+  }
+};
+
+std::uint32_t parameter(const Object &parms, std::string_view name,
+                        std::uint32_t default_value) {
+  if (!parms.is_dictionary()) {
+    return default_value;
+  }
+  const Object *value = parms.as_dictionary().find(name);
+  return value != nullptr && value->is_integer()
+             ? static_cast<std::uint32_t>(value->as_integer())
+             : default_value;
+}
+
+std::unique_ptr<ByteSource> open_filter(std::unique_ptr<ByteSource> source,
+                                        const std::string &name,
+                                        const Object &parms) {
+  // the abbreviations are used by inline images
+  if (name == "FlateDecode" || name == "Fl") {
+    source = std::make_unique<FlateDecode>(std::move(source));
+  } else if (name == "LZWDecode" || name == "LZW") {
+    source = std::make_unique<LzwDecode>(std::move(source),
+                                         parameter(parms, "EarlyChange", 1));
+  } else if (name == "ASCIIHexDecode" || name == "AHx") {
+    return std::make_unique<AsciiHexDecode>(std::move(source));
+  } else if (name == "ASCII85Decode" || name == "A85") {
+    return std::make_unique<Ascii85Decode>(std::move(source));
+  } else if (name == "RunLengthDecode" || name == "RL") {
+    return std::make_unique<RunLengthDecode>(std::move(source));
+  } else {
+    throw std::runtime_error("unsupported stream filter " + name);
+  }
+
+  std::uint32_t predictor = parameter(parms, "Predictor", 1);
+  if (predictor == 1) {
+    return source;
+  }
+  if (predictor != 2 && predictor < 10) {
+    throw std::runtime_error("unsupported predictor");
+  }
+  return std::make_unique<Predictor>(
+      std::move(source), predictor, parameter(parms, "Colors", 1),
+      parameter(parms, "BitsPerComponent", 8), parameter(parms, "Columns", 1));
+}
+
+} // namespace
+
+MemorySource::MemorySource(std::string_view data) : m_data{data} {}
+
+std::size_t MemorySource::read(char *buffer, std::size_t size) {
+  std::size_t n = std::min(size, m_data.size());
+  std::memcpy(buffer, m_data.data(), n);
+  m_data.remove_prefix(n);
+  return n;
+}
+
+std::unique_ptr<ByteSource> open_filters(std::unique_ptr<ByteSource> source,
+                                         const Object &filter,
+                                         const Object &decode_parms) {
+  static const Object null;
+  // a single `/DecodeParms` dictionary goes with a single filter name
+  auto parms_at = [&](std::size_t i) -> const Object & {
+    if (!decode_parms.is_array()) {
+      return decode_parms;
+    }
+    const Array &parms = decode_parms.as_array();
+    return i < parms.size() ? parms[i] : null;
+  };
+
+  if (filter.is_name()) {
+    return open_filter(std::move(source), filter.as_name(), parms_at(0));
+  }
+  if (filter.is_array()) {
+    const Array &filters = filter.as_array();
+    for (std::size_t i = 0; i < filters.size(); ++i) {
+      source =
+          open_filter(std::move(source), filters[i].as_name(), parms_at(i));
+    }
+  }
+  return source;
+}
+
+void read_all(ByteSource &source, std::string &output) {
+  std::size_t size = output.size();
+  while (true) {
+    output.resize(size + chunk_size);
+    std::size_t n = source.read(output.data() + size, chunk_size);
+    size += n;
+    if (n == 0) {
+      break;
+    }
+  }
+  output.resize(size);
+}
+
+} // namespace odr::internal::pdf
@@ -0,0 +1,48 @@
+#ifndef ODR_INTERNAL_PDF_FILTER_HPP
+#define ODR_INTERNAL_PDF_FILTER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace odr::internal::pdf {
+
+class Object;
+
+/// Pull-based source of stream bytes. Filters wrap another source and decode
+/// only as much as the caller asks for.
+class ByteSource {
+public:
+  virtual ~ByteSource() = default;
+
+  /// Fills up to `size` bytes of `buffer` and returns how many were written.
+  /// Returns 0 only at the end of the data.
+  virtual std::size_t read(char *buffer, std::size_t size) = 0;
+};
+
+class MemorySource final : public ByteSource {
+public:
+  /// `data` has to outlive the source.
+  explicit MemorySource(std::string_view data);
+
+  std::size_t read(char *buffer, std::size_t size) final;
+
+private:
+  std::string_view m_data;
+};
+
+/// Wraps `source` with the decoders named by a stream's `/Filter` entry,
+/// which is a name or an array of names applied in order. `decode_parms` is
+/// the matching `/DecodeParms` entry or null. Both have to be resolved.
+/// Throws `std::runtime_error` for unsupported filters.
+std::unique_ptr<ByteSource> open_filters(std::unique_ptr<ByteSource> source,
+                                         const Object &filter,
+                                         const Object &decode_parms);
+
+/// Appends everything left in `source` to `output`.
+void read_all(ByteSource &source, std::string &output);
+
+} // namespace odr::internal::pdf
+
+#endif // ODR_INTERNAL_PDF_FILTER_HPP
@@ -3,8 +3,13 @@
 
 #include <odr/internal/pdf/pdf_object.hpp>
 
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <iosfwd>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -103,11 +108,52 @@ enum class GraphicsOperatorType {
   end_compat_sec,
 };
 
+/// Fixed capacity operand stack. Operands beyond `capacity` are dropped; no
+/// operator takes more than a DeviceN color with 32 components plus a name.
+class GraphicsOperands {
+public:
+  static constexpr std::size_t capacity = 33;
+
+  [[nodiscard]] std::size_t size() const { return m_size; }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+
+  [[nodiscard]] const Object &operator[](std::size_t i) const {
+    assert(i < m_size);
+    return m_values[i];
+  }
+  [[nodiscard]] const Object &at(std::size_t i) const {
+    if (i >= m_size) {
+      throw std::out_of_range("graphics operand");
+    }
+    return m_values[i];
+  }
+
+  [[nodiscard]] const Object *begin() const { return m_values.data(); }
+  [[nodiscard]] const Object *end() const { return m_values.data() + m_size; }
+
+  template <typename... Args> void emplace_back(Args &&...args) {
+    if (m_size < capacity) {
+      m_values[m_size++] = Object(std::forward<Args>(args)...);
+    }
+  }
+
+  void clear() {
+    for (std::size_t i = 0; i < m_size; ++i) {
+      m_values[i] = Object();
+    }
+    m_size = 0;
+  }
+
+private:
+  std::array<Object, capacity> m_values;
+  std::size_t m_size{0};
+};
+
 struct GraphicsOperator {
   using Argument = Object;
-  using Arguments = std::vector<Argument>;
+  using Arguments = GraphicsOperands;
 
-  GraphicsOperatorType type;
+  GraphicsOperatorType type{GraphicsOperatorType::unknown};
   Arguments arguments;
 };
 
@@ -1,143 +1,334 @@
 #include <odr/internal/pdf/pdf_graphics_operator_parser.hpp>
 
 #include <odr/internal/pdf/pdf_graphics_operator.hpp>
-#include <odr/internal/util/map_util.hpp>
+#include <odr/internal/pdf/pdf_trace.hpp>
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
 
 namespace odr::internal::pdf {
 
 namespace {
 
-GraphicsOperatorType operator_name_to_type(const std::string &name) {
-  static std::unordered_map<std::string, GraphicsOperatorType> mapping = {
-      {"q", GraphicsOperatorType::save_state},
-      {"Q", GraphicsOperatorType::restore_state},
-
-      {"cm", GraphicsOperatorType::set_matrix},
-
-      {"w", GraphicsOperatorType::set_line_width},
-      {"J", GraphicsOperatorType::set_cap_style},
-      {"j", GraphicsOperatorType::set_join_style},
-      {"M", GraphicsOperatorType::set_miter_limit},
-      {"d", GraphicsOperatorType::set_dash_pattern},
-      {"ri", GraphicsOperatorType::set_color_rendering_intent},
-      {"i", GraphicsOperatorType::set_flatness_tolerance},
-      {"gm", GraphicsOperatorType::set_graphics_state_parameters},
-
-      {"Do", GraphicsOperatorType::draw_object},
-      {"BI", GraphicsOperatorType::begin_inline_image},
-      {"ID", GraphicsOperatorType::begin_inline_image_data},
-      {"EI", GraphicsOperatorType::end_inline_image},
-
-      {"m", GraphicsOperatorType::path_move_to},
-      {"l", GraphicsOperatorType::path_line_to},
-      {"c", GraphicsOperatorType::path_cubic_bezier_to},
-      {"v", GraphicsOperatorType::path_cubic_bezier_0eq1_to},
-      {"y", GraphicsOperatorType::path_cubic_bezier_2eq3_to},
-      {"h", GraphicsOperatorType::close_path},
-      {"re", GraphicsOperatorType::rectangle},
-
-      {"W", GraphicsOperatorType::set_clipping_nonzero},
-      {"W*", GraphicsOperatorType::set_clipping_evenodd},
-      {"sh", GraphicsOperatorType::set_clipping_path_shading},
-
-      {"S", GraphicsOperatorType::stroke},
-      {"s", GraphicsOperatorType::close_stroke},
-      {"f", GraphicsOperatorType::fill_nonzero},
-      {"F", GraphicsOperatorType::fill_nonzero},
-      {"f*", GraphicsOperatorType::fill_evenodd},
-      {"B", GraphicsOperatorType::fill_nonzero_stroke},
-      {"B*", GraphicsOperatorType::fill_evenodd_stroke},
-      {"b", GraphicsOperatorType::close_fill_nonzero_stroke},
-      {"b*", GraphicsOperatorType::close_fill_evenodd_stroke},
-      {"n", GraphicsOperatorType::end_path},
-
-      {"BT", GraphicsOperatorType::begin_text},
-      {"ET", GraphicsOperatorType::end_text},
-
-      {"Tc", GraphicsOperatorType::set_text_char_spacing},
-      {"Tw", GraphicsOperatorType::set_text_word_spacing},
-      {"Tz", GraphicsOperatorType::set_text_horizontal_scaling},
-      {"TL", GraphicsOperatorType::set_text_leading},
-      {"Tf", GraphicsOperatorType::set_text_font_size},
-      {"Tr", GraphicsOperatorType::set_text_rendering_mode},
-      {"Ts", GraphicsOperatorType::set_text_rise},
-
-      {"Td", GraphicsOperatorType::text_next_line_relative},
-      {"TD", GraphicsOperatorType::text_next_line_relative_leading},
-      {"Tm", GraphicsOperatorType::set_text_matrix},
-      {"T*", GraphicsOperatorType::text_next_line},
-
-      {"Tj", GraphicsOperatorType::show_text},
-      {"TJ", GraphicsOperatorType::show_text_manual_spacing},
-      {"'", GraphicsOperatorType::show_text_next_line},
-      {"\"", GraphicsOperatorType::show_text_next_line_set_spacing},
-
-      {"CS", GraphicsOperatorType::set_stroke_color_space},
-      {"SC", GraphicsOperatorType::set_stroke_color},
-      {"SCN", GraphicsOperatorType::set_stroke_color_name},
-      {"G", GraphicsOperatorType::set_stroke_grey_color},
-      {"RG", GraphicsOperatorType::set_stroke_rgb_color},
-      {"K", GraphicsOperatorType::set_stroke_cmyk_color},
-
-      {"cs", GraphicsOperatorType::set_other_color_space},
-      {"sc", GraphicsOperatorType::set_other_color},
-      {"scn", GraphicsOperatorType::set_other_color_name},
-      {"g", GraphicsOperatorType::set_other_grey_color},
-      {"rg", GraphicsOperatorType::set_other_rgb_color},
-      {"k", GraphicsOperatorType::set_other_cmyk_color},
-
-      {"d0", GraphicsOperatorType::set_glyph_width},
-      {"d1", GraphicsOperatorType::set_glyph_width_bounding_box},
-
-      {"MP", GraphicsOperatorType::marked_content_point},
-      {"DP", GraphicsOperatorType::point_with_props},
-      {"BMC", GraphicsOperatorType::begin_marked_content_seq},
-      {"BDC", GraphicsOperatorType::begin_marked_content_seq_props},
-      {"EMC", GraphicsOperatorType::end_marked_content_seq},
-
-      {"BX", GraphicsOperatorType::begin_compat_sec},
-      {"EX", GraphicsOperatorType::end_compat_sec},
-  };
+/// Operator names are 1-3 bytes, packed little-endian into an integer.
+constexpr std::uint32_t pack_operator_name(std::string_view name) {
+  std::uint32_t result = 0;
+  for (std::size_t i = 0; i < name.size(); ++i) {
+    result |= static_cast<std::uint32_t>(static_cast<unsigned char>(name[i]))
+              << (8 * i);
+  }
+  return result;
+}
+
+/// Multiplicative hash which happens to be collision free for the operators
+/// below; checked by the `static_assert` after the table.
+constexpr std::size_t operator_hash(std::uint32_t key) {
+  return (key * 0x1e428f67u) >> 24;
+}
+
+struct OperatorEntry {
+  std::uint32_t key{0};
+  GraphicsOperatorType type{GraphicsOperatorType::unknown};
+};
+
+constexpr std::pair<std::string_view, GraphicsOperatorType> operators[] = {
+    {"q", GraphicsOperatorType::save_state},
+    {"Q", GraphicsOperatorType::restore_state},
+
+    {"cm", GraphicsOperatorType::set_matrix},
+
+    {"w", GraphicsOperatorType::set_line_width},
+    {"J", GraphicsOperatorType::set_cap_style},
+    {"j", GraphicsOperatorType::set_join_style},
+    {"M", GraphicsOperatorType::set_miter_limit},
+    {"d", GraphicsOperatorType::set_dash_pattern},
+    {"ri", GraphicsOperatorType::set_color_rendering_intent},
+    {"i", GraphicsOperatorType::set_flatness_tolerance},
+    {"gm", GraphicsOperatorType::set_graphics_state_parameters},
+
+    {"Do", GraphicsOperatorType::draw_object},
+    {"BI", GraphicsOperatorType::begin_inline_image},
+    {"ID", GraphicsOperatorType::begin_inline_image_data},
+    {"EI", GraphicsOperatorType::end_inline_image},
+
+    {"m", GraphicsOperatorType::path_move_to},
+    {"l", GraphicsOperatorType::path_line_to},
+    {"c", GraphicsOperatorType::path_cubic_bezier_to},
+    {"v", GraphicsOperatorType::path_cubic_bezier_0eq1_to},
+    {"y", GraphicsOperatorType::path_cubic_bezier_2eq3_to},
+    {"h", GraphicsOperatorType::close_path},
+    {"re", GraphicsOperatorType::rectangle},
+
+    {"W", GraphicsOperatorType::set_clipping_nonzero},
+    {"W*", GraphicsOperatorType::set_clipping_evenodd},
+    {"sh", GraphicsOperatorType::set_clipping_path_shading},
+
+    {"S", GraphicsOperatorType::stroke},
+    {"s", GraphicsOperatorType::close_stroke},
+    {"f", GraphicsOperatorType::fill_nonzero},
+    {"F", GraphicsOperatorType::fill_nonzero},
+    {"f*", GraphicsOperatorType::fill_evenodd},
+    {"B", GraphicsOperatorType::fill_nonzero_stroke},
+    {"B*", GraphicsOperatorType::fill_evenodd_stroke},
+    {"b", GraphicsOperatorType::close_fill_nonzero_stroke},
+    {"b*", GraphicsOperatorType::close_fill_evenodd_stroke},
+    {"n", GraphicsOperatorType::end_path},
+
+    {"BT", GraphicsOperatorType::begin_text},
+    {"ET", GraphicsOperatorType::end_text},
+
+    {"Tc", GraphicsOperatorType::set_text_char_spacing},
+    {"Tw", GraphicsOperatorType::set_text_word_spacing},
+    {"Tz", GraphicsOperatorType::set_text_horizontal_scaling},
+    {"TL", GraphicsOperatorType::set_text_leading},
+    {"Tf", GraphicsOperatorType::set_text_font_size},
+    {"Tr", GraphicsOperatorType::set_text_rendering_mode},
+    {"Ts", GraphicsOperatorType::set_text_rise},
+
+    {"Td", GraphicsOperatorType::text_next_line_relative},
+    {"TD", GraphicsOperatorType::text_next_line_relative_leading},
+    {"Tm", GraphicsOperatorType::set_text_matrix},
+    {"T*", GraphicsOperatorType::text_next_line},
+
+    {"Tj", GraphicsOperatorType::show_text},
+    {"TJ", GraphicsOperatorType::show_text_manual_spacing},
+    {"'", GraphicsOperatorType::show_text_next_line},
+    {"\"", GraphicsOperatorType::show_text_next_line_set_spacing},
+
+    {"CS", GraphicsOperatorType::set_stroke_color_space},
+    {"SC", GraphicsOperatorType::set_stroke_color},
+    {"SCN", GraphicsOperatorType::set_stroke_color_name},
+    {"G", GraphicsOperatorType::set_stroke_grey_color},
+    {"RG", GraphicsOperatorType::set_stroke_rgb_color},
+    {"K", GraphicsOperatorType::set_stroke_cmyk_color},
+
+    {"cs", GraphicsOperatorType::set_other_color_space},
+    {"sc", GraphicsOperatorType::set_other_color},
+    {"scn", GraphicsOperatorType::set_other_color_name},
+    {"g", GraphicsOperatorType::set_other_grey_color},
+    {"rg", GraphicsOperatorType::set_other_rgb_color},
+    {"k", GraphicsOperatorType::set_other_cmyk_color},
+
+    {"d0", GraphicsOperatorType::set_glyph_width},
+    {"d1", GraphicsOperatorType::set_glyph_width_bounding_box},
+
+    {"MP", GraphicsOperatorType::marked_content_point},
+    {"DP", GraphicsOperatorType::point_with_props},
+    {"BMC", GraphicsOperatorType::begin_marked_content_seq},
+    {"BDC", GraphicsOperatorType::begin_marked_content_seq_props},
+    {"EMC", GraphicsOperatorType::end_marked_content_seq},
+
+    {"BX", GraphicsOperatorType::begin_compat_sec},
+    {"EX", GraphicsOperatorType::end_compat_sec},
+};
+
+constexpr std::array<OperatorEntry, 256> build_operator_table() {
+  std::array<OperatorEntry, 256> result{};
+  for (const auto &[name, type] : operators) {
+    std::uint32_t key = pack_operator_name(name);
+    result[operator_hash(key)] = {key, type};
+  }
+  return result;
+}
+
+constexpr std::array<OperatorEntry, 256> operator_table =
+    build_operator_table();
 
-  return util::map::lookup_default(mapping, name,
-                                   GraphicsOperatorType::unknown);
+constexpr bool operator_table_complete() {
+  for (const auto &[name, type] : operators) {
+    if (operator_table[operator_hash(pack_operator_name(name))].key !=
+        pack_operator_name(name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(operator_table_complete(), "operator hash has collisions");
+
+GraphicsOperatorType operator_name_to_type(std::string_view name) {
+  if (name.empty() || name.size() > 3) {
+    return GraphicsOperatorType::unknown;
+  }
+  std::uint32_t key = pack_operator_name(name);
+  const OperatorEntry &entry = operator_table[operator_hash(key)];
+  return entry.key == key ? entry.type : GraphicsOperatorType::unknown;
 }
 
 } // namespace
 
-using char_type = std::streambuf::char_type;
-using int_type = std::streambuf::int_type;
-static constexpr int_type eof = std::streambuf::traits_type::eof();
+using char_type = ObjectParser::char_type;
 
-GraphicsOperatorParser::GraphicsOperatorParser(std::istream &in)
-    : m_parser(in) {}
+namespace {
 
-std::istream &GraphicsOperatorParser::in() const { return m_parser.in(); }
+/// Neither whitespace nor a delimiter.
+bool is_regular(char_type c) {
+  switch (c) {
+  case '(':
+  case ')':
+  case '<':
+  case '>':
+  case '[':
+  case ']':
+  case '{':
+  case '}':
+  case '/':
+  case '%':
+    return false;
+  default:
+    return !ObjectParser::is_whitespace(c);
+  }
+}
 
-std::streambuf &GraphicsOperatorParser::sb() const { return m_parser.sb(); }
+} // namespace
 
-std::string GraphicsOperatorParser::read_operator_name() const {
-  std::string result;
+GraphicsOperatorParser::GraphicsOperatorParser(std::string_view data)
+    : m_parser(data) {}
 
-  while (true) {
-    int_type c = m_parser.geti();
+bool GraphicsOperatorParser::at_end() const { return m_parser.at_end(); }
+
+std::string_view GraphicsOperatorParser::read_operator_name() const {
+  std::string_view data = m_parser.data();
+  std::size_t begin = m_parser.position();
+  std::size_t end = begin;
+
+  while (end < data.size() && is_regular(data[end])) {
+    ++end;
+  }
+  // a stray delimiter; consume it so the parser keeps moving
+  if (end == begin && end < data.size()) {
+    ++end;
+  }
 
-    if (c == eof) {
-      return result;
+  return m_parser.bumpnc(end - begin);
+}
+
+std::size_t GraphicsOperatorParser::skip_operands() const {
+  std::string_view data = m_parser.data();
+  std::size_t position = m_parser.position();
+  std::size_t first_operand = std::string_view::npos;
+  std::uint32_t depth = 0;
+
+  auto skip_regular = [&] {
+    while (position < data.size() && is_regular(data[position])) {
+      ++position;
     }
-    if (c == ' ' || c == '\n' || c == '/' || c == '<' || c == '[') {
-      return result;
+  };
+
+  while (position < data.size()) {
+    char_type c = data[position];
+    char_type next = position + 1 < data.size() ? data[position + 1] : '\0';
+
+    if (ObjectParser::is_whitespace(c)) {
+      ++position;
+      continue;
+    }
+    if (c == '%') {
+      while (position < data.size() && data[position] != '\n' &&
+             data[position] != '\r') {
+        ++position;
+      }
+      continue;
     }
 
-    m_parser.bumpc();
-    result += (char_type)c;
+    std::size_t start = position;
+    if (c == '(') {
+      // literal strings nest balanced parentheses and escape the rest
+      std::uint32_t parentheses = 0;
+      for (; position < data.size(); ++position) {
+        if (data[position] == '\\') {
+          ++position;
+        } else if (data[position] == '(') {
+          ++parentheses;
+        } else if (data[position] == ')' && --parentheses == 0) {
+          ++position;
+          break;
+        }
+      }
+    } else if (c == '<' && next == '<') {
+      ++depth;
+      position += 2;
+    } else if (c == '>' && next == '>' && depth > 0) {
+      --depth;
+      position += 2;
+    } else if (c == '<') {
+      position = std::min(data.find('>', position), data.size());
+      ++position;
+    } else if (c == '[') {
+      ++depth;
+      ++position;
+    } else if (c == ']' && depth > 0) {
+      --depth;
+      ++position;
+    } else if (c == '/') {
+      ++position;
+      skip_regular();
+    } else if (depth > 0 || c == '+' || c == '-' || c == '.' ||
+               (c >= '0' && c <= '9')) {
+      skip_regular();
+    } else {
+      break;
+    }
+    first_operand = std::min(first_operand, start);
+  }
+
+  position = std::min(position, data.size());
+  m_parser.seek(position);
+  return std::min(first_operand, position);
+}
+
+void GraphicsOperatorParser::read_operator(GraphicsOperator &result,
+                                           OperatorFilter wanted) const {
+  std::size_t begin = skip_operands();
+
+  std::string_view operator_name = read_operator_name();
+  GraphicsOperatorType type = operator_name_to_type(operator_name);
+  if (wanted(type)) {
+    m_parser.seek(begin);
+    read_operator(result);
+    return;
+  }
+
+  result.arguments.clear();
+  result.type = type;
+  if (type == GraphicsOperatorType::unknown) {
+    ODR_PDF_TRACE_EVENT(type, operator_name);
   }
+
+  if (type == GraphicsOperatorType::begin_inline_image_data) {
+    // binary image data up to `EI` surrounded by whitespace
+    std::string_view data = m_parser.data();
+    std::size_t position = m_parser.position() + 1;
+    while (true) {
+      position = data.find("EI", position);
+      if (position == std::string_view::npos) {
+        position = data.size();
+        break;
+      }
+      if (ObjectParser::is_whitespace(data[position - 1]) &&
+          (position + 2 == data.size() ||
+           ObjectParser::is_whitespace(data[position + 2]))) {
+        break;
+      }
+      position += 2;
+    }
+    m_parser.seek(position);
+    return;
+  }
+
+  m_parser.skip_whitespace();
 }
 
 GraphicsOperator GraphicsOperatorParser::read_operator() const {
   GraphicsOperator result;
+  read_operator(result);
+  return result;
+}
+
+void GraphicsOperatorParser::read_operator(GraphicsOperator &result) const {
+  result.arguments.clear();
 
   while (true) {
     if (m_parser.peek_number()) {
@@ -159,15 +350,13 @@ GraphicsOperator GraphicsOperatorParser::read_operator() const {
     m_parser.skip_whitespace();
   }
 
-  std::string operator_name = read_operator_name();
+  std::string_view operator_name = read_operator_name();
   result.type = operator_name_to_type(operator_name);
   if (result.type == GraphicsOperatorType::unknown) {
-    std::cerr << "unknown operator: " << operator_name << std::endl;
+    ODR_PDF_TRACE_EVENT(result.type, operator_name);
   }
 
   m_parser.skip_whitespace();
-
-  return result;
 }
 
 } // namespace odr::internal::pdf
@@ -3,7 +3,8 @@
 
 #include <odr/internal/pdf/pdf_object_parser.hpp>
 
-#include <iostream>
+#include <cstddef>
+#include <string_view>
 
 namespace odr::internal::pdf {
 
@@ -15,17 +16,27 @@ struct GraphicsOperator;
 
 class GraphicsOperatorParser {
 public:
-  GraphicsOperatorParser(std::istream &);
+  explicit GraphicsOperatorParser(std::string_view data);
 
-  std::istream &in() const;
-  std::streambuf &sb() const;
+  bool at_end() const;
 
-  std::string read_operator_name() const;
+  std::string_view read_operator_name() const;
 
   GraphicsOperator read_operator() const;
+  /// Reuses the operand storage of `result`.
+  void read_operator(GraphicsOperator &result) const;
+
+  using OperatorFilter = bool (*)(GraphicsOperatorType);
+  /// Only parses the operands of operators for which `wanted` returns true.
+  /// The operands of all others are skipped without building objects and
+  /// `result.arguments` is left empty. Inline image data is skipped as well.
+  void read_operator(GraphicsOperator &result, OperatorFilter wanted) const;
 
 private:
   ObjectParser m_parser;
+
+  /// Returns where the first operand starts, past whitespace and comments.
+  std::size_t skip_operands() const;
 };
 
 } // namespace odr::internal::pdf
@@ -1,9 +1,9 @@
 #include <odr/internal/pdf/pdf_graphics_state.hpp>
 
 #include <odr/internal/pdf/pdf_graphics_operator.hpp>
+#include <odr/internal/pdf/pdf_trace.hpp>
 #include <odr/internal/util/map_util.hpp>
 
-#include <iostream>
 #include <unordered_map>
 
 namespace odr::internal::pdf {
@@ -58,7 +58,7 @@ void GraphicsState::execute(const GraphicsOperator &op) {
     current().general.miter_limit = op.arguments.at(0).as_real();
     break;
   case GraphicsOperatorType::set_dash_pattern:
-    std::cout << "dash pattern not implemented" << std::endl;
+    ODR_PDF_TRACE_EVENT(op.type, "dash pattern not implemented");
     break;
   case GraphicsOperatorType::set_color_rendering_intent:
     current().general.color_rendering_intent = op.arguments.at(0).as_real();
@@ -143,11 +143,11 @@ void GraphicsState::execute(const GraphicsOperator &op) {
     break;
   case GraphicsOperatorType::set_stroke_color:
     // TODO
-    std::cout << "stroke color not implemented" << std::endl;
+    ODR_PDF_TRACE_EVENT(op.type, "stroke color not implemented");
     break;
   case GraphicsOperatorType::set_stroke_color_name:
     // TODO
-    std::cout << "stroke color name not implemented" << std::endl;
+    ODR_PDF_TRACE_EVENT(op.type, "stroke color name not implemented");
     break;
   case GraphicsOperatorType::set_stroke_grey_color:
     current().stroke_color.grey = op.arguments.at(0).as_real();
@@ -169,11 +169,11 @@ void GraphicsState::execute(const GraphicsOperator &op) {
     break;
   case GraphicsOperatorType::set_other_color:
     // TODO
-    std::cout << "other color not implemented" << std::endl;
+    ODR_PDF_TRACE_EVENT(op.type, "other color not implemented");
     break;
   case GraphicsOperatorType::set_other_color_name:
     // TODO
-    std::cout << "other color name not implemented" << std::endl;
+    ODR_PDF_TRACE_EVENT(op.type, "other color name not implemented");
     break;
   case GraphicsOperatorType::set_other_grey_color:
     current().other_color.grey = op.arguments.at(0).as_real();
@@ -2,12 +2,76 @@
 
 #include <odr/internal/util/hash_util.hpp>
 
+#include <algorithm>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <sstream>
+#include <shared_mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace odr::internal::pdf {
+namespace {
+
+class NameTable {
+public:
+  static NameTable &instance() {
+    // never destroyed since names may outlive static destruction
+    static NameTable *instance = new NameTable;
+    return *instance;
+  }
+
+  std::shared_ptr<const Name::Atom> find(std::string_view string) const {
+    std::shared_lock lock(m_mutex);
+    if (auto it = m_index.find(string); it != std::end(m_index)) {
+      return it->second.lock();
+    }
+    return nullptr;
+  }
+
+  std::shared_ptr<const Name::Atom> intern(std::string_view string) {
+    if (auto atom = find(string); atom != nullptr) {
+      return atom;
+    }
+
+    std::unique_lock lock(m_mutex);
+    if (auto it = m_index.find(string); it != std::end(m_index)) {
+      if (auto atom = it->second.lock(); atom != nullptr) {
+        return atom;
+      }
+      // the last name is about to release it; `release` leaves the new atom
+      m_index.erase(it);
+    }
+    std::shared_ptr<const Name::Atom> atom(
+        new Name::Atom{std::string(string), m_next_id++},
+        [this](const Name::Atom *released) { release(released); });
+    m_index.emplace(atom->string, atom);
+    return atom;
+  }
+
+private:
+  mutable std::shared_mutex m_mutex;
+  /// keys point into the atoms
+  std::unordered_map<std::string_view, std::weak_ptr<const Name::Atom>>
+      m_index;
+  std::uint64_t m_next_id{0};
+
+  void release(const Name::Atom *atom) {
+    {
+      std::unique_lock lock(m_mutex);
+      if (auto it = m_index.find(atom->string);
+          it != std::end(m_index) &&
+          it->first.data() == atom->string.data()) {
+        m_index.erase(it);
+      }
+    }
+    delete atom;
+  }
+};
+
+} // namespace
 
 void StandardString::to_stream(std::ostream &out) const {
   // TODO escape
@@ -31,7 +95,17 @@ std::string HexString::to_string() const {
   return ss.str();
 }
 
-void Name::to_stream(std::ostream &out) const { out << "/" << string; }
+Name::Name(std::string_view string)
+    : m_atom{NameTable::instance().intern(string)} {}
+
+std::optional<Name> Name::find(std::string_view string) {
+  if (auto atom = NameTable::instance().find(string); atom != nullptr) {
+    return Name(std::move(atom));
+  }
+  return std::nullopt;
+}
+
+void Name::to_stream(std::ostream &out) const { out << "/" << string(); }
 
 std::string Name::to_string() const {
   std::ostringstream ss;
@@ -39,6 +113,10 @@ std::string Name::to_string() const {
   return ss.str();
 }
 
+bool ObjectReference::operator==(const ObjectReference &rhs) const {
+  return id == rhs.id && gen == rhs.gen;
+}
+
 bool ObjectReference::operator<(const ObjectReference &rhs) const {
   return id != rhs.id ? id < rhs.id : gen < rhs.gen;
 }
@@ -59,10 +137,6 @@ std::string ObjectReference::to_string() const {
   return ss.str();
 }
 
-Object::Object(Array array) : m_holder{std::move(array)} {}
-
-Object::Object(Dictionary dictionary) : m_holder{std::move(dictionary)} {}
-
 const std::string &Object::as_string() const {
   if (is_standard_string()) {
     return as_standard_string();
@@ -87,11 +161,11 @@ void Object::to_stream(std::ostream &out) const {
   } else if (is_real()) {
     out << std::setprecision(4) << as_real();
   } else if (is_standard_string()) {
-    as<const StandardString &>().to_stream(out);
+    as<StandardString>().to_stream(out);
   } else if (is_hex_string()) {
-    as<const HexString &>().to_stream(out);
+    as<HexString>().to_stream(out);
   } else if (is_name()) {
-    as<const Name &>().to_stream(out);
+    as<Name>().to_stream(out);
   } else if (is_array()) {
     as_array().to_stream(out);
   } else if (is_dictionary()) {
@@ -126,11 +200,68 @@ std::string Array::to_string() const {
   return ss.str();
 }
 
+Dictionary::Dictionary(Holder holder) : m_holder{std::move(holder)} {
+  std::stable_sort(
+      std::begin(m_holder), std::end(m_holder),
+      [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+  m_holder.erase(std::unique(std::begin(m_holder), std::end(m_holder),
+                             [](const auto &lhs, const auto &rhs) {
+                               return lhs.first == rhs.first;
+                             }),
+                 std::end(m_holder));
+}
+
+const Object *Dictionary::find(const Name &name) const {
+  auto it = std::lower_bound(
+      std::begin(m_holder), std::end(m_holder), name,
+      [](const auto &entry, const Name &key) { return entry.first < key; });
+  if (it == std::end(m_holder) || !(it->first == name)) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+const Object *Dictionary::find(std::string_view name) const {
+  // a name which is not alive cannot be a key
+  if (std::optional<Name> atom = Name::find(name)) {
+    return find(*atom);
+  }
+  return nullptr;
+}
+
+Object &Dictionary::operator[](const Name &name) {
+  auto it = std::lower_bound(
+      std::begin(m_holder), std::end(m_holder), name,
+      [](const auto &entry, const Name &key) { return entry.first < key; });
+  if (it == std::end(m_holder) || !(it->first == name)) {
+    it = m_holder.emplace(it, name, Object());
+  }
+  return it->second;
+}
+
+Object &Dictionary::operator[](std::string_view name) {
+  return (*this)[Name(name)];
+}
+
+const Object &Dictionary::operator[](const Name &name) const {
+  if (const Object *object = find(name); object != nullptr) {
+    return *object;
+  }
+  throw std::out_of_range("dictionary key not found: " + name.string());
+}
+
+const Object &Dictionary::operator[](std::string_view name) const {
+  if (const Object *object = find(name); object != nullptr) {
+    return *object;
+  }
+  throw std::out_of_range("dictionary key not found: " + std::string(name));
+}
+
 void Dictionary::to_stream(std::ostream &out) const {
   out << "<<";
 
   for (const auto &[key, value] : *this) {
-    out << "/" << key;
+    key.to_stream(out);
     out << " ";
     value.to_stream(out);
     out << " ";
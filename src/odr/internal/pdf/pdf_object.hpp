@@ -1,11 +1,13 @@
 #ifndef ODR_INTERNAL_PDF_OBJECT_HPP
 #define ODR_INTERNAL_PDF_OBJECT_HPP
 
-#include <any>
 #include <cstdint>
 #include <iosfwd>
-#include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -34,13 +36,40 @@ struct HexString {
   [[nodiscard]] std::string to_string() const;
 };
 
-struct Name {
-  std::string string;
+/// Names are interned into a process wide atom table. Comparing them is cheap
+/// and dictionary lookups compare atoms instead of strings. The table only
+/// holds names which are alive; an atom is dropped together with the last
+/// name referring to it, so names of documents which are gone do not pile up.
+class Name {
+public:
+  struct Atom {
+    std::string string;
+    std::uint64_t id{};
+  };
+
+  explicit Name(std::string_view string);
 
-  explicit Name(std::string _string) : string{std::move(_string)} {}
+  /// Looks up a name without interning `string`. Returns `std::nullopt` if
+  /// no name with this spelling is alive.
+  [[nodiscard]] static std::optional<Name> find(std::string_view string);
+
+  [[nodiscard]] std::uint64_t id() const { return m_atom->id; }
+  [[nodiscard]] const std::string &string() const { return m_atom->string; }
+
+  [[nodiscard]] bool operator==(const Name &rhs) const {
+    return m_atom == rhs.m_atom;
+  }
+  [[nodiscard]] bool operator<(const Name &rhs) const {
+    return id() < rhs.id();
+  }
 
   void to_stream(std::ostream &) const;
   [[nodiscard]] std::string to_string() const;
+
+private:
+  explicit Name(std::shared_ptr<const Atom> atom) : m_atom{std::move(atom)} {}
+
+  std::shared_ptr<const Atom> m_atom;
 };
 
 struct ObjectReference {
@@ -50,6 +79,7 @@ struct ObjectReference {
   ObjectReference() = default;
   ObjectReference(std::uint64_t _id, std::uint64_t _gen) : id{_id}, gen{_gen} {}
 
+  [[nodiscard]] bool operator==(const ObjectReference &rhs) const;
   [[nodiscard]] bool operator<(const ObjectReference &rhs) const;
 
   [[nodiscard]] std::size_t hash() const noexcept;
@@ -58,12 +88,77 @@ struct ObjectReference {
   [[nodiscard]] std::string to_string() const;
 };
 
-class Array;
-class Dictionary;
+class Object;
+
+class Array {
+public:
+  using Holder = std::vector<Object>;
+
+  Array() = default;
+  explicit Array(Holder holder);
+
+  [[nodiscard]] Holder &holder() { return m_holder; }
+  [[nodiscard]] const Holder &holder() const { return m_holder; }
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] Holder::iterator begin();
+  [[nodiscard]] Holder::iterator end();
+  [[nodiscard]] Holder::const_iterator begin() const;
+  [[nodiscard]] Holder::const_iterator end() const;
+
+  Object &operator[](std::size_t i);
+  const Object &operator[](std::size_t i) const;
+
+  void to_stream(std::ostream &) const;
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  Holder m_holder;
+};
+
+/// Small flat map sorted by name atom id. PDF dictionaries rarely have more
+/// than a dozen entries so a binary search beats a tree.
+class Dictionary {
+public:
+  using Holder = std::vector<std::pair<Name, Object>>;
+
+  Dictionary() = default;
+  /// Sorts `holder`; for duplicate keys the first entry wins.
+  explicit Dictionary(Holder holder);
+
+  Holder &holder() { return m_holder; }
+  [[nodiscard]] const Holder &holder() const { return m_holder; }
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] Holder::iterator begin();
+  [[nodiscard]] Holder::iterator end();
+  [[nodiscard]] Holder::const_iterator begin() const;
+  [[nodiscard]] Holder::const_iterator end() const;
+
+  [[nodiscard]] const Object *find(const Name &name) const;
+  [[nodiscard]] const Object *find(std::string_view name) const;
+
+  Object &operator[](const Name &name);
+  Object &operator[](std::string_view name);
+  const Object &operator[](const Name &name) const;
+  const Object &operator[](std::string_view name) const;
+
+  [[nodiscard]] bool has_key(std::string_view name) const {
+    return find(name) != nullptr;
+  }
+
+  void to_stream(std::ostream &) const;
+  [[nodiscard]] std::string to_string() const;
+
+private:
+  Holder m_holder;
+};
 
 class Object {
 public:
-  using Holder = std::any;
+  using Holder =
+      std::variant<std::monostate, Boolean, Integer, Real, StandardString,
+                   HexString, Name, Array, Dictionary, ObjectReference>;
 
   Object() = default;
   explicit Object(Boolean boolean) : m_holder{boolean} {}
@@ -71,15 +166,15 @@ public:
   explicit Object(Real real) : m_holder{real} {}
   explicit Object(StandardString string) : m_holder{std::move(string)} {}
   explicit Object(HexString string) : m_holder{std::move(string)} {}
-  explicit Object(Name name) : m_holder{std::move(name)} {}
-  explicit Object(Array);
-  explicit Object(Dictionary);
+  explicit Object(Name name) : m_holder{name} {}
+  explicit Object(Array array) : m_holder{std::move(array)} {}
+  explicit Object(Dictionary dictionary) : m_holder{std::move(dictionary)} {}
   explicit Object(ObjectReference reference) : m_holder{reference} {}
 
   [[nodiscard]] Holder &holder() { return m_holder; }
   [[nodiscard]] const Holder &holder() const { return m_holder; }
 
-  [[nodiscard]] bool is_null() const { return !m_holder.has_value(); }
+  [[nodiscard]] bool is_null() const { return is<std::monostate>(); }
   [[nodiscard]] bool is_bool() const { return is<Boolean>(); }
   [[nodiscard]] bool is_integer() const { return is<Integer>(); }
   [[nodiscard]] bool is_real() const { return is<Real>() || is_integer(); }
@@ -96,32 +191,32 @@ public:
   [[nodiscard]] Boolean as_bool() const { return as<Boolean>(); }
   [[nodiscard]] Integer as_integer() const { return as<Integer>(); }
   [[nodiscard]] Real as_real() const {
-    return is<Real>() ? as<Real>() : as_integer();
+    return is<Real>() ? as<Real>() : static_cast<Real>(as_integer());
   }
   [[nodiscard]] const std::string &as_standard_string() const {
-    return as<const StandardString &>().string;
+    return as<StandardString>().string;
   }
   [[nodiscard]] const std::string &as_hex_string() const {
-    return as<const HexString &>().string;
+    return as<HexString>().string;
   }
   [[nodiscard]] const std::string &as_name() const {
-    return as<const Name &>().string;
+    return as<Name>().string();
   }
   [[nodiscard]] const std::string &as_string() const;
-  [[nodiscard]] const Array &as_array() const & { return as<const Array &>(); }
+  [[nodiscard]] const Array &as_array() const & { return as<Array>(); }
   [[nodiscard]] const Dictionary &as_dictionary() const & {
-    return as<const Dictionary &>();
+    return as<Dictionary>();
   }
   [[nodiscard]] const ObjectReference &as_reference() const {
-    return as<const ObjectReference &>();
+    return as<ObjectReference>();
   }
 
-  Array &as_array() & { return as<Array &>(); }
-  Dictionary &as_dictionary() & { return as<Dictionary &>(); }
+  Array &as_array() & { return as<Array>(); }
+  Dictionary &as_dictionary() & { return as<Dictionary>(); }
 
-  Array &&as_array() && { return std::move(*this).as<Array &&>(); }
+  Array &&as_array() && { return std::get<Array>(std::move(m_holder)); }
   Dictionary &&as_dictionary() && {
-    return std::move(*this).as<Dictionary &&>();
+    return std::get<Dictionary>(std::move(m_holder));
   }
 
   void to_stream(std::ostream &) const;
@@ -130,80 +225,41 @@ public:
 private:
   Holder m_holder;
 
-  template <typename T> bool is() const { return m_holder.type() == typeid(T); }
-  template <typename T> T as() const & { return std::any_cast<T>(m_holder); }
-  template <typename T> T as() & { return std::any_cast<T>(m_holder); }
-  template <typename T> T as() && {
-    return std::any_cast<T>(std::move(m_holder));
-  }
-};
-
-class Array {
-public:
-  using Holder = std::vector<Object>;
-
-  Array() = default;
-  explicit Array(Holder holder) : m_holder{std::move(holder)} {}
-  Array(const Array &) = default;
-  Array(Array &&) = default;
-
-  Array &operator=(const Array &) = default;
-  Array &operator=(Array &&) = default;
-
-  [[nodiscard]] Holder &holder() { return m_holder; }
-  [[nodiscard]] const Holder &holder() const { return m_holder; }
-
-  [[nodiscard]] std::size_t size() const { return m_holder.size(); }
-  [[nodiscard]] Holder::iterator begin() { return m_holder.begin(); }
-  [[nodiscard]] Holder::iterator end() { return m_holder.end(); }
-  [[nodiscard]] Holder::const_iterator begin() const {
-    return m_holder.cbegin();
+  template <typename T> bool is() const {
+    return std::holds_alternative<T>(m_holder);
   }
-  [[nodiscard]] Holder::const_iterator end() const { return m_holder.cend(); }
-
-  Object &operator[](std::size_t i) { return m_holder.at(i); }
-  const Object &operator[](std::size_t i) const { return m_holder.at(i); }
-
-  void to_stream(std::ostream &) const;
-  [[nodiscard]] std::string to_string() const;
-
-private:
-  Holder m_holder;
+  template <typename T> const T &as() const { return std::get<T>(m_holder); }
+  template <typename T> T &as() { return std::get<T>(m_holder); }
 };
 
-class Dictionary {
-public:
-  using Holder = std::map<std::string, Object>;
-
-  Dictionary() = default;
-  explicit Dictionary(Holder holder) : m_holder{std::move(holder)} {}
-
-  Holder &holder() { return m_holder; }
-  [[nodiscard]] const Holder &holder() const { return m_holder; }
-
-  [[nodiscard]] std::size_t size() const { return m_holder.size(); }
-  [[nodiscard]] Holder::iterator begin() { return m_holder.begin(); }
-  [[nodiscard]] Holder::iterator end() { return m_holder.end(); }
-  [[nodiscard]] Holder::const_iterator begin() const {
-    return m_holder.cbegin();
-  }
-  [[nodiscard]] Holder::const_iterator end() const { return m_holder.cend(); }
-
-  Object &operator[](const std::string &name) { return m_holder[name]; }
-  const Object &operator[](const std::string &name) const {
-    return m_holder.at(name);
-  }
-
-  [[nodiscard]] bool has_key(const std::string &name) const {
-    return m_holder.find(name) != std::end(m_holder);
-  }
-
-  void to_stream(std::ostream &) const;
-  [[nodiscard]] std::string to_string() const;
-
-private:
-  Holder m_holder;
-};
+inline Array::Array(Holder holder) : m_holder{std::move(holder)} {}
+
+inline std::size_t Array::size() const { return m_holder.size(); }
+inline Array::Holder::iterator Array::begin() { return m_holder.begin(); }
+inline Array::Holder::iterator Array::end() { return m_holder.end(); }
+inline Array::Holder::const_iterator Array::begin() const {
+  return m_holder.cbegin();
+}
+inline Array::Holder::const_iterator Array::end() const {
+  return m_holder.cend();
+}
+
+inline Object &Array::operator[](std::size_t i) { return m_holder.at(i); }
+inline const Object &Array::operator[](std::size_t i) const {
+  return m_holder.at(i);
+}
+
+inline std::size_t Dictionary::size() const { return m_holder.size(); }
+inline Dictionary::Holder::iterator Dictionary::begin() {
+  return m_holder.begin();
+}
+inline Dictionary::Holder::iterator Dictionary::end() { return m_holder.end(); }
+inline Dictionary::Holder::const_iterator Dictionary::begin() const {
+  return m_holder.cbegin();
+}
+inline Dictionary::Holder::const_iterator Dictionary::end() const {
+  return m_holder.cend();
+}
 
 std::ostream &operator<<(std::ostream &, const StandardString &);
 std::ostream &operator<<(std::ostream &, const HexString &);
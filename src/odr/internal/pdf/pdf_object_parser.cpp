@@ -1,60 +1,61 @@
 #include <odr/internal/pdf/pdf_object_parser.hpp>
 
-#include <odr/internal/util/stream_util.hpp>
-
+#include <cctype>
 #include <cmath>
-#include <iostream>
-#include <sstream>
 #include <stdexcept>
 
 namespace odr::internal::pdf {
 
-ObjectParser::ObjectParser(std::istream &in)
-    : m_in{&in}, m_se(in, true), m_sb{in.rdbuf()} {}
+ObjectParser::ObjectParser(std::string_view data) : m_data{data} {}
+
+std::string_view ObjectParser::data() const { return m_data; }
+
+std::size_t ObjectParser::position() const { return m_position; }
 
-std::istream &ObjectParser::in() const { return *m_in; }
+void ObjectParser::seek(std::size_t position) const {
+  if (position > m_data.size()) {
+    throw std::runtime_error("seek out of range");
+  }
+  m_position = position;
+}
 
-std::streambuf &ObjectParser::sb() const { return *m_sb; }
+bool ObjectParser::at_end() const { return m_position >= m_data.size(); }
 
 ObjectParser::int_type ObjectParser::geti() const {
-  int_type c = sb().sgetc();
-  if (c == eof) {
-    in().setstate(std::ios::eofbit);
+  if (m_position >= m_data.size()) {
+    return eof;
   }
-  return c;
+  return static_cast<unsigned char>(m_data[m_position]);
 }
 
 ObjectParser::char_type ObjectParser::getc() const {
-  int_type c = sb().sgetc();
-  if (c == eof) {
-    in().setstate(std::ios::eofbit);
+  if (m_position >= m_data.size()) {
     throw std::runtime_error("unexpected stream exhaust");
   }
-  return static_cast<char_type>(c);
+  return m_data[m_position];
 }
 
 ObjectParser::char_type ObjectParser::bumpc() const {
-  int_type c = sb().sbumpc();
-  if (c == eof) {
-    in().setstate(std::ios::eofbit);
+  if (m_position >= m_data.size()) {
     throw std::runtime_error("unexpected stream exhaust");
   }
-  return static_cast<char_type>(c);
+  return m_data[m_position++];
 }
 
-std::string ObjectParser::bumpnc(std::size_t n) const {
-  std::string result(n, '\0');
-  auto m = static_cast<std::streamsize>(n);
-  if (sb().sgetn(result.data(), m) != m) {
+std::string_view ObjectParser::bumpnc(std::size_t n) const {
+  if (m_data.size() - m_position < n) {
     throw std::runtime_error("unexpected stream exhaust");
   }
+  std::string_view result = m_data.substr(m_position, n);
+  m_position += n;
   return result;
 }
 
 void ObjectParser::ungetc() const {
-  if (sb().sungetc() == eof) {
+  if (m_position == 0) {
     throw std::runtime_error("unexpected stream exhaust");
   }
+  --m_position;
 }
 
 ObjectParser::int_type ObjectParser::octet_char_to_int(char_type c) {
@@ -110,16 +111,29 @@ void ObjectParser::skip_whitespace() const {
 
 void ObjectParser::skip_line() const { read_line(); }
 
-std::string ObjectParser::read_line(bool inclusive) const {
-  return util::stream::read_line(in(), inclusive);
+std::string_view ObjectParser::read_line(bool inclusive) const {
+  std::size_t begin = m_position;
+  std::size_t end = m_data.find_first_of("\r\n", begin);
+  if (end == std::string_view::npos) {
+    m_position = m_data.size();
+    return m_data.substr(begin);
+  }
+
+  m_position = end + 1;
+  if (m_data[end] == '\r' && m_position < m_data.size() &&
+      m_data[m_position] == '\n') {
+    ++m_position;
+  }
+  return m_data.substr(begin, (inclusive ? m_position : end) - begin);
 }
 
-void ObjectParser::expect_characters(const std::string &string) const {
+void ObjectParser::expect_characters(std::string_view string) const {
   auto observed = bumpnc(string.size());
   if (observed != string) {
     throw std::runtime_error("unexpected characters"
                              " (expected: " +
-                             string + ", observed: " + observed + ")");
+                             std::string(string) +
+                             ", observed: " + std::string(observed) + ")");
   }
 }
 
@@ -177,12 +191,13 @@ std::variant<Integer, Real> ObjectParser::read_integer_or_real() const {
   }
   bumpc();
 
-  pos_type begin = in().tellg();
+  std::size_t begin = m_position;
   UnsignedInteger i2 = read_unsigned_integer();
-  pos_type end = in().tellg();
+  std::size_t end = m_position;
 
   return static_cast<Real>(i) +
-         static_cast<Real>(i2) * std::pow(10.0, begin - end);
+         static_cast<Real>(i2) *
+             std::pow(10.0, -static_cast<double>(end - begin));
 }
 
 bool ObjectParser::peek_name() const {
@@ -190,39 +205,49 @@ bool ObjectParser::peek_name() const {
   return c == '/';
 }
 
-void ObjectParser::read_name(std::ostream &out) const {
+Name ObjectParser::read_name() const {
   if (char_type c = bumpc(); c != '/') {
     throw std::runtime_error("not a name");
   }
 
+  std::size_t begin = m_position;
+  // only names with `#` escapes need a copy
+  std::string unescaped;
+  bool escaped = false;
+
   while (true) {
     int_type i = geti();
 
     if (i == eof) {
-      return;
+      break;
     }
     auto c = static_cast<char_type>(i);
     if (c < 0x21 || c > 0x7e || c == '/' || c == '%' || c == '(' || c == ')' ||
         c == '<' || c == '>' || c == '[' || c == ']' || c == '{' || c == '}') {
-      return;
+      break;
     }
 
     if (c == '#') {
+      if (!escaped) {
+        unescaped = m_data.substr(begin, m_position - begin);
+        escaped = true;
+      }
       bumpc();
       auto hex = bumpnc<2>();
-      out.put(two_hex_to_char(hex[0], hex[1]));
+      unescaped += two_hex_to_char(hex[0], hex[1]);
       continue;
     }
 
-    out.put(c);
+    if (escaped) {
+      unescaped += c;
+    }
     bumpc();
   }
-}
 
-Name ObjectParser::read_name() const {
-  std::stringstream ss;
-  read_name(ss);
-  return Name(ss.str());
+  if (escaped) {
+    return Name(unescaped);
+  }
+  return Name(m_data.substr(begin, m_position - begin));
 }
 
 bool ObjectParser::peek_null() const {
@@ -412,7 +437,7 @@ Dictionary ObjectParser::read_dictionary() const {
       value = Object(ObjectReference{id, gen});
     }
 
-    result.emplace(std::move(name.string), std::move(value));
+    result.emplace_back(name, std::move(value));
   }
 }
 
@@ -3,36 +3,40 @@
 
 #include <odr/internal/pdf/pdf_object.hpp>
 
+#include <algorithm>
 #include <array>
-#include <istream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <variant>
 
 namespace odr::internal::pdf {
 
+/// Tokenizer over an in-memory buffer. The buffer is not copied and has to
+/// outlive the parser.
 class ObjectParser {
 public:
-  using char_type = std::streambuf::char_type;
-  using int_type = std::streambuf::int_type;
-  static constexpr int_type eof = std::streambuf::traits_type::eof();
-  using pos_type = std::streambuf::pos_type;
+  using char_type = std::string_view::value_type;
+  using int_type = std::string_view::traits_type::int_type;
+  static constexpr int_type eof = std::string_view::traits_type::eof();
 
-  explicit ObjectParser(std::istream &);
+  explicit ObjectParser(std::string_view data);
 
-  std::istream &in() const;
-  std::streambuf &sb() const;
+  std::string_view data() const;
+  std::size_t position() const;
+  void seek(std::size_t position) const;
+  bool at_end() const;
 
   int_type geti() const;
   char_type getc() const;
   char_type bumpc() const;
   template <std::uint32_t N> std::array<char, N> bumpnc() const {
     std::array<char, N> result;
-    if (sb().sgetn(result.data(), result.size()) != result.size()) {
-      throw std::runtime_error("unexpected stream exhaust");
-    }
+    std::string_view view = bumpnc(N);
+    std::copy(std::begin(view), std::end(view), std::begin(result));
     return result;
   }
-  std::string bumpnc(std::size_t n) const;
+  std::string_view bumpnc(std::size_t n) const;
   void ungetc() const;
 
   static int_type octet_char_to_int(char_type c);
@@ -45,8 +49,8 @@ public:
   bool peek_whitespace() const;
   void skip_whitespace() const;
   void skip_line() const;
-  std::string read_line(bool inclusive = false) const;
-  void expect_characters(const std::string &string) const;
+  std::string_view read_line(bool inclusive = false) const;
+  void expect_characters(std::string_view string) const;
 
   bool peek_number() const;
   UnsignedInteger read_unsigned_integer() const;
@@ -55,7 +59,6 @@ public:
   std::variant<Integer, Real> read_integer_or_real() const;
 
   bool peek_name() const;
-  void read_name(std::ostream &) const;
   Name read_name() const;
 
   bool peek_null() const;
@@ -78,9 +81,8 @@ public:
   ObjectReference read_object_reference() const;
 
 private:
-  std::istream *m_in;
-  std::istream::sentry m_se;
-  std::streambuf *m_sb;
+  std::string_view m_data;
+  mutable std::size_t m_position{0};
 };
 
 } // namespace odr::internal::pdf
@@ -0,0 +1,193 @@
+#include <odr/internal/pdf/pdf_text.hpp>
+
+#include <odr/internal/pdf/pdf_cmap.hpp>
+#include <odr/internal/pdf/pdf_document.hpp>
+#include <odr/internal/pdf/pdf_document_element.hpp>
+#include <odr/internal/pdf/pdf_document_parser.hpp>
+#include <odr/internal/pdf/pdf_filter.hpp>
+#include <odr/internal/pdf/pdf_graphics_operator.hpp>
+#include <odr/internal/pdf/pdf_graphics_operator_parser.hpp>
+#include <odr/internal/pdf/pdf_graphics_state.hpp>
+
+#include <ostream>
+#include <string>
+
+namespace odr::internal::pdf {
+
+namespace {
+
+bool is_text_operator(GraphicsOperatorType type) {
+  switch (type) {
+  case GraphicsOperatorType::save_state:
+  case GraphicsOperatorType::restore_state:
+  case GraphicsOperatorType::begin_text:
+  case GraphicsOperatorType::end_text:
+  case GraphicsOperatorType::set_text_leading:
+  case GraphicsOperatorType::set_text_font_size:
+  case GraphicsOperatorType::text_next_line_relative:
+  case GraphicsOperatorType::text_next_line_relative_leading:
+  case GraphicsOperatorType::set_text_matrix:
+  case GraphicsOperatorType::text_next_line:
+  case GraphicsOperatorType::show_text:
+  case GraphicsOperatorType::show_text_manual_spacing:
+  case GraphicsOperatorType::show_text_next_line:
+  case GraphicsOperatorType::show_text_next_line_set_spacing:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// `TJ` adjustments are in thousandths of an em; larger gaps than this are
+/// taken as word breaks.
+constexpr double word_gap = 200;
+
+class PageTextExtractor {
+public:
+  PageTextExtractor(DocumentParser &parser, Document &document, Page &page,
+                    std::ostream &out)
+      : m_parser{parser}, m_document{document}, m_page{page}, m_out{out} {}
+
+  void extract(std::string_view content) {
+    GraphicsOperatorParser parser(content);
+    GraphicsState state;
+    GraphicsOperator op;
+    while (!parser.at_end()) {
+      parser.read_operator(op, is_text_operator);
+      if (op.type == GraphicsOperatorType::unknown ||
+          !is_text_operator(op.type)) {
+        continue;
+      }
+      state.execute(op);
+      handle(state, op);
+    }
+    new_line();
+  }
+
+private:
+  DocumentParser &m_parser;
+  Document &m_document;
+  Page &m_page;
+  std::ostream &m_out;
+  std::string m_line;
+
+  /// baseline of the text position and of the current line
+  double m_y{0};
+  double m_line_y{0};
+
+  void new_line() {
+    if (!m_line.empty() && m_line.back() == ' ') {
+      m_line.pop_back();
+    }
+    if (!m_line.empty()) {
+      m_line += '\n';
+      m_out << m_line;
+      m_line.clear();
+    }
+  }
+
+  void space() {
+    if (!m_line.empty() && m_line.back() != ' ') {
+      m_line += ' ';
+    }
+  }
+
+  void show(const GraphicsState &state, const Object &glyphs) {
+    if (!glyphs.is_string() || m_page.resources == nullptr) {
+      return;
+    }
+    const std::string &font_name = state.current().text.font;
+    if (m_page.resources->font_references.find(font_name) ==
+        std::end(m_page.resources->font_references)) {
+      return;
+    }
+
+    if (m_y != m_line_y) {
+      new_line();
+      m_line_y = m_y;
+    }
+    Font *font = m_parser.font(m_document, *m_page.resources, font_name);
+    font->cmap->translate_string(glyphs.as_string(), m_line);
+  }
+
+  void handle(const GraphicsState &state, const GraphicsOperator &op) {
+    const GraphicsOperands &arguments = op.arguments;
+    double leading = state.current().text.leading;
+
+    switch (op.type) {
+    case GraphicsOperatorType::begin_text:
+      m_y = 0;
+      break;
+    case GraphicsOperatorType::set_text_matrix:
+      if (arguments.size() >= 6 && arguments[5].is_real()) {
+        m_y = arguments[5].as_real();
+      }
+      space();
+      break;
+    case GraphicsOperatorType::text_next_line_relative:
+    case GraphicsOperatorType::text_next_line_relative_leading:
+      if (arguments.size() >= 2 && arguments[1].is_real()) {
+        m_y += arguments[1].as_real();
+      }
+      space();
+      break;
+    case GraphicsOperatorType::text_next_line:
+      m_y -= leading;
+      break;
+    case GraphicsOperatorType::show_text:
+      if (!arguments.empty()) {
+        show(state, arguments[0]);
+      }
+      break;
+    case GraphicsOperatorType::show_text_next_line:
+      m_y -= leading;
+      if (!arguments.empty()) {
+        show(state, arguments[0]);
+      }
+      break;
+    case GraphicsOperatorType::show_text_next_line_set_spacing:
+      m_y -= leading;
+      if (arguments.size() >= 3) {
+        show(state, arguments[2]);
+      }
+      break;
+    case GraphicsOperatorType::show_text_manual_spacing:
+      if (arguments.empty() || !arguments[0].is_array()) {
+        break;
+      }
+      for (const Object &element : arguments[0].as_array()) {
+        if (!element.is_real()) {
+          show(state, element);
+        } else if (-element.as_real() > word_gap) {
+          space();
+        }
+      }
+      break;
+    default:
+      break;
+    }
+  }
+};
+
+} // namespace
+
+void extract_text(std::string_view data, std::ostream &out) {
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  // decoded page content; reused across pages to keep its capacity
+  std::string content;
+  for (Page *page : parser.pages(*document)) {
+    content.clear();
+    for (const auto &content_reference : page->contents_reference) {
+      IndirectObject object = parser.read_object(content_reference);
+      read_all(*parser.open_object_stream(object), content);
+      content += '\n';
+    }
+
+    PageTextExtractor(parser, *document, *page, out).extract(content);
+    out << '\f';
+  }
+}
+
+} // namespace odr::internal::pdf
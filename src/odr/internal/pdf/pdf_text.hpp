@@ -0,0 +1,16 @@
+#ifndef ODR_INTERNAL_PDF_TEXT_HPP
+#define ODR_INTERNAL_PDF_TEXT_HPP
+
+#include <iosfwd>
+#include <string_view>
+
+namespace odr::internal::pdf {
+
+/// Writes the text of every page of the PDF in `data` as UTF-8 lines in
+/// content stream order, followed by a form feed per page. Only text
+/// operators are parsed; paths, colors and images are skipped.
+void extract_text(std::string_view data, std::ostream &out);
+
+} // namespace odr::internal::pdf
+
+#endif // ODR_INTERNAL_PDF_TEXT_HPP
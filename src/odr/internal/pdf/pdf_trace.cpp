@@ -0,0 +1,35 @@
+#include <odr/internal/pdf/pdf_trace.hpp>
+
+#include <mutex>
+#include <utility>
+
+namespace odr::internal::pdf {
+
+namespace {
+
+// pages may be translated in parallel, so the sink is called one at a time
+std::mutex &trace_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+TraceSink &trace_sink() {
+  static TraceSink sink;
+  return sink;
+}
+
+} // namespace
+
+void set_trace_sink(TraceSink sink) {
+  std::lock_guard lock(trace_mutex());
+  trace_sink() = std::move(sink);
+}
+
+void trace(GraphicsOperatorType type, std::string_view message) {
+  std::lock_guard lock(trace_mutex());
+  if (const TraceSink &sink = trace_sink(); sink) {
+    sink(type, message);
+  }
+}
+
+} // namespace odr::internal::pdf
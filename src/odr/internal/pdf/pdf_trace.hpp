@@ -0,0 +1,32 @@
+#ifndef ODR_INTERNAL_PDF_TRACE_HPP
+#define ODR_INTERNAL_PDF_TRACE_HPP
+
+#include <functional>
+#include <string_view>
+
+namespace odr::internal::pdf {
+
+enum class GraphicsOperatorType;
+
+/// Receives content the PDF translator skips, e.g. unknown or unimplemented
+/// operators. Only called if the library is built with `ODR_PDF_TRACE`;
+/// otherwise `ODR_PDF_TRACE_EVENT` compiles to nothing. Calls are serialized,
+/// so the sink does not need to be thread-safe even if pages are translated in
+/// parallel; it must not call `set_trace_sink` itself.
+using TraceSink =
+    std::function<void(GraphicsOperatorType type, std::string_view message)>;
+
+void set_trace_sink(TraceSink sink);
+
+void trace(GraphicsOperatorType type, std::string_view message);
+
+} // namespace odr::internal::pdf
+
+#ifdef ODR_PDF_TRACE
+#define ODR_PDF_TRACE_EVENT(type, message)                                     \
+  ::odr::internal::pdf::trace(type, message)
+#else
+#define ODR_PDF_TRACE_EVENT(type, message) ((void)0)
+#endif
+
+#endif // ODR_INTERNAL_PDF_TRACE_HPP
@@ -4,7 +4,10 @@
 
 #include <odr/internal/util/string_util.hpp>
 
+#include <algorithm>
 #include <cstring>
+#include <sstream>
+#include <utility>
 
 namespace odr::internal {
 
@@ -114,25 +117,43 @@ svm::Header svm::read_header(std::istream &in) {
 
   result.vl = read_version_length(in);
 
-  std::size_t start = in.tellg();
-  read_primitive(in, result.compression_mode);
-  result.map_mode = read_map_mode(in);
-  result.size = read_int_pair(in);
-  read_primitive(in, result.action_count);
+  std::string record;
+  read_record(in, result.vl.length, record);
+  std::istringstream record_in(std::move(record));
+
+  read_primitive(record_in, result.compression_mode);
+  result.map_mode = read_map_mode(record_in);
+  result.size = read_int_pair(record_in);
+  read_primitive(record_in, result.action_count);
 
   if (result.vl.version >= 2) {
-    read_primitive(in, result.render_graphic_replacements);
+    read_primitive(record_in, result.render_graphic_replacements);
   }
 
-  const std::size_t left = result.vl.length - ((std::size_t)in.tellg() - start);
-  if (left > 0) {
-    // TODO log header skipping bytes
-    in.ignore(left);
+  if (!record_in) {
+    throw MalformedSvmFile();
   }
 
   return result;
 }
 
+void svm::read_record(std::istream &in, const std::uint32_t length,
+                      std::string &out) {
+  // grows with what was actually read so that a corrupt length cannot
+  // allocate more than the file holds
+  constexpr std::size_t chunk_size = 64 * 1024;
+  out.clear();
+  while (out.size() < length) {
+    const std::size_t offset = out.size();
+    const std::size_t size = std::min<std::size_t>(chunk_size, length - offset);
+    out.resize(offset + size);
+    in.read(out.data() + offset, static_cast<std::streamsize>(size));
+    if (static_cast<std::size_t>(in.gcount()) != size) {
+      throw MalformedSvmFile();
+    }
+  }
+}
+
 svm::ActionHeader svm::read_action_header(std::istream &in) {
   ActionHeader result;
 
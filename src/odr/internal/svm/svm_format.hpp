@@ -223,6 +223,9 @@ std::vector<IntPair> read_polygon(std::istream &in);
 std::vector<std::vector<IntPair>> read_poly_polygon(std::istream &in);
 
 Header read_header(std::istream &in);
+/// Reads the `length` bytes of a header or action record into `out`, reusing
+/// its capacity. Throws `MalformedSvmFile` if the stream ends before.
+void read_record(std::istream &in, std::uint32_t length, std::string &out);
 ActionHeader read_action_header(std::istream &in);
 MapMode read_map_mode(std::istream &in);
 LineInfo read_line_info(std::istream &in);
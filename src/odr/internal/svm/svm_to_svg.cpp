@@ -5,7 +5,9 @@
 #include <odr/internal/svm/svm_file.hpp>
 #include <odr/internal/svm/svm_format.hpp>
 
+#include <sstream>
 #include <string>
+#include <utility>
 
 namespace odr::internal::svm {
 
@@ -144,6 +146,31 @@ void write_text(std::ostream &out, const IntPair &point,
   out << "</text>";
 }
 
+/// Has to list the actions handled by `translate_action`; all others are
+/// skipped without being read.
+bool is_translated(const std::uint16_t type) {
+  switch (type) {
+  case META_FILLCOLOR_ACTION:
+  case META_LINECOLOR_ACTION:
+  case META_OVERLINECOLOR_ACTION:
+  case META_TEXTCOLOR_ACTION:
+  case META_TEXTFILLCOLOR_ACTION:
+  case META_FONT_ACTION:
+  case META_TEXTLINE_ACTION:
+  case META_RECT_ACTION:
+  case META_MAPMODE_ACTION:
+  case META_POLYLINE_ACTION:
+  case META_POLYGON_ACTION:
+  case META_POLYPOLYGON_ACTION:
+  case META_TEXT_ACTION:
+  case META_TEXTARRAY_ACTION:
+  case META_STRETCHTEXT_ACTION:
+    return true;
+  default:
+    return false;
+  }
+}
+
 void translate_action(const ActionHeader &action_header, std::istream &in,
                       std::ostream &out, Context &context) {
   switch (action_header.type) {
@@ -247,21 +274,31 @@ void Translator::svg(const SvmFile &file, std::ostream &out) {
   out << " viewBox=\"0 0 " << header.size.x << " " << header.size.y << "\"";
   out << ">";
 
+  // every action is read into `record` before it is translated, so `in` is
+  // only read front to back and memory is bounded by the largest action
+  std::string record;
+  std::istringstream record_in;
   while (in.peek() != -1) {
-    // TODO check length fields should never exceed file size (limited istream?)
     ActionHeader action_header = read_action_header(in);
-    std::int64_t start = in.tellg();
+    if (!in) {
+      throw MalformedSvmFile();
+    }
+    if (!is_translated(action_header.type)) {
+      // TODO log unhandled action
+      in.ignore(action_header.vl.length);
+      continue;
+    }
 
-    translate_action(action_header, in, out, context);
+    read_record(in, action_header.vl.length, record);
+    record_in.clear();
+    record_in.str(std::move(record));
 
-    const std::int64_t left =
-        action_header.vl.length - ((std::int64_t)in.tellg() - start);
-    if (left > 0) {
-      // TODO log skipping
-      in.ignore(left);
-    } else if (left < 0) {
+    translate_action(action_header, record_in, out, context);
+    if (!record_in) {
       throw MalformedSvmFile();
     }
+
+    record = std::move(record_in).str();
   }
 
   out << "</svg>";
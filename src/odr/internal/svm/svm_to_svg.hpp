@@ -8,6 +8,8 @@ namespace odr::internal::svm {
 class SvmFile;
 
 namespace Translator {
+/// Reads `file` front to back one action at a time and writes the SVG to
+/// `out` as it goes.
 void svg(const SvmFile &file, std::ostream &out);
 }
 } // namespace odr::internal::svm
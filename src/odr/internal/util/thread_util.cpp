@@ -0,0 +1,176 @@
+#include <odr/internal/util/thread_util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace odr::internal::util {
+
+namespace {
+/// Threads shared by all calls of `parallel_for`, one less than there are
+/// hardware threads since the calling thread works as well.
+class Pool final {
+public:
+  static Pool &instance() {
+    static Pool pool;
+    return pool;
+  }
+
+  Pool() {
+    const std::uint32_t size = thread::thread_count(0) - 1;
+    for (std::uint32_t i = 0; i < size; ++i) {
+      m_threads.emplace_back([this] { run(); });
+    }
+  }
+
+  ~Pool() {
+    {
+      std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_condition.notify_all();
+    for (std::thread &thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const { return m_threads.size(); }
+
+  void post(std::function<void()> task) {
+    {
+      std::lock_guard lock(m_mutex);
+      m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+  }
+
+private:
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<std::function<void()>> m_tasks;
+  bool m_stop{false};
+
+  void run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [&] { return m_stop || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+/// State of one `parallel_for` shared with the helpers in the pool.
+struct ParallelFor {
+  ParallelFor(const std::size_t count,
+              const std::function<void(std::size_t)> &task)
+      : count{count}, task{task} {}
+
+  const std::size_t count;
+  const std::function<void(std::size_t)> &task;
+  std::atomic<std::size_t> next{0};
+
+  std::mutex mutex;
+  std::condition_variable idle;
+  std::exception_ptr error;
+  std::size_t active{0};
+  bool closed{false};
+
+  void work() {
+    while (true) {
+      std::size_t index = next++;
+      if (index >= count) {
+        return;
+      }
+      try {
+        task(index);
+      } catch (...) {
+        std::lock_guard lock(mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = count;
+        return;
+      }
+    }
+  }
+};
+} // namespace
+
+std::uint32_t thread::thread_count(const std::uint32_t configured) {
+  if (configured != 0) {
+    return configured;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void thread::parallel_for(const std::size_t count,
+                          const std::uint32_t thread_count,
+                          const std::function<void(std::size_t)> &task) {
+  auto state = std::make_shared<ParallelFor>(count, task);
+
+  Pool &pool = Pool::instance();
+  const std::size_t workers =
+      std::min({std::size_t{thread_count}, count, pool.size() + 1});
+  for (std::size_t i = 1; i < workers; ++i) {
+    pool.post([state] {
+      {
+        std::lock_guard lock(state->mutex);
+        // the caller is done already; `task` may be gone
+        if (state->closed) {
+          return;
+        }
+        ++state->active;
+      }
+      state->work();
+      std::lock_guard lock(state->mutex);
+      --state->active;
+      state->idle.notify_all();
+    });
+  }
+  state->work();
+
+  // helpers which have not started yet are not waited for, so nested calls
+  // cannot deadlock on a busy pool
+  std::unique_lock lock(state->mutex);
+  state->closed = true;
+  state->idle.wait(lock, [&] { return state->active == 0; });
+
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+std::optional<std::size_t>
+thread::find_first(const std::size_t count, const std::uint32_t thread_count,
+                   const std::function<bool(std::size_t)> &predicate) {
+  std::atomic<std::size_t> found{count};
+  parallel_for(count, thread_count, [&](const std::size_t index) {
+    if (index > found || !predicate(index)) {
+      return;
+    }
+    std::size_t current = found;
+    while (index < current && !found.compare_exchange_weak(current, index)) {
+    }
+  });
+  if (found == count) {
+    return std::nullopt;
+  }
+  return found;
+}
+
+} // namespace odr::internal::util
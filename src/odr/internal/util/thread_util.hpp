@@ -0,0 +1,32 @@
+#ifndef ODR_INTERNAL_THREAD_UTIL_HPP
+#define ODR_INTERNAL_THREAD_UTIL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace odr::internal::util::thread {
+
+/// Resolves a configured thread count where 0 means one per hardware thread.
+std::uint32_t thread_count(std::uint32_t configured);
+
+/// Calls `task` with every index in `[0, count)` on up to `thread_count`
+/// threads, the calling one included. The helpers come from a pool of one
+/// thread per hardware thread which is shared by the whole process and
+/// started on first use; calls may nest.
+/// Indices are handed out one at a time so uneven tasks balance out. The
+/// first exception stops the remaining tasks and is rethrown.
+void parallel_for(std::size_t count, std::uint32_t thread_count,
+                  const std::function<void(std::size_t)> &task);
+
+/// Returns the smallest index in `[0, count)` for which `predicate` holds,
+/// evaluated on up to `thread_count` threads. Indices past a match are
+/// skipped.
+std::optional<std::size_t>
+find_first(std::size_t count, std::uint32_t thread_count,
+           const std::function<bool(std::size_t)> &predicate);
+
+} // namespace odr::internal::util::thread
+
+#endif // ODR_INTERNAL_THREAD_UTIL_HPP
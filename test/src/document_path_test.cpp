@@ -10,3 +10,13 @@ TEST(DocumentPath, example1) {
   EXPECT_EQ("/child:3/child:2/row:17/child:0",
             DocumentPath("/child:3/child:2/row:17/child:0").to_string());
 }
+
+TEST(DocumentPath, push_pop) {
+  DocumentPath path;
+  path.push_back(DocumentPath::Child(3));
+  path.push_back(DocumentPath::Row(17));
+  path.push_back(DocumentPath::Column(2));
+  EXPECT_EQ("/child:3/row:17/column:2", path.to_string());
+  path.pop_back();
+  EXPECT_EQ(DocumentPath("/child:3/row:17"), path);
+}
@@ -1,5 +1,6 @@
 #include <odr/document.hpp>
 #include <odr/document_element.hpp>
+#include <odr/document_path.hpp>
 #include <odr/html.hpp>
 #include <odr/quantity.hpp>
 
@@ -88,6 +89,29 @@ TEST(Document, edit_docx) {
   DocumentFile("style-various-1_edit.docx");
 }
 
+TEST(Document, find_odt) {
+  DocumentFile document_file(
+      TestData::test_file_path("odr-public/odt/style-various-1.odt"));
+  Document document = document_file.document();
+  Element root = document.root_element();
+
+  std::vector<Element> elements;
+  std::vector<DocumentPath> paths;
+  std::function<void(Element)> collect = [&](Element element) {
+    elements.push_back(element);
+    paths.push_back(DocumentPath::extract(element));
+    for (Element child : element.children()) {
+      collect(child);
+    }
+  };
+  collect(root);
+
+  EXPECT_EQ(elements, DocumentPath::find(root, paths));
+  for (std::size_t i = 0; i < elements.size(); ++i) {
+    EXPECT_EQ(elements[i], DocumentPath::find(root, paths[i]));
+  }
+}
+
 TEST(Document, edit_odt_diff) {
   auto diff =
       R"({"modifiedText":{"/child:16/child:0":"Outasdfsdafdline","/child:24/child:0":"Colorasdfasdfasdfed Line","/child:6/child:0":"Text hello world!"}})";
@@ -4,9 +4,42 @@
 
 #include <gtest/gtest.h>
 
+#include <optional>
+#include <string>
+#include <vector>
+
 using namespace odr;
 using namespace odr::test;
 
+namespace {
+std::optional<TestFile> encrypted_test_file(const FileType type) {
+  for (const std::string &path : TestData::test_file_paths()) {
+    TestFile test_file = TestData::test_file(path);
+    if (test_file.type == type && test_file.password_encrypted) {
+      return test_file;
+    }
+  }
+  return std::nullopt;
+}
+
+void expect_find_password(const TestFile &test_file) {
+  DocumentFile document_file(test_file.path);
+  ASSERT_TRUE(document_file.password_encrypted());
+
+  EXPECT_EQ(2, document_file.find_password(
+                   {"", "wrong", test_file.password, "other"}));
+  // the first match wins
+  EXPECT_EQ(1, document_file.find_password(
+                   {"wrong", test_file.password, test_file.password}));
+  EXPECT_EQ(std::nullopt, document_file.find_password({"", "wrong", "other"}));
+  EXPECT_EQ(std::nullopt, document_file.find_password({}));
+
+  // nothing is decrypted on the way
+  EXPECT_EQ(EncryptionState::encrypted, document_file.encryption_state());
+  EXPECT_TRUE(document_file.decrypt(test_file.password));
+}
+} // namespace
+
 TEST(File, open) { EXPECT_THROW(File("/"), FileNotFound); }
 
 TEST(DocumentFile, open) { EXPECT_THROW(DocumentFile("/"), FileNotFound); }
@@ -20,3 +53,13 @@ TEST(DecodedFile, wpd) {
     EXPECT_EQ(e.file_type, FileType::word_perfect);
   }
 }
+
+TEST(DocumentFile, find_password_odt) {
+  const auto test_file = encrypted_test_file(FileType::opendocument_text);
+  ASSERT_TRUE(test_file);
+  expect_find_password(*test_file);
+}
+
+TEST(DocumentFile, find_password_docx) {
+  expect_find_password(TestData::test_file("odr-public/docx/encrypted.docx"));
+}
@@ -1,20 +1,156 @@
 #include <odr/exceptions.hpp>
 
+#include <odr/internal/abstract/filesystem.hpp>
 #include <odr/internal/cfb/cfb_archive.hpp>
 #include <odr/internal/cfb/cfb_file.hpp>
+#include <odr/internal/cfb/cfb_impl.hpp>
 #include <odr/internal/cfb/cfb_util.hpp>
+#include <odr/internal/common/file.hpp>
 
 #include <test_util.hpp>
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 using namespace odr;
 using namespace odr::internal;
 using namespace odr::internal::cfb;
 using namespace odr::test;
 
+namespace {
+
+constexpr std::uint32_t end_of_chain = 0xFFFFFFFE;
+constexpr std::uint32_t free_sector = 0xFFFFFFFF;
+
+void write_u32(std::string &data, std::size_t offset, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    data[offset + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+std::string stream_content(std::size_t size, char seed) {
+  std::string result(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    result[i] = static_cast<char>(seed + i % 251);
+  }
+  return result;
+}
+
+/// A version 3 compound file with three streams: `Contiguous` in sectors
+/// 4-12, `Fragmented` in sectors 13, 14, 20, 15-19, 21 and `Mini` in mini
+/// sectors 1, 0, 2, 3.
+std::string create_cfb() {
+  constexpr std::size_t sector_size = 512;
+  std::string data(sector_size * 23, '\0');
+  auto sector = [&](std::uint32_t id) { return sector_size * (id + 1); };
+
+  // header
+  data.replace(0, 8, "\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1");
+  data[24] = 0x3E;
+  data[26] = 3;
+  data[28] = '\xFE';
+  data[29] = '\xFF';
+  data[30] = 9;
+  data[32] = 6;
+  write_u32(data, 44, 1); // FAT sectors
+  write_u32(data, 48, 1); // first directory sector
+  write_u32(data, 56, 4096);
+  write_u32(data, 60, 2); // first mini FAT sector
+  write_u32(data, 64, 1); // mini FAT sectors
+  write_u32(data, 68, end_of_chain);
+  write_u32(data, 76, 0); // the FAT is in sector 0
+  for (std::size_t i = 1; i < 109; ++i) {
+    write_u32(data, 76 + 4 * i, free_sector);
+  }
+
+  // FAT
+  std::vector<std::uint32_t> fat(128, free_sector);
+  fat[0] = 0xFFFFFFFD;
+  fat[1] = end_of_chain;
+  fat[2] = end_of_chain;
+  fat[3] = end_of_chain;
+  for (std::uint32_t i = 4; i < 12; ++i) {
+    fat[i] = i + 1;
+  }
+  fat[12] = end_of_chain;
+  std::vector<std::uint32_t> fragmented{13, 14, 20, 15, 16, 17, 18, 19, 21};
+  for (std::size_t i = 0; i + 1 < fragmented.size(); ++i) {
+    fat[fragmented[i]] = fragmented[i + 1];
+  }
+  fat[fragmented.back()] = end_of_chain;
+  for (std::size_t i = 0; i < fat.size(); ++i) {
+    write_u32(data, sector(0) + 4 * i, fat[i]);
+  }
+
+  // mini FAT
+  std::vector<std::uint32_t> mini_fat(128, free_sector);
+  mini_fat[1] = 0;
+  mini_fat[0] = 2;
+  mini_fat[2] = 3;
+  mini_fat[3] = end_of_chain;
+  for (std::size_t i = 0; i < mini_fat.size(); ++i) {
+    write_u32(data, sector(2) + 4 * i, mini_fat[i]);
+  }
+
+  // directory
+  auto entry = [&](std::uint32_t id, std::u16string_view name,
+                   std::uint8_t type, std::uint32_t right, std::uint32_t child,
+                   std::uint32_t start, std::uint32_t size) {
+    std::size_t offset = sector(1) + 128 * id;
+    for (std::size_t i = 0; i < name.size(); ++i) {
+      data[offset + 2 * i] = static_cast<char>(name[i]);
+    }
+    data[offset + 64] = static_cast<char>(2 * (name.size() + 1));
+    data[offset + 66] = static_cast<char>(type);
+    data[offset + 67] = 1;
+    write_u32(data, offset + 68, free_sector);
+    write_u32(data, offset + 72, right);
+    write_u32(data, offset + 76, child);
+    write_u32(data, offset + 116, start);
+    write_u32(data, offset + 120, size);
+  };
+  entry(0, u"Root Entry", 5, free_sector, 1, 3, 256);
+  entry(1, u"Contiguous", 2, 2, free_sector, 4, 4200);
+  entry(2, u"Fragmented", 2, 3, free_sector, 13, 4200);
+  entry(3, u"Mini", 2, free_sector, free_sector, 1, 200);
+
+  // stream data
+  std::string contiguous = stream_content(4200, 'a');
+  data.replace(sector(4), contiguous.size(), contiguous);
+  std::string fragmented_content = stream_content(4200, 'b');
+  for (std::size_t i = 0; i < fragmented.size(); ++i) {
+    std::size_t length =
+        std::min(sector_size, fragmented_content.size() - i * sector_size);
+    data.replace(sector(fragmented[i]), length,
+                 fragmented_content.substr(i * sector_size, length));
+  }
+  std::string mini = stream_content(200, 'c');
+  std::vector<std::uint32_t> mini_chain{1, 0, 2, 3};
+  for (std::size_t i = 0; i < mini_chain.size(); ++i) {
+    std::size_t length = std::min<std::size_t>(64, mini.size() - i * 64);
+    data.replace(sector(3) + 64 * mini_chain[i], length,
+                 mini.substr(i * 64, length));
+  }
+
+  return data;
+}
+
+std::string join(const std::vector<std::string_view> &spans) {
+  std::string result;
+  for (std::string_view span : spans) {
+    result += span;
+  }
+  return result;
+}
+
+} // namespace
+
 TEST(CfbArchive, open_directory) {
   EXPECT_ANY_THROW(
       CfbFile(std::make_shared<common::MemoryFile>(common::DiskFile("/"))));
@@ -34,3 +170,75 @@ TEST(CfbArchive, open_encrypted_docx) {
   EXPECT_TRUE(cfb.find("EncryptionInfo") == std::end(cfb));
   EXPECT_TRUE(cfb.find("/EncryptionInfo") != std::end(cfb));
 }
+
+TEST(CfbArchive, read_encrypted_package) {
+  auto cfb = std::make_shared<util::Archive>(
+      std::make_shared<common::MemoryFile>(common::DiskFile(
+          TestData::test_file_path("odr-public/docx/encrypted.docx"))));
+
+  auto entry = cfb->find("/EncryptedPackage");
+  ASSERT_TRUE(entry != std::end(*cfb));
+  auto file = entry->file();
+  auto in = file->stream();
+  std::string content{std::istreambuf_iterator<char>(*in), {}};
+  EXPECT_EQ(content.size(), file->size());
+}
+
+TEST(CfbArchive, spans) {
+  std::string data = create_cfb();
+  impl::CompoundFileReader reader(data.data(), data.size());
+
+  std::vector<std::string_view> contiguous = reader.spans(reader.get_entry(1));
+  ASSERT_EQ(contiguous.size(), 1u);
+  EXPECT_EQ(contiguous.front(), stream_content(4200, 'a'));
+
+  // 13-14, 20, 15-19 and 21
+  std::vector<std::string_view> fragmented = reader.spans(reader.get_entry(2));
+  ASSERT_EQ(fragmented.size(), 4u);
+  EXPECT_EQ(fragmented[0].size(), 1024u);
+  EXPECT_EQ(fragmented[1].size(), 512u);
+  EXPECT_EQ(fragmented[2].size(), 2560u);
+  EXPECT_EQ(fragmented[3].size(), 104u);
+  EXPECT_EQ(join(fragmented), stream_content(4200, 'b'));
+
+  // mini sectors 1, 0 and 2-3
+  std::vector<std::string_view> mini = reader.spans(reader.get_entry(3));
+  ASSERT_EQ(mini.size(), 3u);
+  EXPECT_EQ(mini[2].size(), 72u);
+  EXPECT_EQ(join(mini), stream_content(200, 'c'));
+}
+
+TEST(CfbArchive, memory_data) {
+  auto cfb = std::make_shared<util::Archive>(
+      std::make_shared<common::MemoryFile>(create_cfb()));
+
+  auto contiguous = cfb->find("/Contiguous")->file();
+  ASSERT_NE(contiguous->memory_data(), nullptr);
+  EXPECT_EQ(std::string(contiguous->memory_data(), contiguous->size()),
+            stream_content(4200, 'a'));
+
+  auto fragmented = cfb->find("/Fragmented")->file();
+  EXPECT_EQ(fragmented->memory_data(), nullptr);
+  auto in = fragmented->stream();
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(*in), {}),
+            stream_content(4200, 'b'));
+
+  EXPECT_EQ(cfb->find("/Mini")->file()->memory_data(), nullptr);
+}
+
+TEST(CfbArchive, filesystem) {
+  auto cfb = std::make_shared<util::Archive>(
+      std::make_shared<common::MemoryFile>(common::DiskFile(
+          TestData::test_file_path("odr-public/docx/encrypted.docx"))));
+
+  for (auto it = std::begin(*cfb); it != std::end(*cfb); ++it) {
+    EXPECT_TRUE(cfb->find(it->path()) == it);
+  }
+
+  auto filesystem = CfbArchive(cfb).filesystem();
+  EXPECT_TRUE(filesystem->is_directory("/"));
+  EXPECT_TRUE(filesystem->is_file("/EncryptionInfo"));
+  EXPECT_FALSE(filesystem->exists("/missing"));
+  EXPECT_EQ(filesystem->open("/EncryptionInfo")->size(),
+            cfb->find("/EncryptionInfo")->file()->size());
+}
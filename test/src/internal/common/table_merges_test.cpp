@@ -0,0 +1,34 @@
+#include <odr/internal/common/table_merges.hpp>
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace odr;
+using namespace odr::internal::common;
+
+TEST(TableMerges, anchor) {
+  TableMerges merges;
+  // B2:D4 and A5:B6
+  merges.add(1, 1, TableDimensions(3, 3));
+  merges.add(0, 4, TableDimensions(2, 2));
+
+  using Cell = std::pair<std::uint32_t, std::uint32_t>;
+  EXPECT_EQ(merges.anchor(0, 0), Cell(0, 0));
+  EXPECT_EQ(merges.anchor(1, 1), Cell(1, 1));
+  EXPECT_EQ(merges.anchor(3, 3), Cell(1, 1));
+  EXPECT_EQ(merges.anchor(4, 3), Cell(4, 3));
+  EXPECT_EQ(merges.anchor(2, 4), Cell(2, 4));
+  EXPECT_EQ(merges.anchor(1, 5), Cell(0, 4));
+  EXPECT_EQ(merges.anchor(0, 6), Cell(0, 6));
+}
+
+TEST(TableMerges, span) {
+  TableMerges merges;
+  merges.add(1, 1, TableDimensions(3, 2));
+
+  EXPECT_EQ(merges.span(1, 1).rows, 3);
+  EXPECT_EQ(merges.span(1, 1).columns, 2);
+  EXPECT_EQ(merges.span(2, 1).rows, 1);
+  EXPECT_EQ(merges.span(2, 1).columns, 1);
+}
@@ -0,0 +1,136 @@
+#include <odr/internal/crypto/crypto_util.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal;
+
+TEST(CryptoUtil, base64_encode) {
+  EXPECT_EQ(crypto::util::base64_encode(std::string("")), "");
+  EXPECT_EQ(crypto::util::base64_encode(std::string("f")), "Zg==");
+  EXPECT_EQ(crypto::util::base64_encode(std::string("fo")), "Zm8=");
+  EXPECT_EQ(crypto::util::base64_encode(std::string("foo")), "Zm9v");
+  EXPECT_EQ(crypto::util::base64_encode(std::string("foobar")), "Zm9vYmFy");
+}
+
+TEST(CryptoUtil, base64_encode_stream) {
+  // spans several blocks and needs padding at the end
+  std::string input(100001, '\0');
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<char>(i * 7);
+  }
+
+  std::istringstream in(input);
+  std::ostringstream out;
+  crypto::util::base64_encode(in, out);
+
+  EXPECT_EQ(out.str(), crypto::util::base64_encode(input));
+  EXPECT_EQ(out.str().size(), (input.size() + 2) / 3 * 4);
+}
+
+TEST(CryptoUtil, base64_encoder) {
+  std::string input(100001, '\0');
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<char>(i * 7);
+  }
+
+  // written in pieces which do not line up with the groups of 3
+  std::ostringstream out;
+  crypto::util::Base64Encoder encoder(out);
+  std::ostream encoded(&encoder);
+  for (std::size_t offset = 0; offset < input.size(); offset += 1000) {
+    encoded << std::string_view(input).substr(offset, 1000);
+    encoded.put('x');
+  }
+  encoder.finish();
+
+  std::string expected;
+  for (std::size_t offset = 0; offset < input.size(); offset += 1000) {
+    expected += input.substr(offset, 1000) + 'x';
+  }
+  EXPECT_EQ(out.str(), crypto::util::base64_encode(expected));
+}
+
+TEST(CryptoUtil, inflate_backends) {
+  // "hello hello hello" deflated without and with zlib header
+  const std::string raw("\xcb\x48\xcd\xc9\xc9\x57\xc8\x40\x90\x00", 10);
+  const std::string zlib = "\x78\x9c" + raw + "\x3a\x2e\x06\x7d";
+
+  for (auto backend :
+       {crypto::util::InflateBackend::cryptopp,
+        crypto::util::InflateBackend::miniz,
+        crypto::util::InflateBackend::zlib_ng}) {
+    if (!crypto::util::available(backend)) {
+      continue;
+    }
+
+    // trailing bytes like the padding of encrypted ODF parts are ignored
+    std::string output = "> ";
+    EXPECT_EQ(crypto::util::inflate(raw + "pad", output, backend), 3u);
+    EXPECT_EQ(output, "> hello hello hello");
+
+    output.clear();
+    crypto::util::zlib_inflate(zlib, output, backend);
+    EXPECT_EQ(output, "hello hello hello");
+  }
+}
+
+TEST(CryptoUtil, hash_backends) {
+  using crypto::util::base64_encode;
+
+  for (auto backend : {crypto::util::HashBackend::cryptopp,
+                       crypto::util::HashBackend::openssl}) {
+    if (!crypto::util::available(backend)) {
+      continue;
+    }
+
+    EXPECT_EQ(base64_encode(crypto::util::sha1("abc", backend)),
+              "qZk+NkcGgWq6PiVxeFDCbJzQ2J0=");
+    EXPECT_EQ(base64_encode(crypto::util::sha256("abc", backend)),
+              "ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=");
+    EXPECT_EQ(base64_encode(crypto::util::sha512("abc", backend)),
+              "3a81oZNherrMQXNJriBBMRLm+k6JqX6iCp7u5ktV05ohkpkqJ0/BqDa6PCOj/"
+              "uu9RU1EI2Q86A4qmslPpUyknw==");
+    // RFC 6070
+    EXPECT_EQ(base64_encode(crypto::util::pbkdf2(20, "password", "salt", 2,
+                                                 backend)),
+              "6mwBTcctb4zNHtkqzh1B8NjeiVc=");
+  }
+}
+
+TEST(CryptoUtil, inflater_pieces) {
+  const std::string raw("\xcb\x48\xcd\xc9\xc9\x57\xc8\x40\x90\x00", 10);
+
+  auto inflater = crypto::util::inflater();
+  std::string output(32, '\0');
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < raw.size(); i += 3) {
+    std::string_view piece = std::string_view(raw).substr(i, 3);
+    written += inflater->inflate(piece, output.data() + written,
+                                 output.size() - written);
+    EXPECT_TRUE(piece.empty());
+  }
+  EXPECT_TRUE(inflater->finished());
+  EXPECT_EQ(output.substr(0, written), "hello hello hello");
+}
+
+TEST(CryptoUtil, sha256_stream) {
+  // spans several reads of the hash
+  std::string input(200001, '\0');
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<char>(i * 7);
+  }
+
+  for (auto backend : {crypto::util::HashBackend::cryptopp,
+                       crypto::util::HashBackend::openssl}) {
+    if (!crypto::util::available(backend)) {
+      continue;
+    }
+
+    std::istringstream in(input);
+    EXPECT_EQ(crypto::util::sha256(in, backend),
+              crypto::util::sha256(input, backend));
+  }
+}
@@ -0,0 +1,95 @@
+#include <odr/file.hpp>
+#include <odr/html.hpp>
+
+#include <odr/internal/common/file.hpp>
+#include <odr/internal/html/common.hpp>
+
+#include <filesystem>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using namespace odr;
+using namespace odr::internal;
+
+TEST(HtmlCommon, local_resource_locator_deduplicates_images) {
+  const std::string output_path =
+      (std::filesystem::temp_directory_path() / "odr_resource_locator_test")
+          .string();
+  std::filesystem::remove_all(output_path);
+
+  HtmlConfig config;
+  config.embed_resources = false;
+  HtmlResourceLocator locator =
+      internal::html::local_resource_locator(output_path, config);
+
+  File logo1(std::make_shared<common::MemoryFile>(std::string("logo")));
+  File logo2(std::make_shared<common::MemoryFile>(std::string("logo")));
+  File other(std::make_shared<common::MemoryFile>(std::string("other")));
+
+  auto location1 =
+      locator(HtmlResourceType::image, "image", "image", logo1, false);
+  auto location2 =
+      locator(HtmlResourceType::image, "image", "image", logo2, false);
+  auto location3 =
+      locator(HtmlResourceType::image, "image", "image", other, false);
+
+  ASSERT_TRUE(location1.has_value());
+  EXPECT_EQ(location1, location2);
+  EXPECT_NE(location1, location3);
+  EXPECT_TRUE(std::filesystem::exists(
+      std::filesystem::path(output_path) / *location1));
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(
+                              std::filesystem::path(output_path) / "resources"),
+                          std::filesystem::directory_iterator()),
+            2);
+
+  std::filesystem::remove_all(output_path);
+}
+
+TEST(HtmlCommon, local_resource_locator_writes_images_once) {
+  const std::string output_path =
+      (std::filesystem::temp_directory_path() / "odr_resource_locator_once")
+          .string();
+  std::filesystem::remove_all(output_path);
+
+  HtmlConfig config;
+  config.embed_resources = false;
+  HtmlResourceLocator locator =
+      internal::html::local_resource_locator(output_path, config);
+
+  File logo(std::make_shared<common::MemoryFile>(std::string("logo")));
+
+  auto location1 =
+      locator(HtmlResourceType::image, "image", "image", logo, false);
+  ASSERT_TRUE(location1.has_value());
+  auto written = std::filesystem::path(output_path) / *location1;
+  ASSERT_TRUE(std::filesystem::exists(written));
+
+  // a second reference must reuse the location without writing again
+  std::filesystem::remove(written);
+  auto location2 =
+      locator(HtmlResourceType::image, "image", "image", logo, false);
+  EXPECT_EQ(location1, location2);
+  EXPECT_FALSE(std::filesystem::exists(written));
+
+  std::filesystem::remove_all(output_path);
+}
+
+TEST(HtmlCommon, local_resource_locator_streams_embedded_images) {
+  const std::string output_path =
+      (std::filesystem::temp_directory_path() / "odr_resource_locator_embed")
+          .string();
+  std::filesystem::remove_all(output_path);
+
+  HtmlConfig config;
+  config.embed_resources = true;
+  HtmlResourceLocator locator =
+      internal::html::local_resource_locator(output_path, config);
+
+  File logo(std::make_shared<common::MemoryFile>(std::string("logo")));
+
+  EXPECT_FALSE(
+      locator(HtmlResourceType::image, "image", "image", logo, false));
+  EXPECT_FALSE(std::filesystem::exists(output_path));
+}
@@ -0,0 +1,281 @@
+#include <odr/document.hpp>
+#include <odr/document_element.hpp>
+#include <odr/file.hpp>
+#include <odr/html.hpp>
+#include <odr/html_service.hpp>
+
+#include <odr/internal/common/file.hpp>
+#include <odr/internal/common/filesystem.hpp>
+#include <odr/internal/common/table_range.hpp>
+#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/html/document.hpp>
+#include <odr/internal/odf/odf_document.hpp>
+#include <odr/internal/ooxml/spreadsheet/ooxml_spreadsheet_document.hpp>
+
+#include <test_util.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace odr;
+using namespace odr::internal;
+using namespace odr::test;
+
+namespace {
+
+std::shared_ptr<common::VirtualFilesystem> create_filesystem(
+    const std::vector<std::pair<std::string, std::string>> &files) {
+  auto filesystem = std::make_shared<common::VirtualFilesystem>();
+  for (const auto &[path, content] : files) {
+    filesystem->copy(std::make_shared<common::MemoryFile>(content), path);
+  }
+  return filesystem;
+}
+
+std::string translate_tile(const Document &document, const Sheet &sheet,
+                           const common::TableRange &range) {
+  HtmlConfig config;
+  HtmlResourceLocator resource_locator =
+      [](HtmlResourceType, const std::string &, const std::string &,
+         const File &, bool) -> HtmlResourceLocation { return std::nullopt; };
+
+  std::ostringstream out;
+  internal::html::translate_sheet(document, sheet, range)
+      .write_html_fragment(out, config, resource_locator);
+  return out.str();
+}
+
+Document create_image_document(const std::string &image) {
+  auto filesystem = create_filesystem({
+      {"content.xml", R"(
+<office:document-content
+    xmlns:office="urn:oasis:names:tc:opendocument:xmlns:office:1.0"
+    xmlns:draw="urn:oasis:names:tc:opendocument:xmlns:drawing:1.0"
+    xmlns:text="urn:oasis:names:tc:opendocument:xmlns:text:1.0"
+    xmlns:xlink="http://www.w3.org/1999/xlink">
+<office:body><office:text><text:p>
+<draw:frame draw:name="image" text:anchor-type="as-char">
+<draw:image xlink:href="Pictures/image"/></draw:frame>
+</text:p></office:text></office:body></office:document-content>
+)"},
+      {"Pictures/image", image},
+  });
+  return Document(std::make_shared<odf::Document>(
+      FileType::opendocument_text, DocumentType::text, filesystem));
+}
+
+// a metafile with a single rectangle action
+std::string create_svm() {
+  std::string result = "VCLMTF";
+  auto write = [&](std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+      result += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+  };
+  write(1, 2);   // header version
+  write(49, 4);  // header length
+  write(0, 4);   // compression
+  write(1, 2);   // map mode version
+  write(27, 4);  // map mode length
+  write(0, 2);   // unit
+  write(0, 4);   // origin x
+  write(0, 4);   // origin y
+  for (int i = 0; i < 4; ++i) {
+    write(1, 4); // scale numerators and denominators
+  }
+  write(1, 1);    // simple
+  write(1000, 4); // width
+  write(800, 4);  // height
+  write(1, 4);    // action count
+  write(103, 2);  // rectangle
+  write(1, 2);
+  write(16, 4);
+  for (std::uint32_t coordinate : {1, 2, 300, 400}) {
+    write(coordinate, 4);
+  }
+  return result;
+}
+
+std::string translate_image_src(const Document &document, bool embed) {
+  const std::string output_path =
+      (std::filesystem::temp_directory_path() / "odr_html_image_test")
+          .string();
+  std::filesystem::remove_all(output_path);
+  std::filesystem::create_directories(output_path);
+
+  HtmlConfig config;
+  config.embed_resources = embed;
+  Html html = odr::html::translate(document, output_path, config);
+
+  std::ifstream in(html.pages().front().path);
+  std::string output((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+  auto begin = output.find("src=\"", output.find("<img"));
+  if (begin == std::string::npos) {
+    return "";
+  }
+  begin += 5;
+  std::string src = output.substr(begin, output.find('"', begin) - begin);
+  if (!embed) {
+    std::ifstream resource(output_path + "/" + src, std::ios::binary);
+    src = std::string((std::istreambuf_iterator<char>(resource)),
+                      std::istreambuf_iterator<char>());
+  }
+  std::filesystem::remove_all(output_path);
+  return src;
+}
+
+std::size_t count(const std::string &string, const std::string &pattern) {
+  std::size_t result = 0;
+  for (auto pos = string.find(pattern); pos != std::string::npos;
+       pos = string.find(pattern, pos + 1)) {
+    ++result;
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(HtmlDocument, sheet_tile) {
+  DocumentFile document_file(
+      TestData::test_file_path("odr-public/ods/pages.ods"));
+  Document document = document_file.document();
+  Sheet sheet = document.root_element().first_child().sheet();
+
+  HtmlConfig config;
+  HtmlResourceLocator resource_locator =
+      [](HtmlResourceType, const std::string &, const std::string &,
+         const File &, bool) -> HtmlResourceLocation { return std::nullopt; };
+
+  HtmlFragment tile =
+      odr::html::translate_sheet(document, sheet, 2, 100, 4, 102);
+
+  std::ostringstream out;
+  tile.write_html_fragment(out, config, resource_locator);
+  const std::string html = out.str();
+
+  // column headers C and D, row headers 101 and 102
+  EXPECT_NE(html.find(">C<"), std::string::npos);
+  EXPECT_NE(html.find(">D<"), std::string::npos);
+  EXPECT_EQ(html.find(">E<"), std::string::npos);
+  EXPECT_NE(html.find(">101<"), std::string::npos);
+  EXPECT_NE(html.find(">102<"), std::string::npos);
+  EXPECT_EQ(html.find(">103<"), std::string::npos);
+}
+
+TEST(HtmlDocument, sheet_tile_clips_merged_cells) {
+  // B2:D4 is merged and A5:B6 is merged in a repeated row
+  auto filesystem = create_filesystem({{"content.xml", R"(
+<office:document-content
+    xmlns:office="urn:oasis:names:tc:opendocument:xmlns:office:1.0"
+    xmlns:table="urn:oasis:names:tc:opendocument:xmlns:table:1.0"
+    xmlns:text="urn:oasis:names:tc:opendocument:xmlns:text:1.0">
+<office:body><office:spreadsheet><table:table table:name="Sheet1">
+<table:table-column table:number-columns-repeated="5"/>
+<table:table-row><table:table-cell table:number-columns-repeated="5"/>
+</table:table-row>
+<table:table-row><table:table-cell/>
+<table:table-cell table:number-columns-spanned="3"
+    table:number-rows-spanned="3"><text:p>merged</text:p></table:table-cell>
+<table:covered-table-cell table:number-columns-repeated="2"/>
+<table:table-cell/></table:table-row>
+<table:table-row><table:table-cell/>
+<table:covered-table-cell table:number-columns-repeated="3"/>
+<table:table-cell/></table:table-row>
+<table:table-row><table:table-cell/>
+<table:covered-table-cell table:number-columns-repeated="3"/>
+<table:table-cell/></table:table-row>
+<table:table-row table:number-rows-repeated="2">
+<table:table-cell table:number-columns-spanned="2"><text:p>wide</text:p>
+</table:table-cell><table:covered-table-cell/>
+<table:table-cell table:number-columns-repeated="3"/></table:table-row>
+</table:table></office:spreadsheet></office:body></office:document-content>
+)"}});
+  Document document(std::make_shared<odf::Document>(
+      FileType::opendocument_spreadsheet, DocumentType::spreadsheet,
+      filesystem));
+  Sheet sheet = document.root_element().first_child().sheet();
+
+  // only the bottom right 2x2 of the merged cell is inside C3:D4
+  const std::string html =
+      translate_tile(document, sheet, common::TableRange({2, 2}, {4, 4}));
+  EXPECT_EQ(count(html, "merged"), 1u);
+  EXPECT_NE(html.find("colspan=\"2\""), std::string::npos);
+  EXPECT_NE(html.find("rowspan=\"2\""), std::string::npos);
+
+  // the second of the repeated rows is anchored at A6, left of the tile
+  const std::string repeated =
+      translate_tile(document, sheet, common::TableRange({1, 5}, {3, 6}));
+  EXPECT_EQ(count(repeated, "wide"), 1u);
+  EXPECT_EQ(repeated.find("colspan"), std::string::npos);
+}
+
+TEST(HtmlDocument, sheet_tile_clips_merged_cells_ooxml) {
+  auto filesystem = create_filesystem({
+      {"xl/workbook.xml", R"(
+<workbook xmlns="http://schemas.openxmlformats.org/spreadsheetml/2006/main">
+<sheets><sheet name="Sheet1" sheetId="1" r:id="rId1"/></sheets></workbook>
+)"},
+      {"xl/_rels/workbook.xml.rels", R"(
+<Relationships
+    xmlns="http://schemas.openxmlformats.org/package/2006/relationships">
+<Relationship Id="rId1" Target="worksheets/sheet1.xml"/></Relationships>
+)"},
+      {"xl/styles.xml", R"(
+<styleSheet xmlns="http://schemas.openxmlformats.org/spreadsheetml/2006/main"/>
+)"},
+      {"xl/worksheets/sheet1.xml", R"(
+<worksheet xmlns="http://schemas.openxmlformats.org/spreadsheetml/2006/main">
+<dimension ref="A1:E5"/><sheetData>
+<row r="2"><c r="B2" t="str"><v>merged</v></c><c r="C2"/><c r="D2"/></row>
+</sheetData><mergeCells count="1"><mergeCell ref="B2:D4"/></mergeCells>
+</worksheet>
+)"},
+  });
+  Document document(
+      std::make_shared<ooxml::spreadsheet::Document>(filesystem));
+  Sheet sheet = document.root_element().first_child().sheet();
+
+  const std::string html =
+      translate_tile(document, sheet, common::TableRange({2, 2}, {4, 4}));
+  EXPECT_EQ(count(html, "merged"), 1u);
+  EXPECT_NE(html.find("colspan=\"2\""), std::string::npos);
+  EXPECT_NE(html.find("rowspan=\"2\""), std::string::npos);
+}
+
+TEST(HtmlDocument, embedded_svm_image) {
+  Document document = create_image_document(create_svm());
+
+  const std::string prefix = "data:image/svg+xml;base64,";
+  const std::string src = translate_image_src(document, true);
+  ASSERT_EQ(src.substr(0, prefix.size()), prefix);
+  const std::string svg =
+      crypto::util::base64_decode(src.substr(prefix.size()));
+  EXPECT_EQ(svg.find("<svg"), 0u);
+  EXPECT_NE(svg.find("<rect"), std::string::npos);
+  EXPECT_NE(svg.find("</svg>"), std::string::npos);
+
+  // written to `resources/` the image is translated the same way
+  EXPECT_EQ(translate_image_src(document, false), svg);
+}
+
+TEST(HtmlDocument, embedded_image_data_url) {
+  std::string image;
+  for (int i = 0; i < 1000; ++i) {
+    image += static_cast<char>(i * 7);
+  }
+  Document document = create_image_document(image);
+
+  const std::string prefix = "data:image/jpg;base64,";
+  const std::string src = translate_image_src(document, true);
+  ASSERT_EQ(src.substr(0, prefix.size()), prefix);
+  EXPECT_EQ(crypto::util::base64_decode(src.substr(prefix.size())), image);
+}
@@ -0,0 +1,159 @@
+#include <odr/file.hpp>
+#include <odr/html.hpp>
+#include <odr/html_service.hpp>
+
+#include <odr/internal/common/file.hpp>
+#include <odr/internal/html/pdf_file.hpp>
+#include <odr/internal/pdf/pdf_file.hpp>
+
+#include <test_util.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+using namespace odr;
+using namespace odr::internal;
+using namespace odr::test;
+
+namespace {
+
+std::string translate_to_string(const PdfFile &pdf_file,
+                                const std::string &name,
+                                std::uint32_t thread_count) {
+  const std::string output_path =
+      (std::filesystem::temp_directory_path() / name).string();
+  std::filesystem::create_directories(output_path);
+
+  HtmlConfig config;
+  config.pdf_thread_count = thread_count;
+  internal::html::translate_pdf_file(pdf_file, output_path, config);
+
+  std::ifstream in(output_path + "/document.html");
+  std::ostringstream out;
+  out << in.rdbuf();
+  return out.str();
+}
+
+/// A PDF whose pages show their index, with a classic xref table.
+std::string create_pdf(std::uint32_t page_count) {
+  std::string data = "%PDF-1.4\n";
+  std::vector<std::size_t> offsets;
+  auto object = [&](const std::string &body) {
+    offsets.push_back(data.size());
+    data += std::to_string(offsets.size()) + " 0 obj\n" + body + "\nendobj\n";
+  };
+
+  // 1 catalog, 2 pages, 3 font, then page and contents for every page
+  std::string kids;
+  for (std::uint32_t i = 0; i < page_count; ++i) {
+    kids += std::to_string(4 + 2 * i) + " 0 R ";
+  }
+  object("<< /Type /Catalog /Pages 2 0 R >>");
+  object("<< /Type /Pages /Kids [" + kids +
+         "] /Count " + std::to_string(page_count) + " >>");
+  object("<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+  for (std::uint32_t i = 0; i < page_count; ++i) {
+    std::string content =
+        "BT /F1 12 Tf 72 700 Td (page" + std::to_string(i) + ") Tj ET";
+    object("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] "
+           "/Resources << /Font << /F1 3 0 R >> >> /Contents " +
+           std::to_string(5 + 2 * i) + " 0 R >>");
+    object("<< /Length " + std::to_string(content.size()) + " >>\nstream\n" +
+           content + "\nendstream");
+  }
+
+  std::size_t xref_offset = data.size();
+  data += "xref\n0 " + std::to_string(offsets.size() + 1) +
+          "\n0000000000 65535 f \n";
+  for (std::size_t offset : offsets) {
+    std::string number = std::to_string(offset);
+    data += std::string(10 - number.size(), '0') + number + " 00000 n \n";
+  }
+  data += "trailer\n<< /Size " + std::to_string(offsets.size() + 1) +
+          " /Root 1 0 R >>\nstartxref\n" + std::to_string(xref_offset) +
+          "\n%%EOF\n";
+  return data;
+}
+
+} // namespace
+
+TEST(HtmlPdfFile, parallel_batches_keep_page_order) {
+  // more pages than one batch of four threads
+  PdfFile pdf_file(std::make_shared<internal::pdf::PdfFile>(
+      std::make_shared<common::MemoryFile>(create_pdf(37))));
+
+  std::string sequential =
+      translate_to_string(pdf_file, "odr_pdf_batch_sequential_test", 1);
+  std::string parallel =
+      translate_to_string(pdf_file, "odr_pdf_batch_parallel_test", 4);
+
+  EXPECT_EQ(sequential, parallel);
+  std::size_t position = 0;
+  for (std::uint32_t i = 0; i < 37; ++i) {
+    std::size_t next = parallel.find(">page" + std::to_string(i) + "<");
+    ASSERT_NE(next, std::string::npos) << i;
+    EXPECT_LT(position, next);
+    position = next;
+  }
+}
+
+TEST(HtmlPdfFile, parallel_matches_sequential) {
+  DecodedFile file(
+      TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
+  PdfFile pdf_file = file.pdf_file();
+
+  std::string sequential =
+      translate_to_string(pdf_file, "odr_pdf_sequential_test", 1);
+  std::string parallel =
+      translate_to_string(pdf_file, "odr_pdf_parallel_test", 4);
+
+  EXPECT_FALSE(sequential.empty());
+  EXPECT_EQ(sequential, parallel);
+}
+
+TEST(HtmlPdfFile, page_fragments) {
+  DecodedFile file(
+      TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
+  PdfFile pdf_file = file.pdf_file();
+
+  HtmlConfig config;
+  HtmlResourceLocator resource_locator =
+      [](HtmlResourceType, const std::string &, const std::string &,
+         const File &, bool) -> HtmlResourceLocation { return std::nullopt; };
+
+  HtmlService service = internal::html::translate_pdf_file(pdf_file);
+  std::vector<HtmlFragment> fragments = service.fragments();
+  ASSERT_FALSE(fragments.empty());
+  EXPECT_EQ(fragments.front().name(), "page0");
+
+  std::ostringstream whole;
+  service.write_html_document(whole, config, resource_locator);
+  std::ostringstream first;
+  fragments.front().write_html_fragment(first, config, resource_locator);
+  EXPECT_NE(whole.str().find(first.str()), std::string::npos);
+}
+
+TEST(HtmlPdfFile, page_fragments_by_count) {
+  PdfFile pdf_file(std::make_shared<internal::pdf::PdfFile>(
+      std::make_shared<common::MemoryFile>(create_pdf(12))));
+
+  HtmlConfig config;
+  HtmlResourceLocator resource_locator =
+      [](HtmlResourceType, const std::string &, const std::string &,
+         const File &, bool) -> HtmlResourceLocation { return std::nullopt; };
+
+  // one fragment per page of the root `/Count`; the page is resolved when
+  // the fragment is written
+  HtmlService service = internal::html::translate_pdf_file(pdf_file);
+  std::vector<HtmlFragment> fragments = service.fragments();
+  ASSERT_EQ(fragments.size(), 12u);
+
+  std::ostringstream out;
+  fragments[7].write_html_fragment(out, config, resource_locator);
+  EXPECT_NE(out.str().find(">page7<"), std::string::npos);
+  EXPECT_EQ(out.str().find(">page6<"), std::string::npos);
+}
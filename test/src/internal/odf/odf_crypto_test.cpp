@@ -0,0 +1,304 @@
+#include <odr/internal/abstract/file.hpp>
+#include <odr/internal/common/file.hpp>
+#include <odr/internal/common/filesystem.hpp>
+#include <odr/internal/crypto/crypto_util.hpp>
+#include <odr/internal/odf/odf_crypto.hpp>
+#include <odr/internal/util/stream_util.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cryptopp/aes.h>
+#include <cryptopp/blowfish.h>
+#include <cryptopp/des.h>
+#include <cryptopp/modes.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+
+using namespace odr::internal;
+using namespace odr::internal::odf;
+
+namespace {
+
+const std::string password = "password";
+
+std::string plaintext(const std::size_t size) {
+  std::string result(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    result[i] = static_cast<char>('a' + i * 7 % 26);
+  }
+  return result;
+}
+
+/// Raw deflate stream of stored blocks so that the compressed size is known.
+std::string deflate_stored(const std::string &input) {
+  std::string result;
+  std::size_t offset = 0;
+  do {
+    const std::size_t size =
+        std::min<std::size_t>(input.size() - offset, 0xffff);
+    const bool last = offset + size == input.size();
+    result += static_cast<char>(last ? 1 : 0);
+    result += static_cast<char>(size & 0xff);
+    result += static_cast<char>(size >> 8);
+    result += static_cast<char>(~size & 0xff);
+    result += static_cast<char>(~size >> 8 & 0xff);
+    result.append(input, offset, size);
+    offset += size;
+  } while (offset < input.size());
+  return result;
+}
+
+template <typename Mode>
+std::string encrypt(const std::string &key, const std::string &iv,
+                    const std::string &input) {
+  typename Mode::Encryption encryption;
+  encryption.SetKeyWithIV(reinterpret_cast<const CryptoPP::byte *>(key.data()),
+                          key.size(),
+                          reinterpret_cast<const CryptoPP::byte *>(iv.data()),
+                          iv.size());
+  std::string result(input.size(), '\0');
+  encryption.ProcessData(reinterpret_cast<CryptoPP::byte *>(result.data()),
+                         reinterpret_cast<const CryptoPP::byte *>(input.data()),
+                         input.size());
+  return result;
+}
+
+struct EncryptedPart {
+  Manifest::Entry entry;
+  std::string ciphertext;
+};
+
+/// Encrypts `plain` like an office suite would; the block ciphers pad to a
+/// whole block, a full one if the deflate stream is already aligned.
+EncryptedPart
+encrypt_part(const std::string &plain,
+             const AlgorithmType algorithm = AlgorithmType::AES256_CBC,
+             const ChecksumType checksum_type = ChecksumType::SHA256_1K,
+             const std::string &salt = "salt") {
+  Manifest::Entry entry;
+  entry.size = plain.size();
+  entry.checksum_type = checksum_type;
+  entry.algorithm = algorithm;
+  entry.key_derivation = KeyDerivationType::PBKDF2;
+  entry.key_iteration_count = 16;
+  entry.key_salt = salt;
+  entry.start_key_generation = ChecksumType::SHA256;
+  entry.start_key_size = 32;
+  entry.key_size = algorithm == AlgorithmType::AES256_CBC       ? 32
+                   : algorithm == AlgorithmType::TRIPLE_DES_CBC ? 24
+                                                                : 16;
+  entry.initialisation_vector =
+      std::string(algorithm == AlgorithmType::AES256_CBC ? 16 : 8, 'i');
+
+  std::string compressed = deflate_stored(plain);
+  entry.checksum = hash(compressed, checksum_type);
+
+  const std::string key =
+      crypto::util::pbkdf2(entry.key_size, start_key(entry, password),
+                           entry.key_salt, entry.key_iteration_count);
+  const std::string &iv = entry.initialisation_vector;
+  if (algorithm != AlgorithmType::BLOWFISH_CFB) {
+    const std::size_t padding = iv.size() - compressed.size() % iv.size();
+    compressed.append(padding, static_cast<char>(padding));
+  }
+
+  switch (algorithm) {
+  case AlgorithmType::AES256_CBC:
+    return {entry,
+            encrypt<CryptoPP::CBC_Mode<CryptoPP::AES>>(key, iv, compressed)};
+  case AlgorithmType::TRIPLE_DES_CBC:
+    return {entry, encrypt<CryptoPP::CBC_Mode<CryptoPP::DES_EDE3>>(
+                       key, iv, compressed)};
+  default:
+    return {entry, encrypt<CryptoPP::CFB_Mode<CryptoPP::Blowfish>>(
+                       key, iv, compressed)};
+  }
+}
+
+/// Storage and manifest of a document with the given encrypted parts; the
+/// first one is the smallest.
+struct EncryptedDocument {
+  std::shared_ptr<abstract::ReadableFilesystem> storage;
+  Manifest manifest;
+
+  void add(const common::Path &path, const EncryptedPart &part) {
+    std::static_pointer_cast<common::VirtualFilesystem>(storage)->copy(
+        std::make_shared<common::MemoryFile>(part.ciphertext), path);
+    manifest.entries.emplace(path, part.entry);
+    if (manifest.entries.size() == 1) {
+      manifest.smallest_file_path = path;
+    }
+  }
+
+  EncryptedDocument() : storage{std::make_shared<common::VirtualFilesystem>()} {
+    manifest.encrypted = true;
+  }
+};
+
+std::string read(const abstract::File &file) {
+  return util::stream::read(*file.stream());
+}
+
+} // namespace
+
+TEST(OdfCrypto, DecryptedFilesystem_lru) {
+  DecryptedFilesystem filesystem(std::make_shared<common::VirtualFilesystem>(),
+                                 {}, "", 10);
+  filesystem.cache("a", std::make_shared<common::MemoryFile>("aaaa"));
+  filesystem.cache("b", std::make_shared<common::MemoryFile>("bbbb"));
+  // `a` becomes the most recently used
+  EXPECT_NE(nullptr, filesystem.cached("a"));
+  filesystem.cache("c", std::make_shared<common::MemoryFile>("cccc"));
+
+  EXPECT_NE(nullptr, filesystem.cached("a"));
+  EXPECT_EQ(nullptr, filesystem.cached("b"));
+  EXPECT_NE(nullptr, filesystem.cached("c"));
+
+  // too large for the cache as a whole
+  filesystem.cache("d", std::make_shared<common::MemoryFile>(plaintext(11)));
+  EXPECT_EQ(nullptr, filesystem.cached("d"));
+  EXPECT_NE(nullptr, filesystem.cached("a"));
+  EXPECT_NE(nullptr, filesystem.cached("c"));
+}
+
+TEST(OdfCrypto, DecryptedFilesystem_derived_key_cache) {
+  EncryptedDocument document;
+  document.add("a.xml", encrypt_part(plaintext(100)));
+  document.add("b.xml", encrypt_part(plaintext(200)));
+  document.add("c.xml", encrypt_part(plaintext(300), AlgorithmType::AES256_CBC,
+                                     ChecksumType::SHA256_1K, "other salt"));
+  const auto &entry = document.manifest.smallest_file_entry();
+
+  // nothing is cached, so every part is decrypted from the storage
+  DecryptedFilesystem filesystem(document.storage, document.manifest,
+                                 start_key(entry, password), 0);
+  EXPECT_EQ(0, filesystem.derived_key_count());
+  EXPECT_EQ(plaintext(100), read(*filesystem.open("a.xml")));
+  EXPECT_EQ(1, filesystem.derived_key_count());
+  EXPECT_EQ(plaintext(200), read(*filesystem.open("b.xml")));
+  EXPECT_EQ(plaintext(100), read(*filesystem.open("a.xml")));
+  EXPECT_EQ(1, filesystem.derived_key_count());
+  EXPECT_EQ(plaintext(300), read(*filesystem.open("c.xml")));
+  EXPECT_EQ(2, filesystem.derived_key_count());
+}
+
+TEST(OdfCrypto, decrypt_seeds_cache) {
+  EncryptedDocument document;
+  document.add("styles.xml", encrypt_part(plaintext(100)));
+  document.add("content.xml", encrypt_part(plaintext(5000)));
+
+  std::shared_ptr<abstract::ReadableFilesystem> storage = document.storage;
+  EXPECT_FALSE(decrypt(storage, document.manifest, "wrong"));
+  EXPECT_EQ(document.storage, storage);
+  ASSERT_TRUE(decrypt(storage, document.manifest, password));
+
+  auto filesystem = std::dynamic_pointer_cast<DecryptedFilesystem>(storage);
+  ASSERT_NE(nullptr, filesystem);
+  auto styles = filesystem->cached("styles.xml");
+  ASSERT_NE(nullptr, styles);
+  EXPECT_EQ(plaintext(100), read(*styles));
+  // the other parts are left until a part is opened
+  EXPECT_EQ(nullptr, filesystem->cached("content.xml"));
+
+  EXPECT_EQ(styles, filesystem->open("styles.xml"));
+  auto content = filesystem->cached("content.xml");
+  ASSERT_NE(nullptr, content);
+  EXPECT_EQ(plaintext(5000), read(*content));
+  EXPECT_EQ(content, filesystem->open("content.xml"));
+}
+
+TEST(OdfCrypto, DecryptedFilesystem_streams_uncached) {
+  EncryptedDocument document;
+  document.add("a.xml", encrypt_part(plaintext(60)));
+  document.add("b.xml", encrypt_part(plaintext(61)));
+  const auto &entry = document.manifest.smallest_file_entry();
+
+  // only one of the parts fits into the cache
+  DecryptedFilesystem filesystem(document.storage, document.manifest,
+                                 start_key(entry, password), 100);
+  auto b = filesystem.open("b.xml");
+  EXPECT_NE(nullptr, std::dynamic_pointer_cast<DecryptedFile>(b));
+  EXPECT_EQ(plaintext(61), read(*b));
+  auto a = filesystem.open("a.xml");
+  EXPECT_NE(nullptr, std::dynamic_pointer_cast<common::MemoryFile>(a));
+  EXPECT_EQ(plaintext(60), read(*a));
+
+  // streaming a part leaves the cache alone
+  EXPECT_EQ(nullptr, filesystem.cached("b.xml"));
+  EXPECT_EQ(a, filesystem.cached("a.xml"));
+}
+
+TEST(OdfCrypto, DecryptedFile_small_reads) {
+  constexpr std::size_t piece_size = DecryptedFile::piece_size;
+  // stored deflate adds 5 bytes per 64 KiB: the padding block of the block
+  // ciphers starts the next piece, the padding ends right on a piece, the
+  // part spans several deflate blocks
+  for (const std::size_t size :
+       {std::size_t{10}, piece_size - 5, 2 * piece_size - 8,
+        5 * piece_size + 1234}) {
+    for (const AlgorithmType algorithm :
+         {AlgorithmType::AES256_CBC, AlgorithmType::TRIPLE_DES_CBC,
+          AlgorithmType::BLOWFISH_CFB}) {
+      const EncryptedPart part = encrypt_part(plaintext(size), algorithm);
+      const Manifest::Entry &entry = part.entry;
+      const std::string key =
+          crypto::util::pbkdf2(entry.key_size, start_key(entry, password),
+                               entry.key_salt, entry.key_iteration_count);
+      const std::string expected = crypto::util::inflate(
+          decrypt(part.ciphertext, key, entry.initialisation_vector,
+                  entry.algorithm));
+
+      DecryptedFile file(std::make_shared<common::MemoryFile>(part.ciphertext),
+                         entry, key);
+      auto stream = file.stream();
+      std::string result;
+      std::array<char, 7> buffer;
+      while (stream->read(buffer.data(), buffer.size()) ||
+             stream->gcount() > 0) {
+        result.append(buffer.data(), stream->gcount());
+      }
+
+      EXPECT_EQ(expected, result) << size;
+      EXPECT_EQ(plaintext(size), result) << size;
+    }
+  }
+}
+
+TEST(OdfCrypto, find_password_partial_checksum) {
+  for (const ChecksumType checksum_type :
+       {ChecksumType::SHA1_1K, ChecksumType::SHA256_1K}) {
+    EncryptedPart part = encrypt_part(
+        plaintext(4000), AlgorithmType::AES256_CBC, checksum_type);
+    // only the first kilobyte is decrypted, so a part which is cut off
+    // behind it goes unnoticed
+    part.ciphertext.resize(2048);
+    EncryptedDocument document;
+    document.add("content.xml", part);
+
+    EXPECT_EQ(1, find_password(*document.storage, document.manifest,
+                               {"wrong", password, "other", password}));
+    EXPECT_EQ(std::nullopt, find_password(*document.storage,
+                                          document.manifest, {"", "wrong"}));
+  }
+}
+
+TEST(OdfCrypto, find_password_whole_part) {
+  // parts too small to keep the padding clear of the first kilobyte are
+  // checked as a whole, like all parts with the other checksum types
+  for (const ChecksumType checksum_type :
+       {ChecksumType::SHA1, ChecksumType::SHA256, ChecksumType::SHA1_1K,
+        ChecksumType::SHA256_1K}) {
+    EncryptedDocument document;
+    document.add("content.xml", encrypt_part(plaintext(100),
+                                             AlgorithmType::AES256_CBC,
+                                             checksum_type));
+
+    EXPECT_EQ(2, find_password(*document.storage, document.manifest,
+                               {"", "wrong", password}));
+    EXPECT_EQ(std::nullopt, find_password(*document.storage,
+                                          document.manifest, {"", "wrong"}));
+  }
+}
@@ -1,3 +1,4 @@
+#include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/ooxml/ooxml_crypto.hpp>
 
 #include <gtest/gtest.h>
@@ -47,3 +48,115 @@ TEST(OoxmlCrypto, ECMA376Standard_verify) {
                                  encrypted_verifier_hash);
   EXPECT_TRUE(crypto.verify(key));
 }
+
+namespace {
+crypto::AgileKeyData agile_fixture_key_data() {
+  using namespace std::string_literals;
+
+  crypto::AgileKeyData key_data;
+  key_data.salt_size = 16;
+  key_data.block_size = 16;
+  key_data.key_bits = 128;
+  key_data.hash_size = 64;
+  key_data.cipher_algorithm = "AES";
+  key_data.cipher_chaining = "ChainingModeCBC";
+  key_data.hash_algorithm = "SHA512";
+  key_data.salt_value =
+      "\xaf\xc4\x19\xf6\x43\xd3\x97\x67\x5c\xb9\x8e\x17\x48\x59\x6e\x2a"s;
+  return key_data;
+}
+
+crypto::AgileEncryptedKey agile_fixture_encrypted_key() {
+  using namespace std::string_literals;
+
+  crypto::AgileEncryptedKey encrypted_key;
+  static_cast<crypto::AgileKeyData &>(encrypted_key) =
+      agile_fixture_key_data();
+  encrypted_key.salt_value =
+      "\xda\x88\xa7\xe6\x44\xb0\x7f\x87\xac\x00\x4b\x37\xfa\x06\x13\xbc"s;
+  encrypted_key.spin_count = 1000;
+  encrypted_key.encrypted_verifier_hash_input =
+      "\x26\xf4\xd4\x67\x39\x25\xbd\x3e\x00\x95\xf5\x29\x17\x83\x8f\x23"s;
+  encrypted_key.encrypted_verifier_hash_value =
+      "\x82\xe8\x5f\x10\xbc\x0b\xc6\xcd\xe3\x19\x35\xe2\x76\xe0\xab\xf7"
+      "\x6c\xc3\xfc\x59\x3c\x13\xb5\xbf\xf1\x6a\x17\x0a\x04\xb5\x0d\x2e"
+      "\x60\x7d\xb7\x21\xfd\x81\x70\xf8\x04\x3f\x91\x5b\x58\x33\x2a\x39"
+      "\x2f\x2a\x83\x33\xa5\x3b\x7c\x79\x06\x0b\xda\x3d\x05\xa7\xe8\x76"s;
+  encrypted_key.encrypted_key_value =
+      "\x84\x46\xd2\x7b\xef\x9c\xb6\x18\x6a\xda\x41\x55\xc8\xa8\x33\xfc"s;
+  return encrypted_key;
+}
+
+crypto::ECMA376Agile agile_fixture() {
+  return {agile_fixture_key_data(), agile_fixture_encrypted_key()};
+}
+} // namespace
+
+TEST(OoxmlCrypto, ECMA376Agile_verify) {
+  const crypto::ECMA376Agile crypto = agile_fixture();
+
+  EXPECT_TRUE(crypto.verify(crypto.derive_key("Password1234_")));
+  EXPECT_FALSE(crypto.verify(crypto.derive_key("password1234_")));
+}
+
+TEST(OoxmlCrypto, ECMA376Agile_decrypt) {
+  using namespace std::string_literals;
+
+  const crypto::ECMA376Agile crypto = agile_fixture();
+  const std::string encrypted_package =
+      "\x17\x00\x00\x00\x00\x00\x00\x00\x43\x11\xc5\xf9\x56\xf4\x41\x65"
+      "\x31\x6a\x0f\xdd\xf2\x4c\xb6\xd2\x4f\xfb\xfd\x69\x4f\x26\x31\xef"
+      "\x38\x57\xab\xb0\xa7\xbe\xad\xa2"s;
+
+  EXPECT_EQ(crypto.decrypt(encrypted_package,
+                           crypto.derive_key("Password1234_")),
+            "Hello agile encryption!");
+}
+
+TEST(OoxmlCrypto, Util_agile_encryption_info) {
+  using namespace std::string_literals;
+  using odr::internal::crypto::util::base64_encode;
+
+  const crypto::ECMA376Agile fixture = agile_fixture();
+  const crypto::AgileKeyData key_data = agile_fixture_key_data();
+  const crypto::AgileEncryptedKey encrypted_key =
+      agile_fixture_encrypted_key();
+  auto key_data_attributes = [](const crypto::AgileKeyData &data) {
+    return "saltSize=\"16\" blockSize=\"16\" keyBits=\"128\" "
+           "hashSize=\"64\" cipherAlgorithm=\"AES\" "
+           "cipherChaining=\"ChainingModeCBC\" hashAlgorithm=\"SHA512\" "
+           "saltValue=\"" +
+           base64_encode(data.salt_value) + "\"";
+  };
+
+  // a certificate encryptor comes first and the password one uses its own
+  // prefix with another element before `encryptedKey`
+  const std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\r\n"
+      "<encryption "
+      "xmlns=\"http://schemas.microsoft.com/office/2006/encryption\">"
+      "<keyData " +
+      key_data_attributes(key_data) +
+      "/>"
+      "<keyEncryptors>"
+      "<keyEncryptor uri=\"http://schemas.microsoft.com/office/2006/"
+      "keyEncryption/certificate\"><c:encryptedKey/></keyEncryptor>"
+      "<keyEncryptor uri=\"http://schemas.microsoft.com/office/2006/"
+      "keyEncryption/password\"><x:extension/><x:encryptedKey "
+      "spinCount=\"1000\" " +
+      key_data_attributes(encrypted_key) +
+      " encryptedVerifierHashInput=\"" +
+      base64_encode(encrypted_key.encrypted_verifier_hash_input) +
+      "\" encryptedVerifierHashValue=\"" +
+      base64_encode(encrypted_key.encrypted_verifier_hash_value) +
+      "\" encryptedKeyValue=\"" +
+      base64_encode(encrypted_key.encrypted_key_value) +
+      "\"/></keyEncryptor></keyEncryptors></encryption>";
+  const std::string encryption_info = "\x04\x00\x04\x00\x40\x00\x00\x00"s + xml;
+
+  const crypto::Util util(encryption_info);
+  const std::string key = util.derive_key("Password1234_");
+  EXPECT_EQ(key, fixture.derive_key("Password1234_"));
+  EXPECT_TRUE(util.verify(key));
+  EXPECT_FALSE(util.verify(util.derive_key("password1234_")));
+}
@@ -0,0 +1,46 @@
+#include <odr/internal/pdf/pdf_cmap.hpp>
+#include <odr/internal/pdf/pdf_cmap_parser.hpp>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal::pdf;
+
+TEST(CMap, one_byte) {
+  std::string data = "1 begincodespacerange\n"
+                     "<00> <FF>\n"
+                     "endcodespacerange\n"
+                     "1 beginbfchar\n"
+                     "<01> <0041>\n"
+                     "endbfchar\n"
+                     "1 beginbfrange\n"
+                     "<10> <12> <0061>\n"
+                     "endbfrange\n";
+  CMap cmap = CMapParser(data).parse_cmap();
+
+  EXPECT_EQ(cmap.translate_string(std::string("\x01\x10\x11\x12", 4)), "Aabc");
+  // unmapped single bytes pass through
+  EXPECT_EQ(cmap.translate_string("z"), "z");
+}
+
+TEST(CMap, two_byte) {
+  std::string data = "1 begincodespacerange\n"
+                     "<0000> <FFFF>\n"
+                     "endcodespacerange\n"
+                     "2 beginbfchar\n"
+                     "<0003> <0020>\n"
+                     "<0100> <D83DDE00>\n"
+                     "endbfchar\n"
+                     "2 beginbfrange\n"
+                     "<0024> <0026> <00E4>\n"
+                     "<0030> <0031> [<0066006C> <0078>]\n"
+                     "endbfrange\n";
+  CMap cmap = CMapParser(data).parse_cmap();
+
+  EXPECT_EQ(cmap.translate_string(std::string("\x00\x03\x00\x25", 4)),
+            " \xc3\xa5");
+  EXPECT_EQ(cmap.translate_string(std::string("\x01\x00", 2)),
+            "\xf0\x9f\x98\x80");
+  EXPECT_EQ(cmap.translate_string(std::string("\x00\x30\x00\x31", 4)), "flx");
+}
@@ -1,16 +1,19 @@
 #include <odr/internal/common/file.hpp>
-#include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/pdf/pdf_document.hpp>
 #include <odr/internal/pdf/pdf_document_element.hpp>
 #include <odr/internal/pdf/pdf_document_parser.hpp>
 #include <odr/internal/pdf/pdf_graphics_operator.hpp>
 #include <odr/internal/pdf/pdf_graphics_operator_parser.hpp>
 #include <odr/internal/pdf/pdf_graphics_state.hpp>
+#include <odr/internal/util/stream_util.hpp>
 
 #include <test_util.hpp>
 
-#include <functional>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -18,32 +21,116 @@ using namespace odr::internal;
 using namespace odr::internal::pdf;
 using namespace odr::test;
 
+namespace {
+
+/// Assembles a PDF by hand and remembers where each object starts.
+struct PdfBuilder {
+  std::string data{"%PDF-1.5\n"};
+  std::map<std::uint32_t, std::uint32_t> offsets;
+
+  std::uint32_t object(std::uint32_t id, const std::string &body) {
+    std::uint32_t offset = data.size();
+    offsets[id] = offset;
+    data += std::to_string(id) + " 0 obj\n" + body + "\nendobj\n";
+    return offset;
+  }
+
+  std::string finish(std::uint32_t start_xref) const {
+    return data + "startxref\n" + std::to_string(start_xref) + "\n%%EOF\n";
+  }
+
+  /// Finishes with a classic xref table; object ids have to be contiguous.
+  std::string finish_with_table() const;
+};
+
+std::string stream(const std::string &entries, const std::string &data) {
+  return "<< " + entries + " /Length " + std::to_string(data.size()) +
+         " >>\nstream\n" + data + "\nendstream";
+}
+
+/// One binary xref stream entry with the given field widths.
+std::string xref_entry(std::vector<std::uint32_t> widths,
+                       std::vector<std::uint64_t> fields) {
+  std::string result;
+  for (std::size_t i = 0; i < widths.size(); ++i) {
+    for (std::uint32_t byte = widths[i]; byte > 0; --byte) {
+      result += static_cast<char>((fields[i] >> (8 * (byte - 1))) & 0xff);
+    }
+  }
+  return result;
+}
+
+std::string xref_table_entry(std::uint32_t offset) {
+  std::string number = std::to_string(offset);
+  return std::string(10 - number.size(), '0') + number + " 00000 n \n";
+}
+
+std::string PdfBuilder::finish_with_table() const {
+  std::uint32_t xref_offset = data.size();
+  std::string table = "xref\n1 " + std::to_string(offsets.size()) + "\n";
+  for (const auto &[id, offset] : offsets) {
+    table += xref_table_entry(offset);
+  }
+  table += "trailer\n<< /Size " + std::to_string(offsets.size() + 1) +
+           " /Root 1 0 R >>\n";
+  return data + table + "startxref\n" + std::to_string(xref_offset) +
+         "\n%%EOF\n";
+}
+
+std::string page_object(std::uint32_t parent) {
+  return "<< /Type /Page /Parent " + std::to_string(parent) +
+         " 0 R /Resources << >> /Contents 1 0 R >>";
+}
+
+// catalog 1, pages 2 and page 4 inside object stream 5, contents 6;
+// object 3 is deliberately missing
+void append_objects(PdfBuilder &pdf) {
+  pdf.object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+  std::string pages = "<< /Type /Pages /Kids [4 0 R] /Count 1 >>";
+  std::string page =
+      "<< /Type /Page /Parent 2 0 R /Resources << >> /Contents 6 0 R >>";
+  std::string header = "2 0 4 " + std::to_string(pages.size() + 1) + " ";
+  pdf.object(5, stream("/Type /ObjStm /N 2 /First " +
+                           std::to_string(header.size()),
+                       header + pages + " " + page));
+  pdf.object(6, stream("", "BT ET"));
+}
+
+} // namespace
+
+TEST(DocumentParser, random_page_access) {
+  auto file = std::make_shared<common::DiskFile>(
+      TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
+
+  std::string data = util::stream::read(*file->stream());
+  DocumentParser parser(data);
+
+  std::unique_ptr<Document> document = parser.parse_document();
+  std::uint32_t count = parser.page_count(*document);
+  ASSERT_GT(count, 0);
+
+  Page *last_page = parser.page(*document, count - 1);
+  EXPECT_NE(last_page, nullptr);
+  // loading the whole tree afterwards reuses the already parsed page
+  std::vector<Page *> pages = parser.pages(*document);
+  EXPECT_EQ(pages.size(), count);
+  EXPECT_EQ(pages.back(), last_page);
+  EXPECT_THROW(parser.page(*document, count), std::out_of_range);
+}
+
 TEST(DocumentParser, foo) {
   auto file = std::make_shared<common::DiskFile>(
       TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
 
-  auto in = file->stream();
-  DocumentParser parser(*in);
+  std::string data = util::stream::read(*file->stream());
+  DocumentParser parser(data);
 
   std::unique_ptr<Document> document = parser.parse_document();
 
   std::cout << "elements " << document->elements.size() << std::endl;
   std::cout << "pages count " << document->catalog->pages->count << std::endl;
 
-  std::vector<Page *> ordered_pages;
-  std::function<void(Pages * pages)> recurse_pages = [&](Pages *pages) {
-    for (Element *kid : pages->kids) {
-      if (auto p = dynamic_cast<Pages *>(kid); p != nullptr) {
-        recurse_pages(p);
-      } else if (auto page = dynamic_cast<Page *>(kid); page != nullptr) {
-        ordered_pages.push_back(page);
-      } else {
-        throw std::runtime_error("unhandled element");
-      }
-    }
-  };
-
-  recurse_pages(document->catalog->pages);
+  std::vector<Page *> ordered_pages = parser.pages(*document);
 
   for (Page *page : ordered_pages) {
     std::cout << "page content " << page->contents_reference.front().id
@@ -53,18 +140,17 @@ TEST(DocumentParser, foo) {
   }
 
   Page *first_page = ordered_pages.front();
-  std::string stream;
+  std::string first_page_content;
   for (const auto &content_reference : first_page->contents_reference) {
     pdf::IndirectObject page_contents_object =
         parser.read_object(content_reference);
-    stream += parser.read_object_stream(page_contents_object);
+    first_page_content +=
+        parser.read_decoded_object_stream(page_contents_object);
   }
-  std::string first_page_content = crypto::util::zlib_inflate(stream);
 
-  std::istringstream ss(first_page_content);
-  GraphicsOperatorParser parser2(ss);
+  GraphicsOperatorParser parser2(first_page_content);
   GraphicsState state;
-  while (!ss.eof()) {
+  while (!parser2.at_end()) {
     GraphicsOperator op = parser2.read_operator();
     state.execute(op);
 
@@ -74,7 +160,8 @@ TEST(DocumentParser, foo) {
     if (op.type == GraphicsOperatorType::show_text) {
       const std::string &glyphs = op.arguments[0].as_string();
       std::string unicode =
-          first_page->resources->font.at(font)->cmap.translate_string(glyphs);
+          parser.font(*document, *first_page->resources, font)
+              ->cmap->translate_string(glyphs);
       std::cout << "show text: font=" << font << ", size=" << size
                 << ", text=" << unicode << std::endl;
     } else if (op.type == GraphicsOperatorType::show_text_manual_spacing) {
@@ -84,8 +171,8 @@ TEST(DocumentParser, foo) {
         } else if (element.is_string()) {
           const std::string &glyphs = element.as_string();
           std::string unicode =
-              first_page->resources->font.at(font)->cmap.translate_string(
-                  glyphs);
+              parser.font(*document, *first_page->resources, font)
+                  ->cmap->translate_string(glyphs);
           std::cout << "show text manual spacing: font=" << font
                     << ", size=" << size << ", text=" << unicode << std::endl;
         }
@@ -98,3 +185,217 @@ TEST(DocumentParser, foo) {
     }
   }
 }
+
+TEST(DocumentParser, xref_stream) {
+  PdfBuilder pdf;
+  append_objects(pdf);
+
+  // subsections 0-2 and 4-7 with a 1 byte type, 2 byte offset and 1 byte
+  // generation or index
+  const std::vector<std::uint32_t> w{1, 2, 1};
+  std::string entries = xref_entry(w, {0, 0, 255}) +
+                        xref_entry(w, {1, pdf.offsets[1], 0}) +
+                        xref_entry(w, {2, 5, 0}) + xref_entry(w, {2, 5, 1}) +
+                        xref_entry(w, {1, pdf.offsets[5], 0}) +
+                        xref_entry(w, {1, pdf.offsets[6], 0});
+  std::uint32_t xref_offset = pdf.data.size();
+  entries += xref_entry(w, {1, xref_offset, 0});
+  pdf.object(7, stream("/Type /XRef /Size 8 /W [1 2 1] /Index [0 3 4 4] "
+                       "/Root 1 0 R",
+                       entries));
+  std::string data = pdf.finish(xref_offset);
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  const Xref &xref = parser.xref();
+  EXPECT_EQ(xref.table.count(ObjectReference(3, 0)), 0);
+  const Xref::Entry &page_entry = xref.table.at(ObjectReference(4, 0));
+  EXPECT_EQ(page_entry.object_stream_id, 5u);
+  EXPECT_EQ(page_entry.object_stream_index, 1u);
+  EXPECT_EQ(xref.table.at(ObjectReference(6, 0)).position, pdf.offsets[6]);
+
+  ASSERT_EQ(parser.page_count(*document), 1u);
+  Page *page = parser.page(*document, 0);
+  ASSERT_EQ(page->contents_reference.size(), 1u);
+  EXPECT_EQ(page->contents_reference.front(), ObjectReference(6, 0));
+  EXPECT_EQ(parser.read_object_stream(page->contents_reference.front()),
+            "BT ET");
+}
+
+TEST(DocumentParser, xref_stream_widths) {
+  PdfBuilder pdf;
+  append_objects(pdf);
+
+  // a zero width type field defaults to uncompressed objects, so the
+  // compressed ones are listed with an explicit type in a second stream
+  const std::vector<std::uint32_t> wide{0, 4, 0};
+  std::string entries = xref_entry(wide, {0, pdf.offsets[1], 0}) +
+                        xref_entry(wide, {0, pdf.offsets[5], 0}) +
+                        xref_entry(wide, {0, pdf.offsets[6], 0});
+  std::uint32_t compressed_offset =
+      pdf.object(8, stream("/Type /XRef /Size 9 /W [1 3 2] /Index [2 1 4 1]",
+                           xref_entry({1, 3, 2}, {2, 5, 0}) +
+                               xref_entry({1, 3, 2}, {2, 5, 1})));
+  std::uint32_t xref_offset = pdf.data.size();
+  pdf.object(7, stream("/Type /XRef /Size 9 /W [0 4 0] /Index [1 1 5 2] "
+                       "/Root 1 0 R /Prev " +
+                           std::to_string(compressed_offset),
+                       entries));
+  std::string data = pdf.finish(xref_offset);
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  EXPECT_EQ(parser.xref().table.at(ObjectReference(5, 0)).position,
+            pdf.offsets[5]);
+  Page *page = parser.page(*document, 0);
+  EXPECT_EQ(page->contents_reference.front(), ObjectReference(6, 0));
+}
+
+TEST(DocumentParser, hybrid_xref) {
+  PdfBuilder pdf;
+  append_objects(pdf);
+
+  std::uint32_t xref_stream_offset =
+      pdf.object(7, stream("/Type /XRef /Size 8 /W [1 1 1] /Index [2 1 4 1]",
+                           xref_entry({1, 1, 1}, {2, 5, 0}) +
+                               xref_entry({1, 1, 1}, {2, 5, 1})));
+  std::uint32_t xref_offset = pdf.data.size();
+  pdf.data += "xref\n1 1\n" + xref_table_entry(pdf.offsets[1]) + "5 2\n" +
+              xref_table_entry(pdf.offsets[5]) +
+              xref_table_entry(pdf.offsets[6]) +
+              "trailer\n<< /Size 8 /Root 1 0 R /XRefStm " +
+              std::to_string(xref_stream_offset) + " >>\n";
+  std::string data = pdf.finish(xref_offset);
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  EXPECT_TRUE(parser.xref().table.at(ObjectReference(2, 0)).object_stream_id);
+  Page *page = parser.page(*document, 0);
+  EXPECT_EQ(page->contents_reference.front(), ObjectReference(6, 0));
+}
+
+TEST(DocumentParser, cyclic_xref_sections) {
+  PdfBuilder pdf;
+  append_objects(pdf);
+
+  std::uint32_t xref_stream_offset =
+      pdf.object(7, stream("/Type /XRef /Size 8 /W [1 1 1] /Index [2 1 4 1]",
+                           xref_entry({1, 1, 1}, {2, 5, 0}) +
+                               xref_entry({1, 1, 1}, {2, 5, 1})));
+  // both sections point back at themselves and at each other
+  std::uint32_t xref_offset = pdf.data.size();
+  pdf.data += "xref\n1 1\n" + xref_table_entry(pdf.offsets[1]) + "5 2\n" +
+              xref_table_entry(pdf.offsets[5]) +
+              xref_table_entry(pdf.offsets[6]) +
+              "trailer\n<< /Size 8 /Root 1 0 R /XRefStm " +
+              std::to_string(xref_stream_offset) + " /Prev " +
+              std::to_string(xref_offset) + " >>\n";
+  std::uint32_t second_offset = pdf.data.size();
+  pdf.data += "xref\n6 1\n" + xref_table_entry(pdf.offsets[6]) +
+              "trailer\n<< /Size 8 /Root 1 0 R /XRefStm " +
+              std::to_string(second_offset) + " /Prev " +
+              std::to_string(xref_offset) + " >>\n";
+  std::string data = pdf.finish(second_offset);
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  Page *page = parser.page(*document, 0);
+  EXPECT_EQ(page->contents_reference.front(), ObjectReference(6, 0));
+}
+
+TEST(DocumentParser, page_tree) {
+  PdfBuilder pdf;
+  pdf.object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+  pdf.object(2, "<< /Type /Pages /Kids [3 0 R 4 0 R 5 0 R] /Count 4 >>");
+  pdf.object(3, page_object(2));
+  pdf.object(4, "<< /Type /Pages /Parent 2 0 R /Kids [6 0 R 7 0 R] "
+                "/Count 2 >>");
+  pdf.object(5, page_object(2));
+  pdf.object(6, page_object(4));
+  pdf.object(7, page_object(4));
+  std::string data = pdf.finish_with_table();
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  ASSERT_EQ(parser.page_count(*document), 4u);
+  EXPECT_EQ(parser.page(*document, 3)->object_reference, ObjectReference(5, 0));
+  EXPECT_EQ(parser.page(*document, 2)->object_reference, ObjectReference(7, 0));
+  EXPECT_EQ(parser.page(*document, 0)->object_reference, ObjectReference(3, 0));
+
+  // the counts found on the way are kept on the node
+  const Pages &root = *document->catalog->pages;
+  EXPECT_EQ(root.kid_counts[0], 1u);
+  EXPECT_EQ(root.kid_counts[1], 2u);
+
+  std::vector<Page *> pages = parser.pages(*document);
+  ASSERT_EQ(pages.size(), 4u);
+  EXPECT_EQ(pages[1]->object_reference, ObjectReference(6, 0));
+}
+
+TEST(DocumentParser, flat_page_tree) {
+  PdfBuilder pdf;
+  pdf.object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+  pdf.object(2, "<< /Type /Pages /Kids [3 0 R 4 0 R 5 0 R] /Count 3 >>");
+  pdf.object(3, page_object(2));
+  pdf.object(4, page_object(2));
+  pdf.object(5, page_object(2));
+  std::string data = pdf.finish_with_table();
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  EXPECT_EQ(parser.page(*document, 2)->object_reference, ObjectReference(5, 0));
+
+  // the page was indexed directly without looking at its siblings
+  const Pages &root = *document->catalog->pages;
+  EXPECT_EQ(root.kids[0], nullptr);
+  EXPECT_EQ(root.kids[1], nullptr);
+  EXPECT_FALSE(root.kid_counts[0]);
+}
+
+TEST(DocumentParser, mixed_page_tree) {
+  // as many kids as pages, but not every kid is a page
+  PdfBuilder pdf;
+  pdf.object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+  pdf.object(2, "<< /Type /Pages /Kids [3 0 R 4 0 R 5 0 R] /Count 3 >>");
+  pdf.object(3, "<< /Type /Pages /Parent 2 0 R /Kids [6 0 R 7 0 R] "
+                "/Count 2 >>");
+  pdf.object(4, page_object(2));
+  pdf.object(5, "<< /Type /Pages /Parent 2 0 R /Kids [] /Count 0 >>");
+  pdf.object(6, page_object(3));
+  pdf.object(7, page_object(3));
+  std::string data = pdf.finish_with_table();
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  const std::vector<ObjectReference> expected{
+      ObjectReference(6, 0), ObjectReference(7, 0), ObjectReference(4, 0)};
+  for (std::uint32_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(parser.page(*document, i)->object_reference, expected[i]);
+  }
+  std::vector<Page *> pages = parser.pages(*document);
+  ASSERT_EQ(pages.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(pages[i]->object_reference, expected[i]);
+  }
+}
+
+TEST(DocumentParser, cyclic_page_tree) {
+  PdfBuilder pdf;
+  pdf.object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+  pdf.object(2, "<< /Type /Pages /Kids [3 0 R] /Count 2 >>");
+  pdf.object(3, "<< /Type /Pages /Parent 2 0 R /Kids [3 0 R] /Count 2 >>");
+  std::string data = pdf.finish_with_table();
+
+  DocumentParser parser(data);
+  std::unique_ptr<Document> document = parser.parse_document();
+
+  EXPECT_THROW(parser.page(*document, 0), std::runtime_error);
+  EXPECT_TRUE(parser.pages(*document).empty());
+}
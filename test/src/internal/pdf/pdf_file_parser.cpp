@@ -2,6 +2,7 @@
 #include <odr/internal/crypto/crypto_util.hpp>
 #include <odr/internal/pdf/pdf_file_object.hpp>
 #include <odr/internal/pdf/pdf_file_parser.hpp>
+#include <odr/internal/util/stream_util.hpp>
 
 #include <test_util.hpp>
 
@@ -17,8 +18,8 @@ TEST(FileParser, foo) {
   auto file = std::make_shared<common::DiskFile>(
       TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
 
-  auto in = file->stream();
-  FileParser parser(*in);
+  std::string data = util::stream::read(*file->stream());
+  FileParser parser(data);
 
   parser.read_header();
   while (true) {
@@ -57,7 +58,7 @@ TEST(FileParser, foo) {
 
       if (object.has_stream) {
         const Dictionary &dictionary = object.object.as_dictionary();
-        std::string stream = parser.read_stream(-1);
+        std::string_view stream = parser.read_stream(-1);
         std::cout << stream.size() << std::endl;
 
         if (dictionary.has_key("Filter")) {
@@ -79,13 +80,13 @@ TEST(FileParser, bar) {
   auto file = std::make_shared<common::DiskFile>(
       TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
 
-  auto in = file->stream();
-  FileParser parser(*in);
+  std::string data = util::stream::read(*file->stream());
+  FileParser parser(data);
 
   parser.read_header();
   parser.seek_start_xref();
   StartXref startxref = parser.read_start_xref();
-  parser.in().seekg(startxref.start);
+  parser.parser().seek(startxref.start);
 
   Dictionary trailer;
   Xref xref;
@@ -117,7 +118,7 @@ TEST(FileParser, bar) {
 
   ObjectReference root_ref = trailer["Root"].as_reference();
   std::uint32_t root_pos = xref.table.at(root_ref).position;
-  parser.in().seekg(root_pos);
+  parser.parser().seek(root_pos);
   IndirectObject root = parser.read_indirect_object();
   std::cout << "root" << std::endl;
   ObjectReference root_pages_ref =
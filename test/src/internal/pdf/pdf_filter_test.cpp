@@ -0,0 +1,76 @@
+#include <odr/internal/pdf/pdf_filter.hpp>
+#include <odr/internal/pdf/pdf_object.hpp>
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal::pdf;
+
+namespace {
+
+std::string decode(std::string_view data, const Object &filter,
+                   const Object &decode_parms = {}) {
+  std::string result;
+  read_all(*open_filters(std::make_unique<MemorySource>(data), filter,
+                         decode_parms),
+           result);
+  return result;
+}
+
+Object filters(std::initializer_list<std::string_view> names) {
+  Array array;
+  for (std::string_view name : names) {
+    array.holder().emplace_back(Name(name));
+  }
+  return Object(std::move(array));
+}
+
+} // namespace
+
+TEST(PdfFilter, ascii_hex) {
+  EXPECT_EQ(decode("48 65 6c6C 6f7>", Object(Name("ASCIIHexDecode"))),
+            std::string("Hello\x70", 6));
+}
+
+TEST(PdfFilter, ascii85) {
+  EXPECT_EQ(
+      decode("9jqo^BlbD-BleB1DJ+*+F(f,q~>", Object(Name("ASCII85Decode"))),
+      "Man is distinguished");
+  EXPECT_EQ(decode("z~>", Object(Name("ASCII85Decode"))),
+            std::string(4, '\0'));
+}
+
+TEST(PdfFilter, lzw) {
+  // example from the PDF specification
+  EXPECT_EQ(decode("\x80\x0b\x60\x50\x22\x0c\x0c\x85\x01",
+                   Object(Name("LZWDecode"))),
+            "-----A---B");
+}
+
+TEST(PdfFilter, run_length) {
+  EXPECT_EQ(decode(std::string("\x02" "abc" "\xfe" "x" "\x80", 7),
+                   Object(Name("RunLengthDecode"))),
+            "abcxxx");
+}
+
+TEST(PdfFilter, chain) {
+  EXPECT_EQ(decode("789ccb48cdc9c957c84090003a2e067d>",
+                   filters({"ASCIIHexDecode", "FlateDecode"})),
+            "hello hello hello");
+}
+
+TEST(PdfFilter, png_predictor) {
+  Dictionary parms;
+  parms["Predictor"] = Object(Integer(12));
+  parms["Columns"] = Object(Integer(2));
+  Array parms_array;
+  parms_array.holder().emplace_back();
+  parms_array.holder().emplace_back(std::move(parms));
+
+  EXPECT_EQ(decode("789c63606462626206000020000b>",
+                   filters({"ASCIIHexDecode", "FlateDecode"}),
+                   Object(std::move(parms_array))),
+            std::string("\x01\x02\x03\x05", 4));
+}
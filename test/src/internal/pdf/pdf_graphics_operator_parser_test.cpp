@@ -0,0 +1,63 @@
+#include <odr/internal/pdf/pdf_graphics_operator.hpp>
+#include <odr/internal/pdf/pdf_graphics_operator_parser.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal::pdf;
+
+namespace {
+
+bool is_show_text(GraphicsOperatorType type) {
+  return type == GraphicsOperatorType::show_text;
+}
+
+} // namespace
+
+TEST(GraphicsOperatorParser, skip_unwanted_operands) {
+  const std::string content =
+      "q 1 0 0 RG 0 0 m 100 100 l [1 2] 0 d S Q\n"
+      "BT /F1 12 Tf (a \\) ]) Tj <4142> Tj ET\n"
+      "BI /W 2 /H 1 /BPC 8 ID \x01" "EI\xff EI\n"
+      "% comment (\n"
+      "(c) Tj\n";
+
+  GraphicsOperatorParser parser(content);
+  GraphicsOperator op;
+  std::vector<GraphicsOperatorType> types;
+  std::vector<std::string> texts;
+  while (!parser.at_end()) {
+    parser.read_operator(op, is_show_text);
+    types.push_back(op.type);
+    if (op.type == GraphicsOperatorType::show_text) {
+      ASSERT_EQ(op.arguments.size(), 1);
+      texts.push_back(op.arguments[0].as_string());
+    } else {
+      EXPECT_TRUE(op.arguments.empty());
+    }
+  }
+
+  EXPECT_EQ(texts, (std::vector<std::string>{"a ) ]", "AB", "c"}));
+  ASSERT_GE(types.size(), 2);
+  EXPECT_EQ(types.front(), GraphicsOperatorType::save_state);
+  EXPECT_EQ(types.back(), GraphicsOperatorType::show_text);
+}
+
+TEST(GraphicsOperatorParser, operands_cleared) {
+  // the second `Tj` has no operand and must not see the one of the first
+  GraphicsOperatorParser parser("(a) Tj Tj\n");
+  GraphicsOperator op;
+
+  parser.read_operator(op, is_show_text);
+  ASSERT_EQ(op.arguments.size(), 1);
+  EXPECT_EQ(op.arguments[0].as_string(), "a");
+
+  parser.read_operator(op, is_show_text);
+  EXPECT_EQ(op.type, GraphicsOperatorType::show_text);
+  EXPECT_TRUE(op.arguments.empty());
+  EXPECT_THROW(op.arguments.at(0), std::out_of_range);
+  EXPECT_DEBUG_DEATH(static_cast<void>(op.arguments[0]), "");
+}
@@ -0,0 +1,46 @@
+#include <odr/internal/pdf/pdf_object.hpp>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal::pdf;
+
+TEST(PdfObject, name_interned) {
+  Name a("Type");
+  Name b("Type");
+
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.id(), b.id());
+  EXPECT_FALSE(a == Name("Pages"));
+  ASSERT_TRUE(Name::find("Type").has_value());
+  EXPECT_EQ(*Name::find("Type"), a);
+}
+
+TEST(PdfObject, name_released) {
+  // names of a document which is gone leave the table
+  {
+    std::vector<Name> names;
+    for (int i = 0; i < 100000; ++i) {
+      names.emplace_back("name_released_" + std::to_string(i));
+    }
+    EXPECT_TRUE(Name::find("name_released_99999").has_value());
+  }
+  EXPECT_FALSE(Name::find("name_released_0").has_value());
+  EXPECT_FALSE(Name::find("name_released_99999").has_value());
+
+  // interned again as a new atom
+  Name a("name_released_0");
+  EXPECT_EQ(a, Name("name_released_0"));
+  EXPECT_EQ(a.string(), "name_released_0");
+}
+
+TEST(PdfObject, dictionary_find) {
+  Dictionary dictionary({{Name("Type"), Object(Name("Page"))},
+                         {Name("dictionary_find"), Object(Integer(1))}});
+  ASSERT_NE(dictionary.find("dictionary_find"), nullptr);
+  EXPECT_EQ(dictionary["dictionary_find"].as_integer(), 1);
+  EXPECT_EQ(dictionary["Type"].as_name(), "Page");
+  EXPECT_EQ(dictionary.find("dictionary_find_missing"), nullptr);
+}
@@ -0,0 +1,94 @@
+#include <odr/internal/common/file.hpp>
+#include <odr/internal/pdf/pdf_text.hpp>
+#include <odr/internal/util/stream_util.hpp>
+
+#include <test_util.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal;
+using namespace odr::test;
+
+namespace {
+
+/// A PDF with one page per entry of `contents`, all using font `/F1`.
+std::string create_pdf(const std::vector<std::string> &contents) {
+  std::string data = "%PDF-1.4\n";
+  std::vector<std::size_t> offsets;
+  auto object = [&](const std::string &body) {
+    offsets.push_back(data.size());
+    data += std::to_string(offsets.size()) + " 0 obj\n" + body + "\nendobj\n";
+  };
+
+  // 1 catalog, 2 pages, 3 font, then page and contents for every page
+  std::string kids;
+  for (std::size_t i = 0; i < contents.size(); ++i) {
+    kids += std::to_string(4 + 2 * i) + " 0 R ";
+  }
+  object("<< /Type /Catalog /Pages 2 0 R >>");
+  object("<< /Type /Pages /Kids [" + kids +
+         "] /Count " + std::to_string(contents.size()) + " >>");
+  object("<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+  for (std::size_t i = 0; i < contents.size(); ++i) {
+    object("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] "
+           "/Resources << /Font << /F1 3 0 R >> >> /Contents " +
+           std::to_string(5 + 2 * i) + " 0 R >>");
+    object("<< /Length " + std::to_string(contents[i].size()) +
+           " >>\nstream\n" + contents[i] + "\nendstream");
+  }
+
+  std::size_t xref_offset = data.size();
+  data += "xref\n0 " + std::to_string(offsets.size() + 1) +
+          "\n0000000000 65535 f \n";
+  for (std::size_t offset : offsets) {
+    std::string number = std::to_string(offset);
+    data += std::string(10 - number.size(), '0') + number + " 00000 n \n";
+  }
+  data += "trailer\n<< /Size " + std::to_string(offsets.size() + 1) +
+          " /Root 1 0 R >>\nstartxref\n" + std::to_string(xref_offset) +
+          "\n%%EOF\n";
+  return data;
+}
+
+} // namespace
+
+TEST(PdfText, lines_and_pages) {
+  std::string data = create_pdf({
+      // small `TJ` adjustments are kerning, large ones are word gaps
+      "BT /F1 12 Tf 72 700 Td (Hello ) Tj [(wor) -50 (ld) -300 (again)] TJ "
+      "0 -14 Td (Second line) Tj ET",
+      "0 0 1 rg 10 10 100 100 re f "
+      "BT /F1 12 Tf 14 TL 1 0 0 1 72 700 Tm (Page) Tj ( two) Tj T* (next) Tj "
+      "ET",
+      "",
+  });
+
+  std::ostringstream out;
+  pdf::extract_text(data, out);
+
+  EXPECT_EQ(out.str(), "Hello world again\nSecond line\n\f"
+                       "Page two\nnext\n\f"
+                       "\f");
+}
+
+TEST(PdfText, test_file) {
+  auto file = std::make_shared<common::DiskFile>(
+      TestData::test_file_path("odr-public/pdf/style-various-1.pdf"));
+  std::string data = util::stream::read(*file->stream());
+
+  std::ostringstream out;
+  pdf::extract_text(data, out);
+  const std::string text = out.str();
+
+  ASSERT_FALSE(text.empty());
+  EXPECT_EQ(text.back(), '\f');
+  // every page ends with a form feed and every line with a new line
+  EXPECT_GE(std::count(text.begin(), text.end(), '\f'), 1);
+  EXPECT_EQ(text.find("\n\n"), std::string::npos);
+  EXPECT_EQ(text.find(" \n"), std::string::npos);
+}
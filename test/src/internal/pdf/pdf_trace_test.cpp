@@ -0,0 +1,34 @@
+#include <odr/internal/pdf/pdf_graphics_operator.hpp>
+#include <odr/internal/pdf/pdf_trace.hpp>
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace odr::internal::pdf;
+
+TEST(PdfTrace, serialized) {
+  // the sink itself is not thread-safe
+  std::vector<std::string> messages;
+  set_trace_sink([&](GraphicsOperatorType, std::string_view message) {
+    messages.emplace_back(message);
+  });
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([] {
+      for (int j = 0; j < 1000; ++j) {
+        trace(GraphicsOperatorType::unknown, "skipped");
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  set_trace_sink(nullptr);
+
+  EXPECT_EQ(messages.size(), 4000);
+}
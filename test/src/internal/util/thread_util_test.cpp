@@ -0,0 +1,46 @@
+#include <odr/internal/util/thread_util.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace odr::internal::util::thread;
+
+TEST(thread_util, parallel_for) {
+  std::vector<std::atomic<int>> calls(1000);
+  parallel_for(calls.size(), 4, [&](std::size_t i) { ++calls[i]; });
+  for (const auto &count : calls) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST(thread_util, parallel_for_rethrows) {
+  EXPECT_THROW(parallel_for(100, 4,
+                            [](std::size_t i) {
+                              if (i == 50) {
+                                throw std::runtime_error("task");
+                              }
+                            }),
+               std::runtime_error);
+}
+
+TEST(thread_util, find_first) {
+  auto even_above_10 = [](std::size_t i) { return i > 10 && i % 2 == 0; };
+  EXPECT_EQ(12, find_first(100, 4, even_above_10));
+  EXPECT_EQ(std::nullopt, find_first(11, 4, even_above_10));
+  EXPECT_EQ(std::nullopt, find_first(0, 4, even_above_10));
+}
+
+TEST(thread_util, parallel_for_nested) {
+  // every helper of the outer loop waits on an inner one, which must not
+  // starve while the pool is busy
+  std::vector<std::atomic<int>> calls(64 * 64);
+  parallel_for(64, 64, [&](std::size_t i) {
+    parallel_for(64, 64, [&](std::size_t j) { ++calls[i * 64 + j]; });
+  });
+  for (const auto &count : calls) {
+    EXPECT_EQ(1, count);
+  }
+}